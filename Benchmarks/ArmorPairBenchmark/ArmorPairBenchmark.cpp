@@ -0,0 +1,275 @@
+#include <Services/ArmorMatchingService.hpp>
+#include <Modules/MathUtility.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace RoboPioneers::Benchmarks
+{
+	using Clock = std::chrono::steady_clock;
+	using Prometheus::ArmorMatchingService;
+	using Modules::GeometryFeatureModule;
+	using Modules::LightBarTable;
+	using Modules::MathUtility;
+	using Shape = GeometryFeatureModule::GeometryFeature::Shape;
+
+	/// 轮廓采样点数
+	constexpr int ContourPoints = 24;
+
+	/**
+	 * @brief 交点距离判定的边界容差，相对于距离上限
+	 * @details
+	 *  ~ 批量核验以单精度计算交点与距离，参照以双精度计算，距离与上限之差在此范围内时两者的结论都可以接受。
+	 */
+	constexpr double BoundaryTolerance = 1e-5;
+
+	/// 参照核验的结论
+	enum class Verdict
+	{
+		/// 拒绝
+		Reject,
+		/// 接受
+		Accept,
+		/// 距离恰好落在上限附近，批量核验接受或拒绝都不视为不一致
+		Boundary
+	};
+
+	/**
+	 * @brief 生成随机灯条表
+	 * @param random 随机数发生器
+	 * @param count 灯条数
+	 * @param near_vertical 是否使灯条接近竖直，使更多的元素对进入后面的核验阶段
+	 * @details
+	 *  ~ 以采样的旋转矩形或椭圆边界作为轮廓，由几何特征模块拟合得到几何特征，奇偶下标分别为矩形与椭圆匹配。
+	 */
+	LightBarTable GenerateTable(std::mt19937& random, int count, bool near_vertical)
+	{
+		std::uniform_real_distribution<float> position_x(0.0f, 400.0f), position_y(0.0f, 140.0f);
+		std::uniform_real_distribution<float> length(10.0f, 40.0f), width(2.0f, 8.0f);
+		std::uniform_real_distribution<float> any_angle(0.0f, 180.0f), jitter(-8.0f, 8.0f);
+
+		LightBarTable table;
+		for (int index = 0; index < count; ++index)
+		{
+			const bool is_rectangle = index % 2 == 1;
+			const float angle = index % 7 == 0 ? 0.0f : (near_vertical ? jitter(random) : any_angle(random));
+			const cv::RotatedRect shape(cv::Point2f(position_x(random), position_y(random)),
+						   cv::Size2f(width(random), length(random)), angle);
+
+			std::vector<cv::Point> contour;
+			cv::Point2f vertices[4];
+			shape.points(vertices);
+			const double radian = angle * CV_PI / 180.0;
+			for (int point = 0; point < ContourPoints; ++point)
+			{
+				cv::Point2f sample;
+				if (is_rectangle)
+				{
+					// 沿四条边等距采样
+					const int edge = point * 4 / ContourPoints;
+					const float ratio = static_cast<float>(point * 4 % ContourPoints) / ContourPoints;
+					sample = vertices[edge] + (vertices[(edge + 1) % 4] - vertices[edge]) * ratio;
+				}
+				else
+				{
+					const double theta = 2.0 * CV_PI * point / ContourPoints;
+					const double local_x = shape.size.width / 2.0 * std::cos(theta);
+					const double local_y = shape.size.height / 2.0 * std::sin(theta);
+					sample = shape.center + cv::Point2f(
+							static_cast<float>(local_x * std::cos(radian) - local_y * std::sin(radian)),
+							static_cast<float>(local_x * std::sin(radian) + local_y * std::cos(radian)));
+				}
+				contour.emplace_back(cvRound(sample.x), cvRound(sample.y));
+			}
+
+			table.Append(is_rectangle ? GeometryFeatureModule::GetRectangleGeometryFeature(contour) :
+				GeometryFeatureModule::GetEllipseGeometryFeature(contour));
+		}
+		return table;
+	}
+
+	/**
+	 * @brief 逐对的标量核验，作为参照
+	 * @details
+	 *  ~ 与批量核验之前的实现相同：高度比以单精度相除、角度比以双精度相除，均与双精度阈值比较，
+	 *    连线垂直程度使用反余弦，交点由MathUtility::LineCrossPoint求得。
+	 *  ~ 交点距离与上限之差不超过BoundaryTolerance时返回Verdict::Boundary；
+	 *    交点为非数值时（竖直的直线）距离比较不成立，与原实现一样剔除。
+	 */
+	Verdict ReferenceCheck(const ArmorMatchingService::SettingsType& service_settings, const LightBarTable& light_bars,
+					 std::size_t a, std::size_t b)
+	{
+		const float* angles = light_bars.Angles();
+		const float* lengths = light_bars.Lengths();
+		const float* stable_angles = light_bars.StableAngles();
+
+		const auto& settings = light_bars.Shapes()[a] == Shape::Rectangle ?
+				service_settings.RectangleSettings : service_settings.EllipseSettings;
+
+		// 内八和外八
+		if (MathUtility::ResembleCoefficient(angles[a], 90.0f) < settings.IgnorantDifferentDirectionRatio &&
+			MathUtility::ResembleCoefficient(angles[b], 90.0f) < settings.IgnorantDifferentDirectionRatio &&
+			(angles[a] - 90.0f) * (angles[b] - 90.0f) < 0)
+		{
+			return Verdict::Reject;
+		}
+
+		// 高度比与角度比
+		const double height_ratio = std::fmin(lengths[a], lengths[b]) / std::fmax(lengths[a], lengths[b]);
+		if (height_ratio < settings.MinHeightRatio) return Verdict::Reject;
+
+		const double a_stable_angle = stable_angles[a];
+		const double b_stable_angle = stable_angles[b];
+		const double angle_ratio = std::fmin(a_stable_angle, b_stable_angle) / std::fmax(a_stable_angle, b_stable_angle);
+		if (angle_ratio < settings.MinAngleRatio) return Verdict::Reject;
+
+		// 连线垂直于其中一边
+		constexpr double half_pi = 3.14159265 / 2;
+		const auto a_center = light_bars.GetCenter(a);
+		const auto b_center = light_bars.GetCenter(b);
+		const auto a_direction = light_bars.GetUnitDirection(a);
+		const auto b_direction = light_bars.GetUnitDirection(b);
+		const auto raw_link = a_center - b_center;
+		const cv::Vec2f link(raw_link.x, raw_link.y);
+
+		const double a_perpendicular_ratio = std::acos(MathUtility::CosIncludedAngle(a_direction, link)) / half_pi;
+		const double b_perpendicular_ratio = std::acos(MathUtility::CosIncludedAngle(b_direction, link)) / half_pi;
+		if (a_perpendicular_ratio < settings.MinLinkPerpendicularRatio &&
+			b_perpendicular_ratio < settings.MinLinkPerpendicularRatio)
+		{
+			return Verdict::Reject;
+		}
+
+		// 两个灯条的正交线都与另一个灯条相交
+		auto a_cross_point = MathUtility::LineCrossPoint(a_center, light_bars.GetOrthogonal(a), b_center, b_direction);
+		auto b_cross_point = MathUtility::LineCrossPoint(b_center, light_bars.GetOrthogonal(b), a_center, a_direction);
+		if (!a_cross_point || !b_cross_point) return Verdict::Reject;
+
+		const double a_limit = lengths[b] * settings.CrossPointMaxDistanceRatio;
+		const double b_limit = lengths[a] * settings.CrossPointMaxDistanceRatio;
+		const double a_distance = service_settings.PreciseIntersectionTest ?
+				light_bars.GetOutsideDistance(b, *a_cross_point, a_limit) : light_bars.GetSignedDistance(b, *a_cross_point);
+		const double b_distance = service_settings.PreciseIntersectionTest ?
+				light_bars.GetOutsideDistance(a, *b_cross_point, b_limit) : light_bars.GetSignedDistance(a, *b_cross_point);
+		if (!(a_distance <= a_limit * (1.0 + BoundaryTolerance)) || !(b_distance <= b_limit * (1.0 + BoundaryTolerance)))
+		{
+			return Verdict::Reject;
+		}
+		if (std::fabs(a_distance - a_limit) <= a_limit * BoundaryTolerance ||
+			std::fabs(b_distance - b_limit) <= b_limit * BoundaryTolerance)
+		{
+			return Verdict::Boundary;
+		}
+		return Verdict::Accept;
+	}
+
+	/**
+	 * @brief 逐对核验全部形状相同的元素对
+	 * @param settings 装甲板匹配服务的设定
+	 * @param light_bars 灯条表
+	 * @param pairs 输出的接受的元素对
+	 * @param boundary 输出的距离落在上限附近的元素对
+	 */
+	void ReferenceSearch(const ArmorMatchingService::SettingsType& settings, const LightBarTable& light_bars,
+					  std::vector<ArmorMatchingService::IndexPair>& pairs,
+					  std::vector<ArmorMatchingService::IndexPair>& boundary)
+	{
+		pairs.clear();
+		boundary.clear();
+		for (std::size_t a = 0; a < light_bars.Size(); ++a)
+		{
+			for (std::size_t b = a + 1; b < light_bars.Size(); ++b)
+			{
+				if (light_bars.Shapes()[a] != light_bars.Shapes()[b]) continue;
+
+				switch (ReferenceCheck(settings, light_bars, a, b))
+				{
+					case Verdict::Accept:
+						pairs.emplace_back(a, b);
+						break;
+					case Verdict::Boundary:
+						boundary.emplace_back(a, b);
+						break;
+					default:
+						break;
+				}
+			}
+		}
+	}
+}
+
+int main(int arguments_count, char** arguments)
+{
+	using namespace RoboPioneers::Benchmarks;
+
+	int tables_count = arguments_count > 1 ? std::stoi(arguments[1]) : 400;
+
+	std::mt19937 random(7);
+	std::vector<LightBarTable> tables;
+	for (int index = 0; index < tables_count; ++index)
+	{
+		tables.push_back(GenerateTable(random, 5 + index % 60, index % 3 != 0));
+	}
+
+	std::printf("%-24s %12s %12s %10s %10s %10s\n",
+			 "Configuration", "Batched ms", "Scalar ms", "Pairs", "Boundary", "Mismatches");
+
+	// 关闭邻域筛选，使批量核验与逐对核验面对相同的元素对
+	ArmorMatchingService service;
+	service.Settings.Neighborhood.Enable = false;
+
+	std::size_t total_mismatches = 0;
+	for (int precise = 0; precise < 2; ++precise)
+	{
+		for (int parallel = 0; parallel < 2; ++parallel)
+		{
+			service.Settings.PreciseIntersectionTest = precise == 1;
+			service.Settings.SerialThreshold = parallel == 1 ? 0 : std::numeric_limits<std::size_t>::max();
+
+			std::vector<std::vector<ArmorMatchingService::IndexPair>> batched(tables.size()), scalar(tables.size()),
+				boundary(tables.size());
+
+			auto begin_time = Clock::now();
+			for (std::size_t index = 0; index < tables.size(); ++index)
+			{
+				service.SearchPossiblePairs(tables[index], batched[index]);
+			}
+			const double batched_time = std::chrono::duration<double, std::milli>(Clock::now() - begin_time).count();
+
+			begin_time = Clock::now();
+			for (std::size_t index = 0; index < tables.size(); ++index)
+			{
+				ReferenceSearch(service.Settings, tables[index], scalar[index], boundary[index]);
+			}
+			const double scalar_time = std::chrono::duration<double, std::milli>(Clock::now() - begin_time).count();
+
+			std::size_t pairs = 0, boundaries = 0, mismatches = 0;
+			for (std::size_t index = 0; index < tables.size(); ++index)
+			{
+				// 边界上的元素对无论批量核验的结论如何都不计入不一致
+				std::vector<ArmorMatchingService::IndexPair> difference, unexplained;
+				std::set_symmetric_difference(batched[index].begin(), batched[index].end(),
+								  scalar[index].begin(), scalar[index].end(), std::back_inserter(difference));
+				std::set_difference(difference.begin(), difference.end(),
+						boundary[index].begin(), boundary[index].end(), std::back_inserter(unexplained));
+				pairs += scalar[index].size();
+				boundaries += boundary[index].size();
+				mismatches += unexplained.size();
+			}
+			total_mismatches += mismatches;
+
+			std::string name = std::string(precise == 1 ? "Contour" : "Analytic") + (parallel == 1 ? " parallel" : " serial");
+			std::printf("%-24s %12.3f %12.3f %10zu %10zu %10zu\n",
+					 name.c_str(), batched_time, scalar_time, pairs, boundaries, mismatches);
+		}
+	}
+
+	return total_mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include <Modules/ColorThresholdModule.hpp>
+#include <Modules/ColorLookupTable.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace RoboPioneers::Benchmarks
+{
+	using Clock = std::chrono::steady_clock;
+	using Modules::ColorThresholdModule;
+	using Modules::ColorLookupTable;
+
+	/// 红色阈值设定，与颜色感知服务的默认值一致
+	constexpr int Hue1UpperBound = 55;
+	constexpr int Hue2LowerBound = 180;
+	constexpr int SaturationLowerBound = 100;
+	constexpr int ValueLowerBound = 180;
+
+	/**
+	 * @brief 原处理链的内存版本
+	 * @details
+	 *  ~ 与颜色感知服务中的FilterRedArea步骤相同，被掩盖的像素置为0。
+	 */
+	void ThresholdChain(const cv::Mat& hsv_picture, cv::Mat& mask)
+	{
+		std::vector<cv::Mat> channels;
+		cv::split(hsv_picture, channels);
+
+		cv::Mat hue1, hue2, saturation, value;
+		cv::threshold(channels[0], hue1, Hue1UpperBound, 255, cv::THRESH_BINARY_INV);
+		cv::threshold(channels[0], hue2, Hue2LowerBound, 255, cv::THRESH_BINARY);
+		cv::threshold(channels[1], saturation, SaturationLowerBound, 255, cv::THRESH_BINARY);
+		cv::threshold(channels[2], value, ValueLowerBound, 255, cv::THRESH_BINARY);
+
+		mask = cv::Mat::zeros(hsv_picture.size(), CV_8UC1);
+		cv::bitwise_or(hue1, hue2, mask, saturation);
+		cv::bitwise_and(mask, value, mask);
+	}
+
+	/// 获取红色颜色范围
+	ColorThresholdModule::ColorRange GetRedRange()
+	{
+		ColorThresholdModule::ColorRange range;
+		range.HueIntervals[0] = ColorThresholdModule::NotGreaterThan(Hue1UpperBound);
+		range.HueIntervals[1] = ColorThresholdModule::GreaterThan(Hue2LowerBound);
+		range.SaturationInterval = ColorThresholdModule::GreaterThan(SaturationLowerBound);
+		range.ValueInterval = ColorThresholdModule::GreaterThan(ValueLowerBound);
+		return range;
+	}
+
+	/**
+	 * @brief 测量平均耗时
+	 * @return 每帧平均耗时，单位为毫秒
+	 */
+	double Measure(const std::function<void()>& action, int iterations)
+	{
+		// 预热，排除首次分配与线程池启动的开销
+		action();
+
+		auto begin_time = Clock::now();
+		for (int index = 0; index < iterations; ++index)
+		{
+			action();
+		}
+		return std::chrono::duration<double, std::milli>(Clock::now() - begin_time).count() / iterations;
+	}
+
+	/// 计算两张蒙版的一致率
+	double Agreement(const cv::Mat& mask, const cv::Mat& reference)
+	{
+		return 1.0 - static_cast<double>(cv::countNonZero(mask != reference)) / static_cast<double>(reference.total());
+	}
+}
+
+int main(int arguments_count, char** arguments)
+{
+	using namespace RoboPioneers::Benchmarks;
+
+	int iterations = arguments_count > 1 ? std::stoi(arguments[1]) : 200;
+
+	// 随机HSV画面，色调范围与COLOR_BGR2HSV一致
+	cv::Mat hsv_picture(1024, 1280, CV_8UC3);
+	cv::randu(hsv_picture, cv::Scalar(0, 0, 0), cv::Scalar(180, 256, 256));
+
+	cv::Mat reference;
+	ThresholdChain(hsv_picture, reference);
+
+	std::printf("%-24s %12s %12s\n", "Classifier", "ms/frame", "Agreement");
+
+	cv::Mat mask;
+	auto chain_time = Measure([&](){ ThresholdChain(hsv_picture, mask); }, iterations);
+	std::printf("%-24s %12.3f %11.4f%%\n", "Threshold chain", chain_time, Agreement(mask, reference) * 100.0);
+
+	auto range = GetRedRange();
+	auto fused_time = Measure([&](){ ColorThresholdModule::Threshold(hsv_picture, mask, range); }, iterations);
+	std::printf("%-24s %12.3f %11.4f%%\n", "Fused threshold", fused_time, Agreement(mask, reference) * 100.0);
+
+	// 依次为默认量化、色调精确的量化、与阈值判定逐位一致的量化
+	const std::vector<ColorLookupTable::Quantization> quantizations {{6, 6, 6}, {8, 6, 6}, {8, 8, 8}};
+	for (const auto& quantization : quantizations)
+	{
+		ColorLookupTable table(quantization);
+		table.Paint(range, ColorLookupTable::ClassBit::Red);
+
+		auto table_time = Measure([&](){
+			table.Threshold(hsv_picture, mask, ColorLookupTable::ClassBit::Red);
+		}, iterations);
+
+		std::string name = "Lookup table " + std::to_string(quantization.HueBits) + "/" +
+				std::to_string(quantization.SaturationBits) + "/" + std::to_string(quantization.ValueBits);
+		std::printf("%-24s %12.3f %11.4f%%\n", name.c_str(), table_time, Agreement(mask, reference) * 100.0);
+	}
+}
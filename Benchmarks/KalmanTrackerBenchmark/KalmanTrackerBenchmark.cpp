@@ -0,0 +1,101 @@
+#include <Modules/KalmanTracker.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+
+namespace RoboPioneers::Benchmarks
+{
+	using Clock = std::chrono::steady_clock;
+	using Modules::KalmanTracker;
+
+	/// 匀速运动的模拟目标
+	struct Target
+	{
+		/// 初始中心
+		cv::Point2d Origin {100.0, 200.0};
+		/// 速度，单位为像素每秒
+		cv::Point2d Velocity {300.0, -120.0};
+		/// 长宽
+		cv::Size2d Size {40.0, 15.0};
+
+		/// 获取指定秒数时的真实中心
+		[[nodiscard]] cv::Point2d GetCenter(double seconds) const
+		{
+			return Origin + Velocity * seconds;
+		}
+	};
+}
+
+int main(int arguments_count, char** arguments)
+{
+	using namespace RoboPioneers::Benchmarks;
+
+	int frames_count = arguments_count > 1 ? std::stoi(arguments[1]) : 300;
+	// 前若干帧用于收敛，不计入误差
+	constexpr int ConvergeFrames = 50;
+	// 外推的提前量，近似于从拍摄到执行的延迟
+	const auto lead_time = std::chrono::milliseconds(25);
+
+	std::mt19937 random(1);
+	std::normal_distribution<double> noise(0.0, 2.0);
+	std::uniform_int_distribution<int> frame_interval(8000, 12000);
+
+	const Target target;
+	KalmanTracker tracker;
+
+	const auto begin_time = Clock::now();
+	auto frame_time = begin_time;
+	double predicted_error = 0.0, stale_error = 0.0, elapsed_time = 0.0;
+	double velocity_sum_x = 0.0, velocity_sum_y = 0.0;
+	int samples = 0;
+
+	for (int frame = 0; frame < frames_count; ++frame)
+	{
+		// 帧间隔为8至12毫秒，与相机的实际帧率相近
+		frame_time += std::chrono::microseconds(frame_interval(random));
+		const double seconds = std::chrono::duration<double>(frame_time - begin_time).count();
+
+		const auto truth = target.GetCenter(seconds);
+		const cv::Point2d measured(truth.x + noise(random), truth.y + noise(random));
+		const cv::Size2d measured_size(target.Size.width + noise(random), target.Size.height + noise(random));
+
+		const auto update_begin = Clock::now();
+		tracker.Update(measured, measured_size, frame_time);
+		const auto aim = tracker.Extrapolate(frame_time + lead_time);
+		elapsed_time += std::chrono::duration<double, std::micro>(Clock::now() - update_begin).count();
+
+		if (frame < ConvergeFrames) continue;
+
+		// 以执行时刻的真实位置为准，比较外推位置与直接使用的观测位置
+		const auto actual = target.GetCenter(seconds + std::chrono::duration<double>(lead_time).count());
+		predicted_error += std::hypot(aim.Center.x - actual.x, aim.Center.y - actual.y);
+		stale_error += std::hypot(measured.x - actual.x, measured.y - actual.y);
+		// 单帧的速度估计受观测噪声影响较大，取平均以检查是否有偏
+		const auto state = tracker.GetState();
+		velocity_sum_x += state.Velocity[0];
+		velocity_sum_y += state.Velocity[1];
+		++samples;
+	}
+
+	if (samples == 0)
+	{
+		std::printf("At least %d frames are required.\n", ConvergeFrames + 1);
+		return 1;
+	}
+
+	predicted_error /= samples;
+	stale_error /= samples;
+
+	std::printf("%-24s %12.3f\n", "Update us per frame", elapsed_time / frames_count);
+	std::printf("%-24s %12.1f %8.1f\n", "Mean estimated velocity",
+			 velocity_sum_x / samples, velocity_sum_y / samples);
+	std::printf("%-24s %12.1f %8.1f\n", "Actual velocity", target.Velocity.x, target.Velocity.y);
+	std::printf("%-24s %12.2f\n", "Predicted error px", predicted_error);
+	std::printf("%-24s %12.2f\n", "Stale error px", stale_error);
+
+	// 外推应当明显优于直接使用观测位置
+	return predicted_error < stale_error ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+#include <Modules/MultiTargetTracker.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace RoboPioneers::Benchmarks
+{
+	using Clock = std::chrono::steady_clock;
+	using Modules::MultiTargetTracker;
+
+	/// 网格单元的宽度
+	constexpr double CellWidth = 160.0;
+	/// 网格单元的高度
+	constexpr double CellHeight = 150.0;
+	/// 目标中心相对单元中心的最大偏移
+	constexpr double MaxOffsetX = 55.0, MaxOffsetY = 50.0;
+
+	/**
+	 * @brief 模拟装甲板
+	 * @details
+	 *  ~ 目标在各自的网格单元内匀速运动，碰到边界时反弹。
+	 *  ~ 相邻目标的中心最近相距50像素，在关联门限以内，但不会重叠；
+	 *    实际画面中装甲板不会相互穿过，重叠时两个观测无法区分，编号交换不视为跟踪器的错误。
+	 */
+	struct Target
+	{
+		/// 所在网格单元的中心
+		cv::Point2d Cell;
+		/// 中心
+		cv::Point2d Center;
+		/// 速度，单位为像素每秒
+		cv::Point2d Velocity;
+		/// 当前关联的轨迹编号，尚未关联时为0
+		unsigned int TrackId {0};
+
+		/// 运动指定秒数，越过单元边界时反弹
+		void Move(double seconds)
+		{
+			Center += Velocity * seconds;
+			if (std::fabs(Center.x - Cell.x) > MaxOffsetX)
+			{
+				Center.x = 2.0 * (Cell.x + std::copysign(MaxOffsetX, Center.x - Cell.x)) - Center.x;
+				Velocity.x = -Velocity.x;
+			}
+			if (std::fabs(Center.y - Cell.y) > MaxOffsetY)
+			{
+				Center.y = 2.0 * (Cell.y + std::copysign(MaxOffsetY, Center.y - Cell.y)) - Center.y;
+				Velocity.y = -Velocity.y;
+			}
+		}
+	};
+
+	/// 在4x4的网格上生成速度随机的目标
+	std::vector<Target> Generate(std::mt19937& random, int count)
+	{
+		std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+		std::vector<Target> targets(count);
+		for (int index = 0; index < count; ++index)
+		{
+			targets[index].Cell = cv::Point2d(100.0 + CellWidth * (index % 4), 100.0 + CellHeight * (index / 4));
+			targets[index].Center = targets[index].Cell;
+			targets[index].Velocity = cv::Point2d(400.0 * (unit(random) - 0.5), 200.0 * (unit(random) - 0.5));
+		}
+		return targets;
+	}
+}
+
+int main(int arguments_count, char** arguments)
+{
+	using namespace RoboPioneers::Benchmarks;
+
+	int frames_count = arguments_count > 1 ? std::stoi(arguments[1]) : 500;
+	constexpr int TargetsCount = 16;
+	// 每个目标在每帧中漏检的概率
+	constexpr double MissProbability = 0.1;
+	const auto frame_interval = std::chrono::milliseconds(10);
+
+	std::mt19937 random(2);
+	std::normal_distribution<double> noise(0.0, 1.5);
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+	auto targets = Generate(random, TargetsCount);
+	MultiTargetTracker tracker;
+	std::vector<MultiTargetTracker::Detection> detections;
+
+	auto frame_time = Clock::now();
+	double total_time = 0.0, worst_time = 0.0;
+	int switches = 0;
+
+	for (int frame = 0; frame < frames_count; ++frame)
+	{
+		frame_time += frame_interval;
+
+		// 评分记录目标的下标，关联成功的轨迹会保存该评分，由此得知轨迹对应的目标
+		detections.clear();
+		for (int index = 0; index < TargetsCount; ++index)
+		{
+			auto& target = targets[index];
+			target.Move(std::chrono::duration<double>(frame_interval).count());
+			if (unit(random) < MissProbability) continue;
+
+			detections.push_back({cv::RotatedRect(),
+						 cv::Point2d(target.Center.x + noise(random), target.Center.y + noise(random)),
+						 cv::Size2d(50.0, 20.0), static_cast<double>(index)});
+		}
+		// 打乱观测顺序，使关联结果不依赖于输入顺序
+		std::shuffle(detections.begin(), detections.end(), random);
+
+		const auto update_begin = Clock::now();
+		tracker.Update(detections, frame_time);
+		const double update_time = std::chrono::duration<double, std::micro>(Clock::now() - update_begin).count();
+		total_time += update_time;
+		worst_time = std::max(worst_time, update_time);
+
+		//==============================
+		// 统计编号切换
+		//==============================
+
+		for (const auto& track : tracker.GetTracks())
+		{
+			if (!track.Matched) continue;
+
+			auto& target = targets[static_cast<std::size_t>(track.Score)];
+			if (target.TrackId == 0)
+			{
+				target.TrackId = track.Id;
+			}
+			else if (target.TrackId != track.Id)
+			{
+				// 目标改由其他轨迹关联，此后以新的轨迹为准
+				++switches;
+				target.TrackId = track.Id;
+			}
+		}
+	}
+
+	const auto& tracks = tracker.GetTracks();
+	const auto confirmed = std::count_if(tracks.begin(), tracks.end(), [&tracker](const auto& track){
+		return tracker.IsConfirmed(track);
+	});
+
+	std::printf("%-24s %12.3f\n", "Update us mean", total_time / std::max(frames_count, 1));
+	std::printf("%-24s %12.3f\n", "Update us worst", worst_time);
+	std::printf("%-24s %12zu\n", "Tracks alive", tracks.size());
+	std::printf("%-24s %12ld\n", "Tracks confirmed", static_cast<long>(confirmed));
+	std::printf("%-24s %12d\n", "ID switches", switches);
+
+	return switches == 0 ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+#include <Modules/GeometryFeatureModule.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace RoboPioneers::Benchmarks
+{
+	using Clock = std::chrono::steady_clock;
+	using Modules::GeometryFeatureModule;
+	using BarPair = std::array<GeometryFeatureModule::BarParameters, 2>;
+	using Corners = std::array<cv::Point2f, 8>;
+
+	/// 生成随机灯条对，大部分接近竖直，少数带有较大的转角差
+	std::vector<BarPair> Generate(std::mt19937& random, int count)
+	{
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		std::vector<BarPair> pairs(count);
+		for (int index = 0; index < count; ++index)
+		{
+			for (int bar = 0; bar < 2; ++bar)
+			{
+				float angle = (85.0f + 10.0f * unit(random)) * static_cast<float>(CV_PI) / 180.0f;
+				if (index % 5 == 0) angle += unit(random);
+
+				pairs[index][bar] = {
+					cv::Point2f(100.0f * static_cast<float>(bar) + 20.0f * unit(random), 50.0f * unit(random)),
+					cv::Vec2f(std::cos(angle), std::sin(angle)),
+					10.0f + 30.0f * unit(random),
+					2.0f + 6.0f * unit(random)
+				};
+			}
+		}
+		return pairs;
+	}
+
+	/// 获取灯条对的8个顶点
+	Corners GetCorners(const BarPair& pair)
+	{
+		Corners corners;
+		for (std::size_t bar = 0; bar < 2; ++bar)
+		{
+			const auto& parameters = pair[bar];
+			const cv::Point2f half_length(parameters.UnitDirection(0) * parameters.Length / 2,
+								 parameters.UnitDirection(1) * parameters.Length / 2);
+			const cv::Point2f half_width(-parameters.UnitDirection(1) * parameters.Width / 2,
+								parameters.UnitDirection(0) * parameters.Width / 2);
+			corners[4 * bar] = parameters.Center + half_length + half_width;
+			corners[4 * bar + 1] = parameters.Center + half_length - half_width;
+			corners[4 * bar + 2] = parameters.Center - half_length - half_width;
+			corners[4 * bar + 3] = parameters.Center - half_length + half_width;
+		}
+		return corners;
+	}
+
+	/**
+	 * @brief 逐方向扫描求顶点的最小外接矩形面积，作为参照
+	 * @param corners 顶点
+	 * @param steps 在180度内扫描的方向数
+	 */
+	double SweepArea(const Corners& corners, int steps)
+	{
+		double best = std::numeric_limits<double>::max();
+		for (int step = 0; step < steps; ++step)
+		{
+			const double angle = step * CV_PI / steps;
+			const double direction_x = std::cos(angle), direction_y = std::sin(angle);
+			double min_u = std::numeric_limits<double>::max(), max_u = std::numeric_limits<double>::lowest();
+			double min_v = min_u, max_v = max_u;
+			for (const auto& corner : corners)
+			{
+				const double u = corner.x * direction_x + corner.y * direction_y;
+				const double v = corner.y * direction_x - corner.x * direction_y;
+				min_u = std::min(min_u, u);
+				max_u = std::max(max_u, u);
+				min_v = std::min(min_v, v);
+				max_v = std::max(max_v, v);
+			}
+			best = std::min(best, (max_u - min_u) * (max_v - min_v));
+		}
+		return best;
+	}
+
+	/// 判断顶点是否都在旋转矩形内，允许一定的误差
+	bool Contains(const cv::RotatedRect& rectangle, const Corners& corners, double tolerance)
+	{
+		const double angle = rectangle.angle * CV_PI / 180.0;
+		const double cos_angle = std::cos(angle), sin_angle = std::sin(angle);
+		for (const auto& corner : corners)
+		{
+			const double delta_x = corner.x - rectangle.center.x;
+			const double delta_y = corner.y - rectangle.center.y;
+			const double u = delta_x * cos_angle + delta_y * sin_angle;
+			const double v = delta_y * cos_angle - delta_x * sin_angle;
+			if (std::fabs(u) > rectangle.size.width / 2 + tolerance ||
+				std::fabs(v) > rectangle.size.height / 2 + tolerance)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+int main(int arguments_count, char** arguments)
+{
+	using namespace RoboPioneers::Benchmarks;
+
+	int pairs_count = arguments_count > 1 ? std::stoi(arguments[1]) : 2000;
+	// 扫描步长为0.01度
+	constexpr int SweepSteps = 18000;
+
+	std::mt19937 random(3);
+	const auto pairs = Generate(random, pairs_count);
+
+	std::vector<cv::RotatedRect> analytic(pairs.size()), hull(pairs.size());
+
+	auto begin_time = Clock::now();
+	for (std::size_t index = 0; index < pairs.size(); ++index)
+	{
+		analytic[index] = GeometryFeatureModule::GetPairRotatedRectangle(pairs[index][0], pairs[index][1]);
+	}
+	const double analytic_time = std::chrono::duration<double, std::milli>(Clock::now() - begin_time).count();
+
+	begin_time = Clock::now();
+	for (std::size_t index = 0; index < pairs.size(); ++index)
+	{
+		const auto corners = GetCorners(pairs[index]);
+		hull[index] = cv::minAreaRect(std::vector<cv::Point2f>(corners.begin(), corners.end()));
+	}
+	const double hull_time = std::chrono::duration<double, std::milli>(Clock::now() - begin_time).count();
+
+	//==============================
+	// 与逐方向扫描及cv::minAreaRect比较面积，并检查包含关系
+	//==============================
+
+	double worst_sweep_excess = 0.0, worst_hull_excess = 0.0;
+	int not_contained = 0;
+	for (std::size_t index = 0; index < pairs.size(); ++index)
+	{
+		const auto corners = GetCorners(pairs[index]);
+		const double area = analytic[index].size.area();
+
+		const double sweep_area = SweepArea(corners, SweepSteps);
+		worst_sweep_excess = std::max(worst_sweep_excess, (area - sweep_area) / sweep_area);
+		worst_hull_excess = std::max(worst_hull_excess, (area - hull[index].size.area()) / hull[index].size.area());
+
+		if (!Contains(analytic[index], corners, 1e-3)) ++not_contained;
+	}
+
+	std::printf("%-24s %12.3f\n", "Analytic ms", analytic_time);
+	std::printf("%-24s %12.3f\n", "cv::minAreaRect ms", hull_time);
+	std::printf("%-24s %12.6f\n", "Worst excess vs sweep", worst_sweep_excess);
+	std::printf("%-24s %12.6f\n", "Worst excess vs hull", worst_hull_excess);
+	std::printf("%-24s %12d\n", "Not contained", not_contained);
+
+	// 扫描结果只会大于等于真实的最小面积，解析结果不应明显大于它
+	return worst_sweep_excess <= 1e-4 && worst_hull_excess <= 1e-4 && not_contained == 0 ? 0 : 1;
+}
@@ -0,0 +1,273 @@
+#include <SerialPortDriver/SerialPortDriver.hpp>
+
+#include <pty.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace RoboPioneers::Benchmarks
+{
+	using Clock = std::chrono::steady_clock;
+	using SerialPort = Modules::SerialPortDriver::SerialPort;
+
+	/**
+	 * @brief 下位机回显模拟器
+	 * @author Vincent
+	 * @details
+	 *  ~ 该类创建一对伪终端，从设备端交给串口对象打开，主设备端由模拟线程持有。
+	 *  ~ 模拟线程将收到的所有字节原样写回，模拟一个处理时间可忽略的下位机。
+	 */
+	class EchoSimulator
+	{
+	private:
+		/// 主设备端文件描述符
+		int MasterDescriptor {-1};
+		/// 从设备端文件描述符，需要保持打开以免伪终端被挂断
+		int SlaveDescriptor {-1};
+		/// 从设备端文件名
+		std::string SlaveNameSource;
+
+		/// 模拟线程
+		std::thread EchoThread;
+		/// 模拟线程运行旗标
+		std::atomic_bool Running {false};
+
+	public:
+		/// 从设备端文件名，交给串口对象打开
+		const std::string& SlaveName {SlaveNameSource};
+
+		/// 构造函数，将创建伪终端并启动模拟线程
+		EchoSimulator()
+		{
+			char name[256] {};
+			if (openpty(&MasterDescriptor, &SlaveDescriptor, name, nullptr, nullptr) != 0)
+			{
+				throw std::runtime_error("EchoSimulator::EchoSimulator Failed to Open Pseudo Terminal.");
+			}
+			SlaveNameSource = name;
+
+			Running = true;
+			EchoThread = std::thread(&EchoSimulator::EchoLoop, this);
+		}
+
+		/// 析构函数，将停止模拟线程并关闭伪终端
+		~EchoSimulator()
+		{
+			Running = false;
+			if (EchoThread.joinable())
+			{
+				EchoThread.join();
+			}
+			close(MasterDescriptor);
+			close(SlaveDescriptor);
+		}
+
+	private:
+		/// 回显主循环
+		void EchoLoop()
+		{
+			std::vector<unsigned char> buffer(4096);
+
+			while (Running)
+			{
+				pollfd descriptor {MasterDescriptor, POLLIN, 0};
+				if (poll(&descriptor, 1, 10) <= 0 || !(descriptor.revents & POLLIN))
+				{
+					continue;
+				}
+
+				auto length = read(MasterDescriptor, buffer.data(), buffer.size());
+				// 写入可能只完成一部分，需要循环直到全部写回
+				for (ssize_t written = 0; length > 0 && written < length;)
+				{
+					auto result = write(MasterDescriptor, buffer.data() + written, length - written);
+					if (result <= 0) break;
+					written += result;
+				}
+			}
+		}
+	};
+
+	/// 单项测试结果
+	struct BenchmarkResult
+	{
+		/// 写入延迟中位数，单位为微秒
+		double WriteLatencyP50 {0.0};
+		/// 写入延迟99分位数，单位为微秒
+		double WriteLatencyP99 {0.0};
+		/// 往返延迟中位数，单位为微秒，异步模式下不统计
+		double RoundTripP50 {0.0};
+		/// 持续吞吐量，单位为包每秒
+		double PacketsPerSecond {0.0};
+	};
+
+	/**
+	 * @brief 求分位数
+	 * @param samples 样本，将被重新排列
+	 * @param ratio 分位，0.0f~1.0f
+	 * @return 分位数
+	 */
+	double Percentile(std::vector<double>& samples, double ratio)
+	{
+		if (samples.empty()) return 0.0;
+
+		auto index = static_cast<std::size_t>(ratio * static_cast<double>(samples.size() - 1));
+		std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+		return samples[index];
+	}
+
+	/// 计算微秒间隔
+	double Microseconds(Clock::time_point begin, Clock::time_point end)
+	{
+		return std::chrono::duration<double, std::micro>(end - begin).count();
+	}
+
+	/**
+	 * @brief 同步模式测试
+	 * @details
+	 *  ~ 每个包写入后等待回显完整到达再写入下一个包，模拟逐帧的请求应答。
+	 */
+	BenchmarkResult RunSynchronous(SerialPort& port, std::size_t packet_size, std::size_t packets)
+	{
+		std::vector<unsigned char> packet(packet_size, 0x5A);
+		std::vector<double> write_latencies, round_trips;
+		write_latencies.reserve(packets);
+		round_trips.reserve(packets);
+
+		auto begin_time = Clock::now();
+		for (std::size_t index = 0; index < packets; ++index)
+		{
+			auto send_time = Clock::now();
+			port.Write(packet);
+			auto written_time = Clock::now();
+			port.Read(packet_size);
+			auto echoed_time = Clock::now();
+
+			write_latencies.push_back(Microseconds(send_time, written_time));
+			round_trips.push_back(Microseconds(send_time, echoed_time));
+		}
+		auto total_time = Microseconds(begin_time, Clock::now());
+
+		BenchmarkResult result;
+		result.WriteLatencyP50 = Percentile(write_latencies, 0.5);
+		result.WriteLatencyP99 = Percentile(write_latencies, 0.99);
+		result.RoundTripP50 = Percentile(round_trips, 0.5);
+		result.PacketsPerSecond = static_cast<double>(packets) / total_time * 1e6;
+		return result;
+	}
+
+	/**
+	 * @brief 异步模式测试
+	 * @details
+	 *  ~ 写入线程连续写入，读取线程独立地排空回显，模拟主循环只写不等的实际工作方式。
+	 *  ~ 吞吐量以最后一个字节回显到达的时间计算。
+	 */
+	BenchmarkResult RunAsynchronous(SerialPort& port, std::size_t packet_size, std::size_t packets)
+	{
+		std::vector<unsigned char> packet(packet_size, 0xA5);
+		std::vector<double> write_latencies;
+		write_latencies.reserve(packets);
+
+		const std::size_t total_bytes = packet_size * packets;
+		std::atomic_bool reader_failed {false};
+
+		auto begin_time = Clock::now();
+		std::thread reader([&port, total_bytes, &reader_failed](){
+			std::size_t received = 0;
+			auto last_data_time = Clock::now();
+			while (received < total_bytes)
+			{
+				if (port.WaitForData(std::chrono::milliseconds(10)))
+				{
+					received += port.Read().size();
+					last_data_time = Clock::now();
+				}
+				else if (Clock::now() - last_data_time > std::chrono::seconds(5))
+				{
+					reader_failed = true;
+					return;
+				}
+			}
+		});
+
+		for (std::size_t index = 0; index < packets; ++index)
+		{
+			auto send_time = Clock::now();
+			port.Write(packet);
+			write_latencies.push_back(Microseconds(send_time, Clock::now()));
+		}
+		reader.join();
+		auto total_time = Microseconds(begin_time, Clock::now());
+
+		if (reader_failed)
+		{
+			throw std::runtime_error("RunAsynchronous Echo Timed Out.");
+		}
+
+		BenchmarkResult result;
+		result.WriteLatencyP50 = Percentile(write_latencies, 0.5);
+		result.WriteLatencyP99 = Percentile(write_latencies, 0.99);
+		result.PacketsPerSecond = static_cast<double>(packets) / total_time * 1e6;
+		return result;
+	}
+}
+
+int main(int arguments_count, char** arguments)
+{
+	using namespace RoboPioneers::Benchmarks;
+
+	std::size_t packets = arguments_count > 1 ? std::stoul(arguments[1]) : 2000;
+
+	const std::vector<unsigned int> baud_rates {115200, 460800, 921600};
+	// 15字节为目标数据包的长度
+	const std::vector<std::size_t> packet_sizes {15, 64, 256};
+
+	std::printf("%-6s %8s %6s %12s %12s %12s %12s\n",
+			 "Mode", "Baud", "Size", "Write P50", "Write P99", "RTT P50", "Packets/s");
+
+	for (auto baud_rate : baud_rates)
+	{
+		for (auto packet_size : packet_sizes)
+		{
+			for (bool asynchronous : {false, true})
+			{
+				// 每项测试使用新的伪终端，避免残留数据影响结果
+				EchoSimulator simulator;
+
+				SerialPort port;
+				port.Open(simulator.SlaveName);
+				port.SetBaudRate(baud_rate);
+				port.SetParityType(SerialPort::parity::none);
+				port.SetStopBitsType(SerialPort::stop_bits::one);
+				port.SetCharacterSize(8);
+
+				auto result = asynchronous ? RunAsynchronous(port, packet_size, packets) :
+						RunSynchronous(port, packet_size, packets);
+
+				// 异步模式不等待回显，不统计往返延迟
+				std::string round_trip = asynchronous ? "-" : std::to_string(
+						static_cast<long>(result.RoundTripP50 + 0.5)) + "us";
+
+				std::printf("%-6s %8u %6zu %10.1fus %10.1fus %12s %12.0f\n",
+				            asynchronous ? "async" : "sync", baud_rate, packet_size,
+				            result.WriteLatencyP50, result.WriteLatencyP99,
+				            round_trip.c_str(), result.PacketsPerSecond);
+
+				port.Close();
+			}
+		}
+	}
+
+	// 伪终端不模拟线路速率，波特率仅验证设置路径，结果反映的是驱动与系统调用的开销
+	std::cout << "Note: pseudo terminals ignore the baud rate; "
+			  "figures measure driver and system call overhead only." << std::endl;
+}
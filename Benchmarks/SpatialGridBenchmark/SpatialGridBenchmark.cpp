@@ -0,0 +1,151 @@
+#include <Modules/SpatialGrid.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace RoboPioneers::Benchmarks
+{
+	using Clock = std::chrono::steady_clock;
+	using Modules::SpatialGrid;
+
+	/// 点集布局
+	enum class Layout
+	{
+		/// 在整幅画面中均匀分布
+		Uniform,
+		/// 集中在一条水平带中，大部分网格为空
+		Flat,
+		/// 分散在远大于查询半径的范围中，网格边长将被自动增大
+		Spread
+	};
+
+	/// 测试用例
+	struct Case
+	{
+		/// 点的横坐标
+		std::vector<float> PointsX;
+		/// 点的纵坐标
+		std::vector<float> PointsY;
+		/// 网格边长
+		float CellSize;
+		/// 查询圆，依次为圆心横坐标、圆心纵坐标与半径
+		std::vector<std::array<float, 3>> Queries;
+	};
+
+	/// 生成测试用例
+	Case Generate(std::mt19937& random, Layout layout)
+	{
+		std::uniform_real_distribution<float> coordinate(0.0f, 1280.0f);
+		const float scale_x = layout == Layout::Spread ? 100.0f : 1.0f;
+		const float scale_y = layout == Layout::Flat ? 0.01f : (layout == Layout::Spread ? 100.0f : 1.0f);
+
+		Case result;
+		const auto count = static_cast<std::size_t>(random() % 300);
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			result.PointsX.push_back(coordinate(random) * scale_x);
+			result.PointsY.push_back(coordinate(random) * scale_y);
+		}
+		result.CellSize = 1.0f + static_cast<float>(random() % 200);
+		for (int index = 0; index < 20; ++index)
+		{
+			result.Queries.push_back({coordinate(random) * scale_x, coordinate(random) * scale_y,
+							 static_cast<float>(random() % 300)});
+		}
+		return result;
+	}
+
+	/// 逐点计算查询圆内的点，作为参照
+	std::vector<std::size_t> BruteForce(const Case& test_case, const std::array<float, 3>& query)
+	{
+		std::vector<std::size_t> result;
+		for (std::size_t index = 0; index < test_case.PointsX.size(); ++index)
+		{
+			const float delta_x = test_case.PointsX[index] - query[0];
+			const float delta_y = test_case.PointsY[index] - query[1];
+			if (delta_x * delta_x + delta_y * delta_y <= query[2] * query[2]) result.push_back(index);
+		}
+		return result;
+	}
+
+	/**
+	 * @brief 测量总耗时
+	 * @return 耗时，单位为毫秒
+	 */
+	double Measure(const std::function<void()>& action)
+	{
+		auto begin_time = Clock::now();
+		action();
+		return std::chrono::duration<double, std::milli>(Clock::now() - begin_time).count();
+	}
+}
+
+int main(int arguments_count, char** arguments)
+{
+	using namespace RoboPioneers::Benchmarks;
+
+	int cases_count = arguments_count > 1 ? std::stoi(arguments[1]) : 200;
+
+	std::printf("%-12s %12s %12s %12s\n", "Layout", "Grid ms", "Brute ms", "Mismatches");
+
+	int total_mismatches = 0;
+	const std::vector<std::pair<Layout, const char*>> layouts {
+		{Layout::Uniform, "Uniform"}, {Layout::Flat, "Flat"}, {Layout::Spread, "Spread"}};
+	for (const auto& [layout, name] : layouts)
+	{
+		std::mt19937 random(1);
+		std::vector<Case> cases;
+		for (int index = 0; index < cases_count; ++index) cases.push_back(Generate(random, layout));
+
+		//==============================
+		// 网格查询，同一点被访问两次也计为不一致
+		//==============================
+
+		SpatialGrid grid;
+		std::vector<std::vector<std::size_t>> grid_results;
+		auto grid_time = Measure([&](){
+			for (const auto& test_case : cases)
+			{
+				grid.Build(test_case.PointsX.data(), test_case.PointsY.data(), test_case.PointsX.size(),
+						test_case.CellSize);
+				for (const auto& query : test_case.Queries)
+				{
+					auto& found = grid_results.emplace_back();
+					grid.Query(query[0], query[1], query[2], [&found](std::size_t index){
+						found.push_back(index);
+					});
+				}
+			}
+		});
+
+		//==============================
+		// 逐点参照
+		//==============================
+
+		std::vector<std::vector<std::size_t>> brute_results;
+		auto brute_time = Measure([&](){
+			for (const auto& test_case : cases)
+			{
+				for (const auto& query : test_case.Queries) brute_results.push_back(BruteForce(test_case, query));
+			}
+		});
+
+		int mismatches = 0;
+		for (std::size_t index = 0; index < grid_results.size(); ++index)
+		{
+			std::sort(grid_results[index].begin(), grid_results[index].end());
+			if (grid_results[index] != brute_results[index]) ++mismatches;
+		}
+		total_mismatches += mismatches;
+
+		std::printf("%-12s %12.3f %12.3f %12d\n", name, grid_time, brute_time, mismatches);
+	}
+
+	return total_mismatches == 0 ? 0 : 1;
+}
@@ -20,6 +20,9 @@ namespace RoboPioneers::Prometheus
 		cv::imshow("Raw", frame.OriginalPicture) ;
 		#endif
 
+		// 需要在裁剪前取得整幅画面
+		Services.FullSearchUnit.Update(frame);
+
 		Services.PictureCuttingUnit.Update(frame);
 		Services.ColorPerceptionUnit.Update(frame);
 		Services.LightBarSearchingUnit.Update(frame);
@@ -27,6 +30,7 @@ namespace RoboPioneers::Prometheus
 
 		Services.BattleIntelligenceUnit.Update(frame);
 
+		Services.ClockSynchronizationUnit.Update(frame);
 		Services.TargetEncodeUnit.Update(frame);
 
 		#ifdef DEBUG
@@ -58,20 +62,40 @@ namespace RoboPioneers::Prometheus
 	/// 安装服务
 	void Controller::OnInstallServices()
 	{
-		Services.PictureCuttingUnit.Input.CuttingArea = &Services.BattleIntelligenceUnit.Output.InterestedArea;
+		Services.PictureCuttingUnit.Input.CuttingAreas = &Services.BattleIntelligenceUnit.Output.InterestedAreas;
 		Services.PictureCuttingUnit.Input.NeedToCut = &Services.BattleIntelligenceUnit.Output.Tracked;
 
 		Services.LightBarSearchingUnit.Input.BinaryPicture = &Services.ColorPerceptionUnit.Output.MaskPicture;
+		Services.LightBarSearchingUnit.Input.PackedBinaryPicture = &Services.ColorPerceptionUnit.Output.PackedMask;
 
-		Services.ArmorMatchingUnit.Input.PossibleEllipses = &Services.LightBarSearchingUnit.Output.PossibleEllipses;
-		Services.ArmorMatchingUnit.Input.PossibleRectangles = &Services.LightBarSearchingUnit.Output.PossibleRectangles;
+		Services.ArmorMatchingUnit.Input.LightBars = &Services.LightBarSearchingUnit.Output.LightBars;
 
+		Services.BattleIntelligenceUnit.Input.LightBars = &Services.LightBarSearchingUnit.Output.LightBars;
 		Services.BattleIntelligenceUnit.Input.PossibleArmors = &Services.ArmorMatchingUnit.Output.PossibleArmors;
+		Services.BattleIntelligenceUnit.Input.RoundTripTime = &Services.ClockSynchronizationUnit.Output.RoundTripTime;
+		Services.BattleIntelligenceUnit.Input.SearchDetections = &Services.FullSearchUnit.Output.Detections;
+		Services.BattleIntelligenceUnit.Input.SearchCaptureTime = &Services.FullSearchUnit.Output.CaptureTime;
+		Services.BattleIntelligenceUnit.Input.SearchUpdated = &Services.FullSearchUnit.Output.Updated;
+
+		Services.FullSearchUnit.Input.Tracking = &Services.BattleIntelligenceUnit.Output.Tracked;
+		Services.FullSearchUnit.Units.ColorPerceptionUnit.Settings = Services.ColorPerceptionUnit.Settings;
+		Services.FullSearchUnit.Units.LightBarSearchingUnit.Settings = Services.LightBarSearchingUnit.Settings;
+		Services.FullSearchUnit.Units.ArmorMatchingUnit.Settings = Services.ArmorMatchingUnit.Settings;
+		Services.FullSearchUnit.Settings.PreciseArmorRectangle = Services.BattleIntelligenceUnit.Settings.PreciseArmorRectangle;
+
+		Services.ClockSynchronizationUnit.Input.AimTime = &Services.BattleIntelligenceUnit.Output.AimTime;
 
 		Services.TargetEncodeUnit.Input.Command = &Services.BattleIntelligenceUnit.Output.Command;
 		Services.TargetEncodeUnit.Input.X = &Services.BattleIntelligenceUnit.Output.X;
 		Services.TargetEncodeUnit.Input.Y = &Services.BattleIntelligenceUnit.Output.Y;
 		Services.TargetEncodeUnit.Input.Number = &Services.BattleIntelligenceUnit.Output.Number;
+		Services.TargetEncodeUnit.Input.AimTime = &Services.ClockSynchronizationUnit.Output.AimTime;
+
+		if (InnerSettings.EnableSerialPort)
+		{
+			Services.ClockSynchronizationUnit.Input.Port = &InnerDevices.Port;
+			Services.ClockSynchronizationUnit.Start();
+		}
 
 		#ifdef DEBUG
 		Services.KeyTerminationUnit.Enable = true;
@@ -84,6 +108,9 @@ namespace RoboPioneers::Prometheus
 	/// 卸载服务
 	void Controller::OnUninstallServices()
 	{
-
+		// 接收线程需要在串口关闭前退出
+		Services.ClockSynchronizationUnit.Stop();
+		// 后台搜索使用采集器的画面，需要在采集器停止前结束
+		Services.FullSearchUnit.Stop();
 	}
 }
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include "Services/TargetEncodeService.hpp"
 #include "Services/KeyTerminationService.hpp"
 #include "Services/PictureCuttingService.hpp"
+#include "Services/ClockSynchronizationService.hpp"
+#include "Services/FullSearchService.hpp"
 
 namespace RoboPioneers::Prometheus
 {
@@ -37,10 +39,14 @@ namespace RoboPioneers::Prometheus
 			ArmorMatchingService ArmorMatchingUnit;
 			/// 战斗智能单元
 			BattleIntelligenceService BattleIntelligenceUnit;
+			/// 时钟同步单元
+			ClockSynchronizationService ClockSynchronizationUnit;
 			/// 目标数据包编码单元
 			TargetEncodeService TargetEncodeUnit;
 			/// 按键终止单元
 			KeyTerminationService KeyTerminationUnit;
+			/// 全图搜索单元，在后台搜索兴趣区域以外的目标
+			FullSearchService FullSearchUnit;
 		}Services;
 
 	protected:
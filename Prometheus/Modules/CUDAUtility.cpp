@@ -1,12 +1,25 @@
 #include "CUDAUtility.hpp"
 
+#ifndef NO_CUDA
 extern void CUDADeviceSynchronize();
+extern unsigned int CUDANonBlockingStreamFlags();
+#endif
 
 namespace RoboPioneers::Modules
 {
 	/// 同步设备对象
 	void CUDAUtility::SynchronizeDevice()
 	{
+		#ifndef NO_CUDA
 		CUDADeviceSynchronize();
+		#endif
 	}
+
+	#ifndef NO_CUDA
+	/// 创建不与默认流同步的CUDA流
+	cv::cuda::Stream CUDAUtility::CreateNonBlockingStream()
+	{
+		return cv::cuda::Stream(CUDANonBlockingStreamFlags());
+	}
+	#endif
 }
@@ -1,4 +1,9 @@
 void CUDADeviceSynchronize()
 {
 	cudaDeviceSynchronize();
+}
+
+unsigned int CUDANonBlockingStreamFlags()
+{
+	return cudaStreamNonBlocking;
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 
+#ifndef NO_CUDA
+#include <opencv4/opencv2/core/cuda.hpp>
+#endif
+
 namespace RoboPioneers::Modules
 {
 	/**
@@ -7,11 +11,23 @@ namespace RoboPioneers::Modules
 	 * @author Vincent
 	 * @details
 	 *  ~ 该模块提供了对CUDA简单常用的控制方法。
+	 *  ~ 定义NO_CUDA宏时，各方法不进行任何操作，调用者不需要区分构建方式。
 	 */
 	class CUDAUtility
 	{
 	public:
 		/// 同步设备
 		static void SynchronizeDevice();
+
+		#ifndef NO_CUDA
+		/**
+		 * @brief 创建不与默认流同步的CUDA流
+		 * @return CUDA流
+		 * @details
+		 *  ~ 默认构造的流与默认流相互等待，后台运算使用这类流时，主循环在默认流上的操作仍会等待后台的核函数。
+		 *  ~ 该方法创建的流与默认流互不等待，适用于后台运算；在其上读取的数据需要在提交运算前就绪。
+		 */
+		static cv::cuda::Stream CreateNonBlockingStream();
+		#endif
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,406 @@
+#include "ColorLookupTable.hpp"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#ifndef NO_CUDA
+/// 显存版本的查表，实现于ColorLookupTable.cu
+extern void CUDAColorLookup(const cv::cuda::PtrStepSzb& hsv_picture, cv::cuda::PtrStepSzb class_map,
+							cv::cuda::PtrStepSzb mask, const unsigned char* table,
+							int hue_bits, int saturation_bits, int value_bits, unsigned char class_bits, void* stream);
+#endif
+
+namespace RoboPioneers::Modules
+{
+	/// 文件标识
+	constexpr char FileMagic[4] {'C', 'L', 'U', 'T'};
+	/// 文件格式版本
+	constexpr unsigned char FileVersion = 1;
+	/// 文件头长度
+	constexpr std::size_t FileHeaderLength = 16;
+
+	//==============================
+	// 量化设定部分
+	//==============================
+
+	/// 判断量化设定是否相同
+	bool ColorLookupTable::Quantization::operator==(const Quantization &other) const
+	{
+		return HueBits == other.HueBits && SaturationBits == other.SaturationBits && ValueBits == other.ValueBits;
+	}
+
+	/// 判断量化设定是否不同
+	bool ColorLookupTable::Quantization::operator!=(const Quantization &other) const
+	{
+		return !(*this == other);
+	}
+
+	//==============================
+	// 构造函数部分
+	//==============================
+
+	/// 以默认量化设定构造
+	ColorLookupTable::ColorLookupTable() : ColorLookupTable(Quantization{})
+	{}
+
+	/// 以给定量化设定构造
+	ColorLookupTable::ColorLookupTable(const Quantization &quantization)
+	{
+		Reset(quantization);
+	}
+
+	//==============================
+	// 构建部分
+	//==============================
+
+	/// 重置查找表
+	void ColorLookupTable::Reset(const Quantization &quantization)
+	{
+		CheckQuantization(quantization);
+
+		QuantizationSource = quantization;
+		MappedTable.reset();
+		OwnedTable.assign(GetTableSize(), ClassBit::None);
+		Table = OwnedTable.data();
+		DeviceTableDirty = true;
+	}
+
+	/// 绘制颜色范围
+	void ColorLookupTable::Paint(const ColorThresholdModule::ColorRange &range, unsigned char class_bits)
+	{
+		unsigned char bounds[8];
+		ColorThresholdModule::GetBounds(range, bounds);
+
+		const int hue_shift = 8 - QuantizationSource.HueBits;
+		const int saturation_shift = 8 - QuantizationSource.SaturationBits;
+		const int value_shift = 8 - QuantizationSource.ValueBits;
+
+		std::size_t index = 0;
+		for (int hue_index = 0; hue_index < (1 << QuantizationSource.HueBits); ++hue_index)
+		{
+			// 以格子中心的颜色作为判定依据
+			const int hue = (hue_index << hue_shift) | ((1 << hue_shift) >> 1);
+			const bool hue_in_range = (hue >= bounds[0] && hue <= bounds[1]) || (hue >= bounds[2] && hue <= bounds[3]);
+
+			for (int saturation_index = 0; saturation_index < (1 << QuantizationSource.SaturationBits); ++saturation_index)
+			{
+				const int saturation = (saturation_index << saturation_shift) | ((1 << saturation_shift) >> 1);
+				const bool saturation_in_range = saturation >= bounds[4] && saturation <= bounds[5];
+
+				for (int value_index = 0; value_index < (1 << QuantizationSource.ValueBits); ++value_index, ++index)
+				{
+					const int value = (value_index << value_shift) | ((1 << value_shift) >> 1);
+
+					if (hue_in_range && saturation_in_range && value >= bounds[6] && value <= bounds[7])
+					{
+						Table[index] |= class_bits;
+					}
+				}
+			}
+		}
+
+		DeviceTableDirty = true;
+	}
+
+	/// 训练查找表
+	void ColorLookupTable::Train(const cv::Mat &hsv_pixels, const cv::Mat &labels)
+	{
+		if (hsv_pixels.type() != CV_8UC3 || labels.type() != CV_8UC1 || hsv_pixels.size() != labels.size())
+		{
+			throw std::logic_error("ColorLookupTable::Train Pixels And Labels Do Not Match.");
+		}
+
+		// 每个格子的样本总数与8个类别位各自的计数
+		std::unordered_map<std::size_t, std::array<unsigned int, 9>> statistics;
+
+		for (int y = 0; y < hsv_pixels.rows; ++y)
+		{
+			const auto* pixels = hsv_pixels.ptr<unsigned char>(y);
+			const auto* label_row = labels.ptr<unsigned char>(y);
+
+			for (int x = 0; x < hsv_pixels.cols; ++x)
+			{
+				auto& counters = statistics[GetIndex(pixels[3 * x], pixels[3 * x + 1], pixels[3 * x + 2])];
+				++counters[8];
+				for (int bit = 0; bit < 8; ++bit)
+				{
+					if (label_row[x] & (1u << bit)) ++counters[bit];
+				}
+			}
+		}
+
+		for (const auto& [index, counters] : statistics)
+		{
+			unsigned char class_bits = ClassBit::None;
+			for (int bit = 0; bit < 8; ++bit)
+			{
+				if (counters[bit] * 2 > counters[8])
+				{
+					class_bits |= static_cast<unsigned char>(1u << bit);
+				}
+			}
+			Table[index] = class_bits;
+		}
+
+		DeviceTableDirty = true;
+	}
+
+	//==============================
+	// 持久化部分
+	//==============================
+
+	/// 保存查找表
+	void ColorLookupTable::Save(const std::string &path) const
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			throw std::runtime_error("ColorLookupTable::Save Failed to Open File " + path + ".");
+		}
+
+		char header[FileHeaderLength] {};
+		std::memcpy(header, FileMagic, sizeof(FileMagic));
+		header[4] = static_cast<char>(FileVersion);
+		header[5] = static_cast<char>(QuantizationSource.HueBits);
+		header[6] = static_cast<char>(QuantizationSource.SaturationBits);
+		header[7] = static_cast<char>(QuantizationSource.ValueBits);
+
+		file.write(header, FileHeaderLength);
+		file.write(reinterpret_cast<const char*>(Table), static_cast<std::streamsize>(GetTableSize()));
+
+		if (!file)
+		{
+			throw std::runtime_error("ColorLookupTable::Save Failed to Write File " + path + ".");
+		}
+	}
+
+	/// 加载查找表
+	void ColorLookupTable::Load(const std::string &path)
+	{
+		using namespace boost::interprocess;
+
+		std::shared_ptr<mapped_region> region;
+		try
+		{
+			file_mapping file(path.c_str(), read_only);
+			// 写时复制映射，允许在加载后继续绘制或训练而不修改文件
+			region = std::make_shared<mapped_region>(file, copy_on_write);
+		}
+		catch (interprocess_exception& error)
+		{
+			throw std::runtime_error("ColorLookupTable::Load Failed to Map File " + path + ": " + error.what());
+		}
+
+		const auto* header = static_cast<const unsigned char*>(region->get_address());
+		if (region->get_size() < FileHeaderLength || std::memcmp(header, FileMagic, sizeof(FileMagic)) != 0 ||
+			header[4] != FileVersion)
+		{
+			throw std::runtime_error("ColorLookupTable::Load Invalid File " + path + ".");
+		}
+
+		Quantization quantization;
+		quantization.HueBits = header[5];
+		quantization.SaturationBits = header[6];
+		quantization.ValueBits = header[7];
+		CheckQuantization(quantization);
+
+		const std::size_t table_size = std::size_t{1} << static_cast<unsigned>(
+				quantization.HueBits + quantization.SaturationBits + quantization.ValueBits);
+		if (region->get_size() < FileHeaderLength + table_size)
+		{
+			throw std::runtime_error("ColorLookupTable::Load Truncated File " + path + ".");
+		}
+
+		QuantizationSource = quantization;
+		MappedTable = std::move(region);
+		OwnedTable.clear();
+		OwnedTable.shrink_to_fit();
+		Table = static_cast<unsigned char*>(MappedTable->get_address()) + FileHeaderLength;
+		DeviceTableDirty = true;
+	}
+
+	//==============================
+	// 查询部分
+	//==============================
+
+	/// 查询颜色
+	unsigned char ColorLookupTable::Lookup(unsigned char hue, unsigned char saturation, unsigned char value) const
+	{
+		return Table[GetIndex(hue, saturation, value)];
+	}
+
+	/// 内存分类
+	void ColorLookupTable::Classify(const cv::Mat &hsv_picture, cv::Mat &class_map) const
+	{
+		Apply(hsv_picture, &class_map, nullptr, ClassBit::None);
+	}
+
+	#ifndef NO_CUDA
+	/// 显存分类
+	void ColorLookupTable::Classify(const cv::cuda::GpuMat &hsv_picture, cv::cuda::GpuMat &class_map,
+								 cv::cuda::Stream &stream) const
+	{
+		Apply(hsv_picture, &class_map, nullptr, ClassBit::None, stream);
+	}
+	#endif
+
+	/// 内存阈值处理
+	void ColorLookupTable::Threshold(const cv::Mat &hsv_picture, cv::Mat &mask, unsigned char class_bits) const
+	{
+		if (class_bits == ClassBit::None)
+		{
+			throw std::logic_error("ColorLookupTable::Threshold Class Bits Must Not Be Empty.");
+		}
+		Apply(hsv_picture, nullptr, &mask, class_bits);
+	}
+
+	/// 内存分类与阈值处理
+	void ColorLookupTable::ClassifyAndThreshold(const cv::Mat &hsv_picture, cv::Mat &class_map, cv::Mat &mask,
+											 unsigned char class_bits) const
+	{
+		if (class_bits == ClassBit::None)
+		{
+			throw std::logic_error("ColorLookupTable::ClassifyAndThreshold Class Bits Must Not Be Empty.");
+		}
+		Apply(hsv_picture, &class_map, &mask, class_bits);
+	}
+
+	#ifndef NO_CUDA
+	/// 显存阈值处理
+	void ColorLookupTable::Threshold(const cv::cuda::GpuMat &hsv_picture, cv::cuda::GpuMat &mask,
+								  unsigned char class_bits, cv::cuda::Stream &stream) const
+	{
+		if (class_bits == ClassBit::None)
+		{
+			throw std::logic_error("ColorLookupTable::Threshold Class Bits Must Not Be Empty.");
+		}
+		Apply(hsv_picture, nullptr, &mask, class_bits, stream);
+	}
+
+	/// 显存分类与阈值处理
+	void ColorLookupTable::ClassifyAndThreshold(const cv::cuda::GpuMat &hsv_picture, cv::cuda::GpuMat &class_map,
+											 cv::cuda::GpuMat &mask, unsigned char class_bits,
+											 cv::cuda::Stream &stream) const
+	{
+		if (class_bits == ClassBit::None)
+		{
+			throw std::logic_error("ColorLookupTable::ClassifyAndThreshold Class Bits Must Not Be Empty.");
+		}
+		Apply(hsv_picture, &class_map, &mask, class_bits, stream);
+	}
+	#endif
+
+	//==============================
+	// 内部方法部分
+	//==============================
+
+	/// 获取表项数量
+	std::size_t ColorLookupTable::GetTableSize() const
+	{
+		return std::size_t{1} << static_cast<unsigned>(
+				QuantizationSource.HueBits + QuantizationSource.SaturationBits + QuantizationSource.ValueBits);
+	}
+
+	/// 获取表项下标
+	std::size_t ColorLookupTable::GetIndex(unsigned char hue, unsigned char saturation, unsigned char value) const
+	{
+		return (static_cast<std::size_t>(hue >> (8 - QuantizationSource.HueBits))
+					<< (QuantizationSource.SaturationBits + QuantizationSource.ValueBits)) |
+			   (static_cast<std::size_t>(saturation >> (8 - QuantizationSource.SaturationBits))
+					<< QuantizationSource.ValueBits) |
+			   static_cast<std::size_t>(value >> (8 - QuantizationSource.ValueBits));
+	}
+
+	/// 内存查表
+	void ColorLookupTable::Apply(const cv::Mat &hsv_picture, cv::Mat *class_map, cv::Mat *mask,
+							  unsigned char class_bits) const
+	{
+		if (hsv_picture.type() != CV_8UC3)
+		{
+			throw std::logic_error("ColorLookupTable::Apply HSV Picture Must Be CV_8UC3.");
+		}
+
+		if (class_map) class_map->create(hsv_picture.size(), CV_8UC1);
+		if (mask) mask->create(hsv_picture.size(), CV_8UC1);
+
+		const int hue_shift = 8 - QuantizationSource.HueBits;
+		const int saturation_shift = 8 - QuantizationSource.SaturationBits;
+		const int value_shift = 8 - QuantizationSource.ValueBits;
+		const int hue_position = QuantizationSource.SaturationBits + QuantizationSource.ValueBits;
+		const int saturation_position = QuantizationSource.ValueBits;
+		const unsigned char* table = Table;
+
+		cv::parallel_for_(cv::Range(0, hsv_picture.rows), [&, table, class_bits](const cv::Range& rows){
+			for (int y = rows.start; y < rows.end; ++y)
+			{
+				const unsigned char* source = hsv_picture.ptr<unsigned char>(y);
+				unsigned char* class_target = class_map ? class_map->ptr<unsigned char>(y) : nullptr;
+				unsigned char* mask_target = mask ? mask->ptr<unsigned char>(y) : nullptr;
+
+				for (int x = 0; x < hsv_picture.cols; ++x, source += 3)
+				{
+					const unsigned int index = (static_cast<unsigned int>(source[0] >> hue_shift) << hue_position) |
+							(static_cast<unsigned int>(source[1] >> saturation_shift) << saturation_position) |
+							static_cast<unsigned int>(source[2] >> value_shift);
+					const unsigned char classes = table[index];
+
+					if (class_target) class_target[x] = classes;
+					if (mask_target) mask_target[x] = (classes & class_bits) ? 255 : 0;
+				}
+			}
+		});
+	}
+
+	#ifndef NO_CUDA
+	/// 显存查表
+	void ColorLookupTable::Apply(const cv::cuda::GpuMat &hsv_picture, cv::cuda::GpuMat *class_map,
+							  cv::cuda::GpuMat *mask, unsigned char class_bits, cv::cuda::Stream &stream) const
+	{
+		if (hsv_picture.type() != CV_8UC3)
+		{
+			throw std::logic_error("ColorLookupTable::Apply HSV Picture Must Be CV_8UC3.");
+		}
+
+		if (DeviceTableDirty)
+		{
+			DeviceTable.upload(cv::Mat(1, static_cast<int>(GetTableSize()), CV_8UC1, Table), stream);
+			DeviceTableDirty = false;
+		}
+
+		// 不需要的输出以空指针传入核函数
+		cv::cuda::PtrStepSzb class_map_pointer, mask_pointer;
+		if (class_map)
+		{
+			class_map->create(hsv_picture.size(), CV_8UC1);
+			class_map_pointer = *class_map;
+		}
+		if (mask)
+		{
+			mask->create(hsv_picture.size(), CV_8UC1);
+			mask_pointer = *mask;
+		}
+
+		CUDAColorLookup(hsv_picture, class_map_pointer, mask_pointer, DeviceTable.ptr<unsigned char>(),
+				  QuantizationSource.HueBits, QuantizationSource.SaturationBits, QuantizationSource.ValueBits,
+				  class_bits, stream.cudaPtr());
+	}
+	#endif
+
+	/// 检查量化设定
+	void ColorLookupTable::CheckQuantization(const Quantization &quantization)
+	{
+		for (int bits : {quantization.HueBits, quantization.SaturationBits, quantization.ValueBits})
+		{
+			if (bits < 1 || bits > 8)
+			{
+				throw std::logic_error("ColorLookupTable::CheckQuantization Bits Must Be in [1, 8].");
+			}
+		}
+	}
+}
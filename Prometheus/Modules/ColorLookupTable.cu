@@ -0,0 +1,39 @@
+#include <opencv4/opencv2/core/cuda_types.hpp>
+
+/// 查表核函数，每个线程处理一个像素
+__global__ void ColorLookupKernel(const cv::cuda::PtrStepSzb hsv_picture,
+								  cv::cuda::PtrStepb class_map, cv::cuda::PtrStepb mask,
+								  const unsigned char* __restrict__ table,
+								  int hue_shift, int saturation_shift, int value_shift,
+								  int hue_position, int saturation_position, unsigned char class_bits)
+{
+	const int x = blockIdx.x * blockDim.x + threadIdx.x;
+	const int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+	if (x >= hsv_picture.cols || y >= hsv_picture.rows) return;
+
+	const unsigned char* pixel = hsv_picture.ptr(y) + 3 * x;
+	const unsigned int index = (static_cast<unsigned int>(pixel[0] >> hue_shift) << hue_position) |
+			(static_cast<unsigned int>(pixel[1] >> saturation_shift) << saturation_position) |
+			static_cast<unsigned int>(pixel[2] >> value_shift);
+
+	// 表只读且被所有线程共享，经由只读缓存读取
+	const unsigned char classes = __ldg(table + index);
+
+	// 输出是否为空对整个网格一致，不会造成线程束分化
+	if (class_map.data) class_map.ptr(y)[x] = classes;
+	if (mask.data) mask.ptr(y)[x] = (classes & class_bits) ? 255 : 0;
+}
+
+/// 显存版本的查表
+void CUDAColorLookup(const cv::cuda::PtrStepSzb& hsv_picture, cv::cuda::PtrStepSzb class_map,
+					 cv::cuda::PtrStepSzb mask, const unsigned char* table,
+					 int hue_bits, int saturation_bits, int value_bits, unsigned char class_bits, void* stream)
+{
+	const dim3 block(32, 8);
+	const dim3 grid((hsv_picture.cols + block.x - 1) / block.x, (hsv_picture.rows + block.y - 1) / block.y);
+
+	ColorLookupKernel<<<grid, block, 0, static_cast<cudaStream_t>(stream)>>>(
+			hsv_picture, class_map, mask, table, 8 - hue_bits, 8 - saturation_bits, 8 - value_bits,
+			saturation_bits + value_bits, value_bits, class_bits);
+}
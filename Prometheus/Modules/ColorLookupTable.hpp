@@ -0,0 +1,254 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <opencv4/opencv2/opencv.hpp>
+
+#include "ColorThresholdModule.hpp"
+
+namespace boost::interprocess
+{
+	class mapped_region;
+}
+
+namespace RoboPioneers::Modules
+{
+	/**
+	 * @brief 颜色查找表
+	 * @author Vincent
+	 * @details
+	 *  ~ 该类将量化后的HSV颜色映射到类别位掩码，每个像素只需一次查表即可完成分类。
+	 *  ~ 每个通道保留高若干位作为索引，表项为类别位掩码，一种颜色可以同时属于多个类别。
+	 *  ~ 表可以由颜色范围绘制，也可以由标注像素训练得到任意形状的类别区域。
+	 *  ~ 表可以保存为文件，并以内存映射的方式加载，加载时不复制表数据。
+	 */
+	class ColorLookupTable
+	{
+	public:
+		/// 类别位
+		enum ClassBit : unsigned char
+		{
+			/// 不属于任何类别
+			None = 0x00,
+			/// 红色目标
+			Red = 0x01,
+			/// 蓝色目标
+			Blue = 0x02
+		};
+
+		/**
+		 * @brief 量化设定
+		 * @details
+		 *  ~ 各通道保留的位数，范围为1~8，8位时查找表与阈值判定逐位一致。
+		 *  ~ 默认各6位，表大小为256KB，可以常驻二级缓存。
+		 */
+		struct Quantization
+		{
+			/// 色调位数
+			int HueBits {6};
+			/// 饱和度位数
+			int SaturationBits {6};
+			/// 亮度位数
+			int ValueBits {6};
+
+			/// 判断量化设定是否相同
+			bool operator==(const Quantization& other) const;
+			/// 判断量化设定是否不同
+			bool operator!=(const Quantization& other) const;
+		};
+
+	private:
+		/// 量化设定
+		Quantization QuantizationSource;
+
+		/// 自有的表数据
+		std::vector<unsigned char> OwnedTable;
+		/// 映射自文件的表数据，以写时复制方式映射，修改不会写回文件
+		std::shared_ptr<boost::interprocess::mapped_region> MappedTable;
+		/// 当前使用的表数据
+		unsigned char* Table {nullptr};
+
+		#ifndef NO_CUDA
+		/// 显存中的表数据
+		mutable cv::cuda::GpuMat DeviceTable;
+		#endif
+		/// 显存中的表数据是否需要更新
+		mutable bool DeviceTableDirty {true};
+
+	public:
+		//==============================
+		// 构造函数部分
+		//==============================
+
+		/// 构造函数，将以默认量化设定创建空表
+		ColorLookupTable();
+
+		/**
+		 * @brief 构造函数
+		 * @param quantization 量化设定
+		 */
+		explicit ColorLookupTable(const Quantization& quantization);
+
+		/// 查找表持有对自身成员的引用，禁止复制
+		ColorLookupTable(const ColorLookupTable&) = delete;
+		/// 查找表持有对自身成员的引用，禁止复制
+		ColorLookupTable& operator=(const ColorLookupTable&) = delete;
+
+		/// 量化设定
+		const Quantization& QuantizationSettings {QuantizationSource};
+
+		//==============================
+		// 构建部分
+		//==============================
+
+		/**
+		 * @brief 重置查找表
+		 * @param quantization 量化设定
+		 * @details
+		 *  ~ 将按量化设定重新分配表，所有表项被设置为None。
+		 */
+		void Reset(const Quantization& quantization);
+
+		/**
+		 * @brief 将颜色范围绘制到查找表中
+		 * @param range 颜色范围
+		 * @param class_bits 类别位，将被按位或到范围内的表项上
+		 * @details
+		 *  ~ 以量化格子的中心颜色判定格子是否在范围内。
+		 */
+		void Paint(const ColorThresholdModule::ColorRange& range, unsigned char class_bits);
+
+		/**
+		 * @brief 由标注像素训练查找表
+		 * @param hsv_pixels HSV像素，CV_8UC3
+		 * @param labels 标注，CV_8UC1，与像素一一对应，值为该像素所属的类别位掩码
+		 * @details
+		 *  ~ 对于每个出现过样本的格子，若某个类别位在超过一半的样本中被设置，则格子具有该类别位。
+		 *  ~ 没有样本的格子保持原值，因此可以先绘制颜色范围，再用样本修正。
+		 */
+		void Train(const cv::Mat& hsv_pixels, const cv::Mat& labels);
+
+		//==============================
+		// 持久化部分
+		//==============================
+
+		/**
+		 * @brief 保存查找表
+		 * @param path 文件路径
+		 * @details
+		 *  ~ 文件由16字节的文件头与表数据组成，可以被直接映射。
+		 */
+		void Save(const std::string& path) const;
+
+		/**
+		 * @brief 加载查找表
+		 * @param path 文件路径
+		 * @details
+		 *  ~ 文件将被映射到内存中，表数据不会被复制。
+		 */
+		void Load(const std::string& path);
+
+		//==============================
+		// 查询部分
+		//==============================
+
+		/**
+		 * @brief 查询颜色的类别
+		 * @param hue 色调
+		 * @param saturation 饱和度
+		 * @param value 亮度
+		 * @return 类别位掩码
+		 */
+		[[nodiscard]] unsigned char Lookup(unsigned char hue, unsigned char saturation, unsigned char value) const;
+
+		/**
+		 * @brief 对内存中的HSV图像进行分类
+		 * @param hsv_picture HSV图像，CV_8UC3，允许非连续
+		 * @param class_map 输出类别图，CV_8UC1，值为类别位掩码；尺寸不符时才会重新分配
+		 */
+		void Classify(const cv::Mat& hsv_picture, cv::Mat& class_map) const;
+
+		#ifndef NO_CUDA
+		/**
+		 * @brief 对显存中的HSV图像进行分类
+		 * @param hsv_picture HSV图像，CV_8UC3，允许非连续
+		 * @param class_map 输出类别图，CV_8UC1，值为类别位掩码；尺寸不符时才会重新分配
+		 * @param stream CUDA流，调用结束时核函数可能尚未完成
+		 */
+		void Classify(const cv::cuda::GpuMat& hsv_picture, cv::cuda::GpuMat& class_map,
+				cv::cuda::Stream& stream = cv::cuda::Stream::Null()) const;
+		#endif
+
+		/**
+		 * @brief 对内存中的HSV图像进行阈值处理
+		 * @param hsv_picture HSV图像，CV_8UC3，允许非连续
+		 * @param mask 输出蒙版，CV_8UC1，类别与给定类别位相交时为255，否则为0
+		 * @param class_bits 目标类别位
+		 */
+		void Threshold(const cv::Mat& hsv_picture, cv::Mat& mask, unsigned char class_bits) const;
+
+		#ifndef NO_CUDA
+		/**
+		 * @brief 对显存中的HSV图像进行阈值处理
+		 * @param hsv_picture HSV图像，CV_8UC3，允许非连续
+		 * @param mask 输出蒙版，CV_8UC1，类别与给定类别位相交时为255，否则为0
+		 * @param class_bits 目标类别位
+		 * @param stream CUDA流，调用结束时核函数可能尚未完成
+		 */
+		void Threshold(const cv::cuda::GpuMat& hsv_picture, cv::cuda::GpuMat& mask, unsigned char class_bits,
+				 cv::cuda::Stream& stream = cv::cuda::Stream::Null()) const;
+		#endif
+
+		/**
+		 * @brief 对内存中的HSV图像同时进行分类与阈值处理
+		 * @param hsv_picture HSV图像，CV_8UC3，允许非连续
+		 * @param class_map 输出类别图，CV_8UC1，值为类别位掩码
+		 * @param mask 输出蒙版，CV_8UC1，类别与给定类别位相交时为255，否则为0
+		 * @param class_bits 目标类别位
+		 * @details
+		 *  ~ 每个像素只读取与查表一次，同时写出两张图像。
+		 */
+		void ClassifyAndThreshold(const cv::Mat& hsv_picture, cv::Mat& class_map, cv::Mat& mask,
+							unsigned char class_bits) const;
+
+		#ifndef NO_CUDA
+		/**
+		 * @brief 对显存中的HSV图像同时进行分类与阈值处理
+		 * @param hsv_picture HSV图像，CV_8UC3，允许非连续
+		 * @param class_map 输出类别图，CV_8UC1，值为类别位掩码
+		 * @param mask 输出蒙版，CV_8UC1，类别与给定类别位相交时为255，否则为0
+		 * @param class_bits 目标类别位
+		 * @param stream CUDA流，调用结束时核函数可能尚未完成
+		 */
+		void ClassifyAndThreshold(const cv::cuda::GpuMat& hsv_picture, cv::cuda::GpuMat& class_map,
+							cv::cuda::GpuMat& mask, unsigned char class_bits,
+							cv::cuda::Stream& stream = cv::cuda::Stream::Null()) const;
+		#endif
+
+	protected:
+		/// 获取表项数量
+		[[nodiscard]] std::size_t GetTableSize() const;
+
+		/// 获取颜色对应的表项下标
+		[[nodiscard]] std::size_t GetIndex(unsigned char hue, unsigned char saturation, unsigned char value) const;
+
+		/**
+		 * @brief 查表并写出结果
+		 * @param hsv_picture HSV图像
+		 * @param class_map 输出类别图，为空指针时不输出
+		 * @param mask 输出蒙版，为空指针时不输出
+		 * @param class_bits 蒙版的目标类别位
+		 */
+		void Apply(const cv::Mat& hsv_picture, cv::Mat* class_map, cv::Mat* mask, unsigned char class_bits) const;
+
+		#ifndef NO_CUDA
+		/// 显存版本的查表
+		void Apply(const cv::cuda::GpuMat& hsv_picture, cv::cuda::GpuMat* class_map, cv::cuda::GpuMat* mask,
+			 unsigned char class_bits, cv::cuda::Stream& stream) const;
+		#endif
+
+		/// 检查量化设定是否合法
+		static void CheckQuantization(const Quantization& quantization);
+	};
+}
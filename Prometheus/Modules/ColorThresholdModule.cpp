@@ -0,0 +1,126 @@
+#include "ColorThresholdModule.hpp"
+
+#include <stdexcept>
+#include <opencv4/opencv2/core/hal/intrin.hpp>
+
+#ifndef NO_CUDA
+/// 显存版本的阈值处理，实现于ColorThresholdModule.cu
+extern void CUDAColorThreshold(const cv::cuda::PtrStepSzb& hsv_picture, cv::cuda::PtrStepSzb mask,
+							   const unsigned char* bounds, void* stream);
+#endif
+
+namespace RoboPioneers::Modules
+{
+	/// 获取大于阈值的区间
+	auto ColorThresholdModule::GreaterThan(int threshold) -> Interval
+	{
+		return Interval{threshold + 1, 255};
+	}
+
+	/// 获取不大于阈值的区间
+	auto ColorThresholdModule::NotGreaterThan(int threshold) -> Interval
+	{
+		return Interval{0, threshold};
+	}
+
+	/// 转换为边界表
+	void ColorThresholdModule::GetBounds(const ColorRange &range, unsigned char bounds[8])
+	{
+		const Interval* intervals[4] {
+			&range.HueIntervals[0], &range.HueIntervals[1], &range.SaturationInterval, &range.ValueInterval
+		};
+
+		for (int index = 0; index < 4; ++index)
+		{
+			int lower = std::max(intervals[index]->Lower, 0);
+			int upper = std::min(intervals[index]->Upper, 255);
+
+			if (lower > upper)
+			{
+				// 空区间，任何8位值都无法同时满足 >=255 且 <=0
+				lower = 255;
+				upper = 0;
+			}
+			bounds[index * 2] = static_cast<unsigned char>(lower);
+			bounds[index * 2 + 1] = static_cast<unsigned char>(upper);
+		}
+	}
+
+	/// 对内存中的HSV图像进行阈值处理
+	void ColorThresholdModule::Threshold(const cv::Mat &hsv_picture, cv::Mat &mask, const ColorRange &range)
+	{
+		if (hsv_picture.type() != CV_8UC3)
+		{
+			throw std::logic_error("ColorThresholdModule::Threshold HSV Picture Must Be CV_8UC3.");
+		}
+
+		mask.create(hsv_picture.size(), CV_8UC1);
+
+		unsigned char bounds[8];
+		GetBounds(range, bounds);
+
+		cv::parallel_for_(cv::Range(0, hsv_picture.rows), [&hsv_picture, &mask, &bounds](const cv::Range& rows){
+			for (int y = rows.start; y < rows.end; ++y)
+			{
+				const unsigned char* source = hsv_picture.ptr<unsigned char>(y);
+				unsigned char* target = mask.ptr<unsigned char>(y);
+				int x = 0;
+
+				#if (CV_SIMD || CV_SIMD_SCALABLE)
+				const cv::v_uint8 hue1_lower = cv::vx_setall_u8(bounds[0]), hue1_upper = cv::vx_setall_u8(bounds[1]);
+				const cv::v_uint8 hue2_lower = cv::vx_setall_u8(bounds[2]), hue2_upper = cv::vx_setall_u8(bounds[3]);
+				const cv::v_uint8 saturation_lower = cv::vx_setall_u8(bounds[4]), saturation_upper = cv::vx_setall_u8(bounds[5]);
+				const cv::v_uint8 value_lower = cv::vx_setall_u8(bounds[6]), value_upper = cv::vx_setall_u8(bounds[7]);
+
+				const int lanes = cv::VTraits<cv::v_uint8>::vlanes();
+				for (; x <= hsv_picture.cols - lanes; x += lanes)
+				{
+					cv::v_uint8 hue, saturation, value;
+					cv::v_load_deinterleave(source + 3 * x, hue, saturation, value);
+
+					// 比较结果的每个通道为0x00或0xFF，可直接作为蒙版写出
+					cv::v_uint8 result = cv::v_or(
+							cv::v_and(cv::v_ge(hue, hue1_lower), cv::v_le(hue, hue1_upper)),
+							cv::v_and(cv::v_ge(hue, hue2_lower), cv::v_le(hue, hue2_upper)));
+					result = cv::v_and(result,
+							cv::v_and(cv::v_ge(saturation, saturation_lower), cv::v_le(saturation, saturation_upper)));
+					result = cv::v_and(result, cv::v_and(cv::v_ge(value, value_lower), cv::v_le(value, value_upper)));
+
+					cv::v_store(target + x, result);
+				}
+				#endif
+
+				for (; x < hsv_picture.cols; ++x)
+				{
+					const unsigned char hue = source[3 * x];
+					const unsigned char saturation = source[3 * x + 1];
+					const unsigned char value = source[3 * x + 2];
+
+					bool in_range = ((hue >= bounds[0] && hue <= bounds[1]) || (hue >= bounds[2] && hue <= bounds[3])) &&
+							saturation >= bounds[4] && saturation <= bounds[5] &&
+							value >= bounds[6] && value <= bounds[7];
+					target[x] = in_range ? 255 : 0;
+				}
+			}
+		});
+	}
+
+	#ifndef NO_CUDA
+	/// 对显存中的HSV图像进行阈值处理
+	void ColorThresholdModule::Threshold(const cv::cuda::GpuMat &hsv_picture, cv::cuda::GpuMat &mask,
+									  const ColorRange &range, cv::cuda::Stream &stream)
+	{
+		if (hsv_picture.type() != CV_8UC3)
+		{
+			throw std::logic_error("ColorThresholdModule::Threshold HSV Picture Must Be CV_8UC3.");
+		}
+
+		mask.create(hsv_picture.size(), CV_8UC1);
+
+		unsigned char bounds[8];
+		GetBounds(range, bounds);
+
+		CUDAColorThreshold(hsv_picture, mask, bounds, stream.cudaPtr());
+	}
+	#endif
+}
@@ -0,0 +1,48 @@
+#include <opencv4/opencv2/core/cuda_types.hpp>
+
+/// 颜色边界，作为核函数参数按值传递
+struct ColorBounds
+{
+	/// 依次为两段色调、饱和度、亮度的下界与上界
+	unsigned char Values[8];
+};
+
+/// 判断值是否在闭区间内
+__device__ __forceinline__ bool InBounds(unsigned char value, unsigned char lower, unsigned char upper)
+{
+	return value >= lower && value <= upper;
+}
+
+/// 单趟颜色阈值核函数，每个线程处理一个像素
+__global__ void ColorThresholdKernel(const cv::cuda::PtrStepSzb hsv_picture, cv::cuda::PtrStepb mask,
+									 const ColorBounds bounds)
+{
+	const int x = blockIdx.x * blockDim.x + threadIdx.x;
+	const int y = blockIdx.y * blockDim.y + threadIdx.y;
+
+	if (x >= hsv_picture.cols || y >= hsv_picture.rows) return;
+
+	const unsigned char* pixel = hsv_picture.ptr(y) + 3 * x;
+	const unsigned char* values = bounds.Values;
+
+	const bool in_range = (InBounds(pixel[0], values[0], values[1]) || InBounds(pixel[0], values[2], values[3])) &&
+			InBounds(pixel[1], values[4], values[5]) && InBounds(pixel[2], values[6], values[7]);
+
+	mask.ptr(y)[x] = in_range ? 255 : 0;
+}
+
+/// 显存版本的阈值处理
+void CUDAColorThreshold(const cv::cuda::PtrStepSzb& hsv_picture, cv::cuda::PtrStepSzb mask,
+						const unsigned char* bounds, void* stream)
+{
+	ColorBounds parameters {};
+	for (int index = 0; index < 8; ++index)
+	{
+		parameters.Values[index] = bounds[index];
+	}
+
+	const dim3 block(32, 8);
+	const dim3 grid((hsv_picture.cols + block.x - 1) / block.x, (hsv_picture.rows + block.y - 1) / block.y);
+
+	ColorThresholdKernel<<<grid, block, 0, static_cast<cudaStream_t>(stream)>>>(hsv_picture, mask, parameters);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <opencv4/opencv2/opencv.hpp>
+
+namespace RoboPioneers::Modules
+{
+	/**
+	 * @brief 颜色阈值模块
+	 * @author Vincent
+	 * @details
+	 *  ~ 该模块提供单趟的HSV阈值处理方法，读取一次HSV图像并直接写出蒙版。
+	 *  ~ 内存版本使用OpenCV的通用SIMD指令并按行并行，显存版本使用单个CUDA核函数。
+	 *  ~ 两个版本对同一颜色范围的输出逐位一致。
+	 */
+	class ColorThresholdModule
+	{
+	public:
+		/**
+		 * @brief 闭区间
+		 * @details
+		 *  ~ 下界大于上界时表示空区间。
+		 */
+		struct Interval
+		{
+			/// 下界
+			int Lower {0};
+			/// 上界
+			int Upper {255};
+		};
+
+		/**
+		 * @brief 颜色范围
+		 * @details
+		 *  ~ 像素在范围内，当且仅当色调落在两段色调区间之一，且饱和度和亮度均落在各自的区间内。
+		 *  ~ 色调使用两段区间是为了处理红色跨越色环起点的情况。
+		 */
+		struct ColorRange
+		{
+			/// 色调区间，两段取并集，默认第二段为空
+			Interval HueIntervals[2] {{0, 255}, {1, 0}};
+			/// 饱和度区间
+			Interval SaturationInterval {0, 255};
+			/// 亮度区间
+			Interval ValueInterval {0, 255};
+		};
+
+		/**
+		 * @brief 获取大于阈值的区间
+		 * @param threshold 阈值
+		 * @return 与cv::THRESH_BINARY的判定一致的区间，即(threshold, 255]
+		 */
+		static Interval GreaterThan(int threshold);
+
+		/**
+		 * @brief 获取不大于阈值的区间
+		 * @param threshold 阈值
+		 * @return 与cv::THRESH_BINARY_INV的判定一致的区间，即[0, threshold]
+		 */
+		static Interval NotGreaterThan(int threshold);
+
+		/**
+		 * @brief 对内存中的HSV图像进行阈值处理
+		 * @param hsv_picture HSV图像，CV_8UC3，允许非连续
+		 * @param mask 输出蒙版，CV_8UC1，范围内为255，否则为0；尺寸不符时才会重新分配
+		 * @param range 颜色范围
+		 */
+		static void Threshold(const cv::Mat& hsv_picture, cv::Mat& mask, const ColorRange& range);
+
+		#ifndef NO_CUDA
+		/**
+		 * @brief 对显存中的HSV图像进行阈值处理
+		 * @param hsv_picture HSV图像，CV_8UC3，允许非连续
+		 * @param mask 输出蒙版，CV_8UC1，范围内为255，否则为0；尺寸不符时才会重新分配
+		 * @param range 颜色范围
+		 * @param stream CUDA流，调用结束时核函数可能尚未完成
+		 */
+		static void Threshold(const cv::cuda::GpuMat& hsv_picture, cv::cuda::GpuMat& mask, const ColorRange& range,
+						cv::cuda::Stream& stream = cv::cuda::Stream::Null());
+		#endif
+
+		/**
+		 * @brief 将颜色范围转换为8个字节的边界表
+		 * @param range 颜色范围
+		 * @param bounds 输出，依次为两段色调、饱和度、亮度的下界与上界
+		 * @details
+		 *  ~ 区间会被限制在[0, 255]内，空区间被表示为[255, 0]。
+		 */
+		static void GetBounds(const ColorRange& range, unsigned char bounds[8]);
+	};
+}
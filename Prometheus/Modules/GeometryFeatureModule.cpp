@@ -1,6 +1,9 @@
 #include "GeometryFeatureModule.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <opencv4/opencv2/core/hal/intrin.hpp>
 
 namespace RoboPioneers::Modules
 {
@@ -139,25 +142,73 @@ namespace RoboPioneers::Modules
 	}
 
 	/// 获取矩形几何特征
-	auto GeometryFeatureModule::GetRectangleGeometryFeature(const std::vector<cv::Point> &contour)
+	auto GeometryFeatureModule::GetRectangleGeometryFeature(cv::InputArray contour)
 		-> GeometryFeatureModule::GeometryFeature
 	{
 		auto result = StandardizeRotatedRectangle(cv::minAreaRect(contour));
-		result.Raw.Contour = contour;
+		contour.copyTo(result.Raw.Contour);
 		result.MatchingShape = GeometryFeature::Shape::Rectangle;
 		return result;
 	}
 
 	/// 获取椭圆几何特征
-	auto GeometryFeatureModule::GetEllipseGeometryFeature(const std::vector<cv::Point> &contour)
+	auto GeometryFeatureModule::GetEllipseGeometryFeature(cv::InputArray contour)
 		-> GeometryFeatureModule::GeometryFeature
 	{
 		auto result = StandardizeRotatedRectangle(cv::fitEllipseDirect(contour));
-		result.Raw.Contour = contour;
+		contour.copyTo(result.Raw.Contour);
 		result.MatchingShape = GeometryFeature::Shape::Ellipse;
 		return result;
 	}
 
+	/// 由图像矩获取几何特征
+	auto GeometryFeatureModule::GetMomentGeometryFeature(const cv::Moments &moments)
+		-> GeometryFeatureModule::GeometryFeature
+	{
+		if (moments.m00 <= 0) return GeometryFeature();
+
+		//==============================
+		// 协方差矩阵的特征值与主轴方向
+		//==============================
+
+		const double covariance_xx = moments.mu20 / moments.m00;
+		const double covariance_xy = moments.mu11 / moments.m00;
+		const double covariance_yy = moments.mu02 / moments.m00;
+
+		const double half_trace = (covariance_xx + covariance_yy) / 2.0;
+		const double root = std::sqrt(std::max(
+				(covariance_xx - covariance_yy) * (covariance_xx - covariance_yy) / 4.0 + covariance_xy * covariance_xy,
+				0.0));
+		const double major_variance = half_trace + root;
+		const double minor_variance = std::max(half_trace - root, 0.0);
+
+		// 图像坐标系中主轴与X轴的夹角，Y轴向下
+		const double theta = 0.5 * std::atan2(2.0 * covariance_xy, covariance_xx - covariance_yy);
+
+		//==============================
+		// 构造等效矩形
+		//==============================
+
+		constexpr double pi = 3.14159265358979;
+
+		// 标准化转角为逆时针角度，图像坐标系中的顺时针角度取反即为逆时针角度
+		double angle = std::fmod(-theta * 180.0 / pi + 180.0, 180.0);
+		if (angle < 0) angle += 180.0;
+
+		const auto length = static_cast<float>(std::sqrt(12.0 * major_variance));
+		const auto width = static_cast<float>(std::sqrt(12.0 * minor_variance));
+
+		// 宽不小于高且角度在(-180, 0]时，标准化转角即为角度的相反数
+		cv::RotatedRect rectangle(cv::Point2f(static_cast<float>(moments.m10 / moments.m00),
+										static_cast<float>(moments.m01 / moments.m00)),
+							cv::Size2f(length, width), static_cast<float>(-angle));
+
+		auto result = StandardizeRotatedRectangle(rectangle);
+		result.MatchingShape = GeometryFeature::Shape::Moment;
+		result.FillingRate = length * width > 0 ? moments.m00 / (static_cast<double>(length) * width) : 0.0;
+		return result;
+	}
+
 	/// 比较几何特征
 	bool GeometryFeatureModule::IsGeometryFeatureIdentical(const GeometryFeatureModule::GeometryFeature &a,
 	                                                       const GeometryFeatureModule::GeometryFeature &b)
@@ -169,4 +220,268 @@ namespace RoboPioneers::Modules
 		if (a.Raw.Contour != b.Raw.Contour) return false;
 		return true;
 	}
+
+	//==============================
+	// 灯条对部分
+	//==============================
+
+	/// 由灯条对构造装甲板矩形
+	cv::RotatedRect GeometryFeatureModule::GetPairRotatedRectangle(const BarParameters &first,
+																  const BarParameters &second)
+	{
+		//==============================
+		// 两个灯条矩形的顶点
+		//==============================
+
+		std::array<cv::Point2f, 8> corners;
+		for (std::size_t bar_index = 0; bar_index < 2; ++bar_index)
+		{
+			const auto& bar = bar_index == 0 ? first : second;
+			const cv::Point2f half_length(bar.UnitDirection(0) * bar.Length / 2.0f,
+										  bar.UnitDirection(1) * bar.Length / 2.0f);
+			const cv::Point2f half_width(-bar.UnitDirection(1) * bar.Width / 2.0f,
+										 bar.UnitDirection(0) * bar.Width / 2.0f);
+			corners[bar_index * 4 + 0] = bar.Center + half_length + half_width;
+			corners[bar_index * 4 + 1] = bar.Center + half_length - half_width;
+			corners[bar_index * 4 + 2] = bar.Center - half_length - half_width;
+			corners[bar_index * 4 + 3] = bar.Center - half_length + half_width;
+		}
+
+		//==============================
+		// 枚举候选方向
+		//==============================
+
+		std::array<cv::Vec2f, 18> directions;
+		std::size_t direction_count = 0;
+		directions[direction_count++] = first.UnitDirection;
+		directions[direction_count++] = second.UnitDirection;
+		for (std::size_t first_corner = 0; first_corner < 4; ++first_corner)
+		{
+			for (std::size_t second_corner = 4; second_corner < 8; ++second_corner)
+			{
+				const cv::Point2f delta = corners[second_corner] - corners[first_corner];
+				const float norm = std::hypot(delta.x, delta.y);
+				if (norm <= 0.0f) continue;
+				directions[direction_count++] = cv::Vec2f(delta.x / norm, delta.y / norm);
+			}
+		}
+
+		cv::RotatedRect best_rectangle;
+		double best_area = -1.0;
+		for (std::size_t direction_index = 0; direction_index < direction_count; ++direction_index)
+		{
+			const auto& direction = directions[direction_index];
+
+			float min_along = corners[0].x * direction(0) + corners[0].y * direction(1);
+			float max_along = min_along;
+			float min_across = -corners[0].x * direction(1) + corners[0].y * direction(0);
+			float max_across = min_across;
+			for (std::size_t corner = 1; corner < corners.size(); ++corner)
+			{
+				const float along = corners[corner].x * direction(0) + corners[corner].y * direction(1);
+				const float across = -corners[corner].x * direction(1) + corners[corner].y * direction(0);
+				min_along = std::min(min_along, along);
+				max_along = std::max(max_along, along);
+				min_across = std::min(min_across, across);
+				max_across = std::max(max_across, across);
+			}
+
+			const double area = static_cast<double>(max_along - min_along) * (max_across - min_across);
+			if (best_area >= 0.0 && area >= best_area) continue;
+			best_area = area;
+
+			// 由局部坐标系中的中心变换回图像坐标系
+			const float center_along = (min_along + max_along) / 2.0f;
+			const float center_across = (min_across + max_across) / 2.0f;
+			constexpr double pi = 3.14159265358979;
+			best_rectangle = cv::RotatedRect(
+					cv::Point2f(center_along * direction(0) - center_across * direction(1),
+								center_along * direction(1) + center_across * direction(0)),
+					cv::Size2f(max_along - min_along, max_across - min_across),
+					static_cast<float>(std::atan2(direction(1), direction(0)) * 180.0 / pi));
+		}
+
+		return best_rectangle;
+	}
+
+	//==============================
+	// 符号距离部分
+	//==============================
+
+	/// 点到旋转矩形的符号距离
+	double GeometryFeatureModule::GetRectangleSignedDistance(const cv::Point2f &point, const cv::Point2f &center,
+															const cv::Vec2f &unit_direction, double length,
+															double width)
+	{
+		// 转换到以中心为原点、长边为横轴的局部坐标系
+		const double delta_x = point.x - center.x;
+		const double delta_y = point.y - center.y;
+		const double along = std::fabs(delta_x * unit_direction(0) + delta_y * unit_direction(1));
+		const double across = std::fabs(-delta_x * unit_direction(1) + delta_y * unit_direction(0));
+
+		const double outside_x = along - length / 2.0;
+		const double outside_y = across - width / 2.0;
+
+		// 外部为到矩形的欧氏距离，内部为到最近边的距离的相反数
+		const double outside = std::hypot(std::max(outside_x, 0.0), std::max(outside_y, 0.0));
+		const double inside = std::min(std::max(outside_x, outside_y), 0.0);
+		return outside + inside;
+	}
+
+	/// 点到椭圆的符号距离
+	double GeometryFeatureModule::GetEllipseSignedDistance(const cv::Point2f &point, const cv::Point2f &center,
+														  const cv::Vec2f &unit_direction, double length,
+														  double width)
+	{
+		const double delta_x = point.x - center.x;
+		const double delta_y = point.y - center.y;
+		const double along = delta_x * unit_direction(0) + delta_y * unit_direction(1);
+		const double across = -delta_x * unit_direction(1) + delta_y * unit_direction(0);
+
+		const double radius_x = std::max(length / 2.0, 0.5);
+		const double radius_y = std::max(width / 2.0, 0.5);
+
+		// 对称到第一象限，以无三角函数的牛顿迭代求椭圆上的最近点，参数为(cos t, sin t)
+		const double point_x = std::fabs(along);
+		const double point_y = std::fabs(across);
+		double cos_t = 0.70710678, sin_t = 0.70710678;
+
+		for (int iteration = 0; iteration < EllipseDistanceIterations; ++iteration)
+		{
+			// 曲率中心
+			const double evolute_x = (radius_x * radius_x - radius_y * radius_y) * cos_t * cos_t * cos_t / radius_x;
+			const double evolute_y = (radius_y * radius_y - radius_x * radius_x) * sin_t * sin_t * sin_t / radius_y;
+
+			const double curve_radius = std::hypot(radius_x * cos_t - evolute_x, radius_y * sin_t - evolute_y);
+			const double point_radius = std::max(std::hypot(point_x - evolute_x, point_y - evolute_y), 1e-9);
+
+			cos_t = std::clamp(((point_x - evolute_x) * curve_radius / point_radius + evolute_x) / radius_x, 0.0, 1.0);
+			sin_t = std::clamp(((point_y - evolute_y) * curve_radius / point_radius + evolute_y) / radius_y, 0.0, 1.0);
+			const double norm = std::max(std::hypot(cos_t, sin_t), 1e-9);
+			cos_t /= norm;
+			sin_t /= norm;
+		}
+
+		const double distance = std::hypot(point_x - radius_x * cos_t, point_y - radius_y * sin_t);
+		const double level = (point_x * point_x) / (radius_x * radius_x) + (point_y * point_y) / (radius_y * radius_y);
+		return level < 1.0 ? -distance : distance;
+	}
+
+	/// 批量获取点到旋转矩形的符号距离
+	void GeometryFeatureModule::GetRectangleSignedDistances(std::size_t count, const float *point_x,
+															const float *point_y, const ShapeArrays &rectangles,
+															float *distances)
+	{
+		std::size_t index = 0;
+
+		#if (CV_SIMD || CV_SIMD_SCALABLE)
+		const cv::v_float32 zero = cv::vx_setzero_f32();
+		const cv::v_float32 half = cv::vx_setall_f32(0.5f);
+		const auto lanes = static_cast<std::size_t>(cv::VTraits<cv::v_float32>::vlanes());
+		for (; index + lanes <= count; index += lanes)
+		{
+			const cv::v_float32 delta_x = cv::v_sub(cv::vx_load(point_x + index), cv::vx_load(rectangles.CenterX + index));
+			const cv::v_float32 delta_y = cv::v_sub(cv::vx_load(point_y + index), cv::vx_load(rectangles.CenterY + index));
+			const cv::v_float32 direction_x = cv::vx_load(rectangles.DirectionX + index);
+			const cv::v_float32 direction_y = cv::vx_load(rectangles.DirectionY + index);
+
+			const cv::v_float32 along = cv::v_abs(cv::v_muladd(delta_x, direction_x, cv::v_mul(delta_y, direction_y)));
+			const cv::v_float32 across = cv::v_abs(
+					cv::v_muladd(delta_y, direction_x, cv::v_sub(zero, cv::v_mul(delta_x, direction_y))));
+
+			const cv::v_float32 outside_x = cv::v_sub(along, cv::v_mul(cv::vx_load(rectangles.Length + index), half));
+			const cv::v_float32 outside_y = cv::v_sub(across, cv::v_mul(cv::vx_load(rectangles.Width + index), half));
+
+			const cv::v_float32 positive_x = cv::v_max(outside_x, zero);
+			const cv::v_float32 positive_y = cv::v_max(outside_y, zero);
+			const cv::v_float32 outside = cv::v_sqrt(cv::v_muladd(positive_x, positive_x, cv::v_mul(positive_y, positive_y)));
+			const cv::v_float32 inside = cv::v_min(cv::v_max(outside_x, outside_y), zero);
+
+			cv::v_store(distances + index, cv::v_add(outside, inside));
+		}
+		#endif
+
+		for (; index < count; ++index)
+		{
+			distances[index] = static_cast<float>(GetRectangleSignedDistance(
+					cv::Point2f(point_x[index], point_y[index]),
+					cv::Point2f(rectangles.CenterX[index], rectangles.CenterY[index]),
+					cv::Vec2f(rectangles.DirectionX[index], rectangles.DirectionY[index]),
+					rectangles.Length[index], rectangles.Width[index]));
+		}
+	}
+
+	/// 批量获取点到椭圆的符号距离
+	void GeometryFeatureModule::GetEllipseSignedDistances(std::size_t count, const float *point_x,
+														  const float *point_y, const ShapeArrays &ellipses,
+														  float *distances)
+	{
+		std::size_t index = 0;
+
+		#if (CV_SIMD || CV_SIMD_SCALABLE)
+		const cv::v_float32 zero = cv::vx_setzero_f32();
+		const cv::v_float32 half = cv::vx_setall_f32(0.5f);
+		const cv::v_float32 one = cv::vx_setall_f32(1.0f);
+		const cv::v_float32 epsilon = cv::vx_setall_f32(1e-9f);
+		const auto lanes = static_cast<std::size_t>(cv::VTraits<cv::v_float32>::vlanes());
+		for (; index + lanes <= count; index += lanes)
+		{
+			const cv::v_float32 delta_x = cv::v_sub(cv::vx_load(point_x + index), cv::vx_load(ellipses.CenterX + index));
+			const cv::v_float32 delta_y = cv::v_sub(cv::vx_load(point_y + index), cv::vx_load(ellipses.CenterY + index));
+			const cv::v_float32 direction_x = cv::vx_load(ellipses.DirectionX + index);
+			const cv::v_float32 direction_y = cv::vx_load(ellipses.DirectionY + index);
+
+			const cv::v_float32 local_x = cv::v_abs(cv::v_muladd(delta_x, direction_x, cv::v_mul(delta_y, direction_y)));
+			const cv::v_float32 local_y = cv::v_abs(
+					cv::v_muladd(delta_y, direction_x, cv::v_sub(zero, cv::v_mul(delta_x, direction_y))));
+
+			const cv::v_float32 radius_x = cv::v_max(cv::v_mul(cv::vx_load(ellipses.Length + index), half), half);
+			const cv::v_float32 radius_y = cv::v_max(cv::v_mul(cv::vx_load(ellipses.Width + index), half), half);
+			const cv::v_float32 focal = cv::v_sub(cv::v_mul(radius_x, radius_x), cv::v_mul(radius_y, radius_y));
+
+			cv::v_float32 cos_t = cv::vx_setall_f32(0.70710678f), sin_t = cos_t;
+			for (int iteration = 0; iteration < EllipseDistanceIterations; ++iteration)
+			{
+				const cv::v_float32 evolute_x = cv::v_div(
+						cv::v_mul(cv::v_mul(cv::v_mul(focal, cos_t), cos_t), cos_t), radius_x);
+				const cv::v_float32 evolute_y = cv::v_sub(zero, cv::v_div(
+						cv::v_mul(cv::v_mul(cv::v_mul(focal, sin_t), sin_t), sin_t), radius_y));
+
+				const cv::v_float32 curve_x = cv::v_sub(cv::v_mul(radius_x, cos_t), evolute_x);
+				const cv::v_float32 curve_y = cv::v_sub(cv::v_mul(radius_y, sin_t), evolute_y);
+				const cv::v_float32 offset_x = cv::v_sub(local_x, evolute_x);
+				const cv::v_float32 offset_y = cv::v_sub(local_y, evolute_y);
+				const cv::v_float32 curve_radius = cv::v_sqrt(cv::v_muladd(curve_x, curve_x, cv::v_mul(curve_y, curve_y)));
+				const cv::v_float32 point_radius = cv::v_max(
+						cv::v_sqrt(cv::v_muladd(offset_x, offset_x, cv::v_mul(offset_y, offset_y))), epsilon);
+				const cv::v_float32 scale = cv::v_div(curve_radius, point_radius);
+
+				cos_t = cv::v_min(cv::v_max(cv::v_div(cv::v_muladd(offset_x, scale, evolute_x), radius_x), zero), one);
+				sin_t = cv::v_min(cv::v_max(cv::v_div(cv::v_muladd(offset_y, scale, evolute_y), radius_y), zero), one);
+				const cv::v_float32 norm = cv::v_max(cv::v_sqrt(cv::v_muladd(cos_t, cos_t, cv::v_mul(sin_t, sin_t))), epsilon);
+				cos_t = cv::v_div(cos_t, norm);
+				sin_t = cv::v_div(sin_t, norm);
+			}
+
+			const cv::v_float32 nearest_x = cv::v_sub(local_x, cv::v_mul(radius_x, cos_t));
+			const cv::v_float32 nearest_y = cv::v_sub(local_y, cv::v_mul(radius_y, sin_t));
+			const cv::v_float32 distance = cv::v_sqrt(cv::v_muladd(nearest_x, nearest_x, cv::v_mul(nearest_y, nearest_y)));
+
+			const cv::v_float32 scaled_x = cv::v_div(local_x, radius_x);
+			const cv::v_float32 scaled_y = cv::v_div(local_y, radius_y);
+			const cv::v_float32 inside = cv::v_lt(cv::v_muladd(scaled_x, scaled_x, cv::v_mul(scaled_y, scaled_y)), one);
+
+			cv::v_store(distances + index, cv::v_select(inside, cv::v_sub(zero, distance), distance));
+		}
+		#endif
+
+		for (; index < count; ++index)
+		{
+			distances[index] = static_cast<float>(GetEllipseSignedDistance(
+					cv::Point2f(point_x[index], point_y[index]),
+					cv::Point2f(ellipses.CenterX[index], ellipses.CenterY[index]),
+					cv::Vec2f(ellipses.DirectionX[index], ellipses.DirectionY[index]),
+					ellipses.Length[index], ellipses.Width[index]));
+		}
+	}
 }
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <tuple>
-#include <unordered_set>
+#include <cstddef>
+#include <vector>
 #include <opencv4/opencv2/opencv.hpp>
 
 namespace RoboPioneers::Modules
@@ -24,6 +24,7 @@ namespace RoboPioneers::Modules
 			 *  ~ 匹配形状可以表明几何参数的匹配来源。
 			 *  ~ 默认值为Unknown，即未知匹配类型。
 			 *  ~ 几何特征模块的几何特征计算方法会自动设定为相应的形状。
+			 *  ~ 枚举值从0开始连续，新增的形状应当置于Moment之前，使ShapeCount保持正确。
 			 */
 			enum class Shape
 			{
@@ -32,9 +33,14 @@ namespace RoboPioneers::Modules
 				/// 椭圆匹配
 				Ellipse,
 				/// 矩形匹配
-				Rectangle
+				Rectangle,
+				/// 由图像矩估计
+				Moment
 			}MatchingShape {Shape::Unknown};
 
+			/// 匹配形状的数量，可以用于以形状的枚举值为下标的数组
+			static constexpr std::size_t ShapeCount = static_cast<std::size_t>(Shape::Moment) + 1;
+
 			/// 原始信息
 			struct {
 				/// 轮廓
@@ -93,6 +99,13 @@ namespace RoboPioneers::Modules
 
 			/// 中心坐标
 			cv::Point2i Center;
+
+			/**
+			 * @brief 填充率
+			 * @details
+			 *  ~ 由图像矩估计时为像素数与等效矩形面积之比，实心的凸形状约为1，其他途径不设定该值。
+			 */
+			double FillingRate {0.0};
 		};
 
 		/**
@@ -110,24 +123,39 @@ namespace RoboPioneers::Modules
 
 		/**
 		 * @brief 获取矩形的几何特征
-		 * @param contour 边缘点集
+		 * @param contour 边缘点集，可以是std::vector<cv::Point>或CV_32SC2格式的矩阵
 		 * @return 外接点集的最小旋转矩形的几何特征
 		 * @struct GeometryFeatureModule::GeometryFeature
 		 * @details
 		 *  ~ 标准化的处理标准需要查看GeometryFeature的注释。
+		 *  ~ 边缘点集将被复制到结果的原始轮廓中。
 		 */
-		static auto GetRectangleGeometryFeature(const std::vector<cv::Point>& contour)
+		static auto GetRectangleGeometryFeature(cv::InputArray contour)
 			-> GeometryFeature;
 
 		/**
 		 * @brief 获取椭圆的几何特征
-		 * @param contour 边缘点集
+		 * @param contour 边缘点集，可以是std::vector<cv::Point>或CV_32SC2格式的矩阵
 		 * @return 外接点集的最小旋转椭圆的几何特征
 		 * @struct GeometryFeatureModule::GeometryFeature
 		 * @details
 		 *  ~ 标准化的处理标准需要查看GeometryFeature的注释。
+		 *  ~ 边缘点集将被复制到结果的原始轮廓中。
+		 */
+		static auto GetEllipseGeometryFeature(cv::InputArray contour)
+			-> GeometryFeature;
+
+		/**
+		 * @brief 由图像矩获取几何特征
+		 * @param moments 像素的图像矩
+		 * @return 等效矩形的几何特征，原始轮廓为空；像素数为0时返回默认值
+		 * @struct GeometryFeatureModule::GeometryFeature
+		 * @details
+		 *  ~ 朝向为二阶中心矩协方差矩阵的主轴方向。
+		 *  ~ 等效矩形与该形状具有相同的二阶中心矩，长宽分别为sqrt(12*λ1)与sqrt(12*λ2)，λ为协方差矩阵的特征值。
+		 *  ~ 只需要常数次运算，可以在拟合之前用于快速筛选；结果经过StandardizeRotatedRectangle标准化。
 		 */
-		static auto GetEllipseGeometryFeature(const std::vector<cv::Point>& contour)
+		static auto GetMomentGeometryFeature(const cv::Moments& moments)
 			-> GeometryFeature;
 
 		/**
@@ -141,42 +169,118 @@ namespace RoboPioneers::Modules
 		 */
 		static bool IsGeometryFeatureIdentical(const GeometryFeature& a, const GeometryFeature& b);
 
-		using ElementPair = std::tuple<GeometryFeature, GeometryFeature>;
+		//==============================
+		// 灯条对部分
+		//==============================
 
-		/// 元素对哈希函数
-		struct ElementPairHash
+		/**
+		 * @brief 灯条参数
+		 * @details
+		 *  ~ 以旋转矩形描述灯条，只包含构造装甲板矩形所需的量。
+		 */
+		struct BarParameters
 		{
-			std::size_t operator()(const ElementPair& elementPair) const
-			{
-//				auto center = elementPair.A.Center + elementPair.B.Center;
-				auto center = std::get<0>(elementPair).Center + std::get<1>(elementPair).Center;
-				/// 零点到中心点的距离平方
-				auto square_distance = center.dot(center);
-
-				return std::hash<decltype(square_distance)>()(square_distance);
-			}
+			/// 中心
+			cv::Point2f Center;
+			/// 沿长边的单位方向向量
+			cv::Vec2f UnitDirection;
+			/// 长边长度
+			float Length;
+			/// 短边长度
+			float Width;
 		};
 
-		/// 元素对相等判断函数
-		struct ElementPairEqual
+		/**
+		 * @brief 由灯条对构造装甲板矩形
+		 * @param first 一个灯条
+		 * @param second 另一个灯条
+		 * @return 两个灯条矩形的最小外接旋转矩形
+		 * @details
+		 *  ~ 最小外接矩形必有一边与两灯条矩形凸包的某条边共线，凸包的边只可能是灯条的边或连接两灯条顶点的线段，
+		 *    因此只需枚举灯条的两个方向与两灯条顶点之间的16个方向，运算次数与轮廓点数无关。
+		 *  ~ 与对两灯条轮廓合并后调用cv::minAreaRect相比，结果以拟合的矩形代替轮廓，对规则的灯条两者相近。
+		 */
+		static cv::RotatedRect GetPairRotatedRectangle(const BarParameters& first, const BarParameters& second);
+
+		//==============================
+		// 符号距离部分
+		//==============================
+
+		/// 求点到椭圆距离时的迭代次数
+		static constexpr int EllipseDistanceIterations = 3;
+
+		/**
+		 * @brief 获取点到旋转矩形的符号距离
+		 * @param point 点
+		 * @param center 矩形中心
+		 * @param unit_direction 沿长边的单位方向向量
+		 * @param length 长边长度
+		 * @param width 短边长度
+		 * @return 点在矩形外时为到边界的距离，在矩形内时为到边界距离的相反数
+		 */
+		static double GetRectangleSignedDistance(const cv::Point2f& point, const cv::Point2f& center,
+										   const cv::Vec2f& unit_direction, double length, double width);
+
+		/**
+		 * @brief 获取点到椭圆的符号距离
+		 * @param point 点
+		 * @param center 椭圆中心
+		 * @param unit_direction 沿长轴的单位方向向量
+		 * @param length 长轴长度
+		 * @param width 短轴长度
+		 * @return 点在椭圆外时为正，在椭圆内时为负
+		 * @details
+		 *  ~ 以固定次数的无三角函数牛顿迭代求椭圆上的最近点，迭代沿曲率中心进行，对细长的椭圆同样收敛。
+		 *  ~ 轴长不足1像素时按1像素计算，避免退化。
+		 */
+		static double GetEllipseSignedDistance(const cv::Point2f& point, const cv::Point2f& center,
+										 const cv::Vec2f& unit_direction, double length, double width);
+
+		/**
+		 * @brief 批量形状参数
+		 * @details
+		 *  ~ 各数组的第i项描述第i个形状，长宽为全长。
+		 */
+		struct ShapeArrays
 		{
-			bool operator()(const ElementPair& a, const ElementPair& b) const
-			{
-				if (Modules::GeometryFeatureModule::IsGeometryFeatureIdentical(std::get<0>(a), std::get<0>(b)) &&
-				    Modules::GeometryFeatureModule::IsGeometryFeatureIdentical(std::get<1>(a), std::get<1>(b)))
-				{
-					return true;
-				}
-				if (Modules::GeometryFeatureModule::IsGeometryFeatureIdentical(std::get<0>(a), std::get<1>(b)) &&
-				    Modules::GeometryFeatureModule::IsGeometryFeatureIdentical(std::get<1>(a), std::get<0>(b)))
-				{
-					return true;
-				}
-
-				return false;
-			}
+			/// 中心横坐标
+			const float* CenterX;
+			/// 中心纵坐标
+			const float* CenterY;
+			/// 单位方向向量横分量
+			const float* DirectionX;
+			/// 单位方向向量纵分量
+			const float* DirectionY;
+			/// 长度
+			const float* Length;
+			/// 宽度
+			const float* Width;
 		};
 
-		using ElementPairSet = std::unordered_set<ElementPair, ElementPairHash, ElementPairEqual>;
+		/**
+		 * @brief 批量获取点到旋转矩形的符号距离
+		 * @param count 数量
+		 * @param point_x 各点的横坐标
+		 * @param point_y 各点的纵坐标
+		 * @param rectangles 各点对应的矩形
+		 * @param distances 输出的符号距离
+		 * @details
+		 *  ~ 以SIMD指令同时计算多个点，结果与GetRectangleSignedDistance在单精度下一致。
+		 */
+		static void GetRectangleSignedDistances(std::size_t count, const float* point_x, const float* point_y,
+										  const ShapeArrays& rectangles, float* distances);
+
+		/**
+		 * @brief 批量获取点到椭圆的符号距离
+		 * @param count 数量
+		 * @param point_x 各点的横坐标
+		 * @param point_y 各点的纵坐标
+		 * @param ellipses 各点对应的椭圆
+		 * @param distances 输出的符号距离
+		 * @details
+		 *  ~ 以SIMD指令同时计算多个点，结果与GetEllipseSignedDistance在单精度下一致。
+		 */
+		static void GetEllipseSignedDistances(std::size_t count, const float* point_x, const float* point_y,
+										const ShapeArrays& ellipses, float* distances);
 	};
 }
\ No newline at end of file
@@ -55,6 +55,7 @@ namespace RoboPioneers::Modules
 		}
 	}
 
+	#ifndef NO_CUDA
 	/// 显示显存中的图片
 	void ImageDebugUtility::ShowGPUPicture(const std::string& title, const cv::cuda::GpuMat& gpu_picture)
 	{
@@ -65,4 +66,5 @@ namespace RoboPioneers::Modules
 
 		cv::imshow(title, picture);
 	}
+	#endif
 }
\ No newline at end of file
@@ -54,6 +54,8 @@ namespace RoboPioneers::Modules
 		 * @param title 窗口标题
 		 * @param picture 显示的图片
 		 */
+		#ifndef NO_CUDA
 		static void ShowGPUPicture(const std::string& title, const cv::cuda::GpuMat& picture);
+		#endif
 	};
 }
@@ -0,0 +1,77 @@
+#include "InterestedAreaController.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace RoboPioneers::Modules
+{
+	/// 获取兴趣区域
+	cv::Rect InterestedAreaController::GetArea(const KalmanTracker::State &state, double scale,
+											   cv::Size picture_size) const
+	{
+		if (picture_size.width <= 0 || picture_size.height <= 0) return cv::Rect();
+
+		// 装甲板一般接近水平，横向以长宽中的较大者计算以容纳倾斜，纵向以短边计算
+		const double extent = std::max(state.Size.width, state.Size.height);
+		const double half_width = std::max(scale * extent / 2.0 + Settings.SigmaMultiple * std::sqrt(state.CenterVariance[0]),
+								  Settings.MinimumSize.width / 2.0);
+		const double half_height = std::max(scale * state.Size.height / 2.0 +
+								   Settings.SigmaMultiple * std::sqrt(state.CenterVariance[1]),
+								   Settings.MinimumSize.height / 2.0);
+
+		const int left = std::max(static_cast<int>(std::floor(state.Center.x - half_width)), 0);
+		const int top = std::max(static_cast<int>(std::floor(state.Center.y - half_height)), 0);
+		const int right = std::min(static_cast<int>(std::ceil(state.Center.x + half_width)), picture_size.width);
+		const int bottom = std::min(static_cast<int>(std::ceil(state.Center.y + half_height)), picture_size.height);
+		if (right <= left || bottom <= top) return cv::Rect();
+
+		return cv::Rect(left, top, right - left, bottom - top);
+	}
+
+	/// 合并相交的区域
+	void InterestedAreaController::MergeAreas(std::vector<cv::Rect> &areas, cv::Size picture_size) const
+	{
+		areas.erase(std::remove_if(areas.begin(), areas.end(), [](const cv::Rect& area){
+			return area.empty();
+		}), areas.end());
+
+		bool merged = true;
+		while (merged)
+		{
+			merged = false;
+			for (std::size_t first = 0; first < areas.size() && !merged; ++first)
+			{
+				for (std::size_t second = first + 1; second < areas.size(); ++second)
+				{
+					if ((areas[first] & areas[second]).empty()) continue;
+
+					areas[first] |= areas[second];
+					areas.erase(areas.begin() + static_cast<std::ptrdiff_t>(second));
+					merged = true;
+					break;
+				}
+			}
+		}
+
+		// 裁剪时处理的是外接矩形内的全部像素，相距较远的区域即使各自很小也会得到接近整幅的图像
+		const double max_area = Settings.MaxAreaRatio * picture_size.area();
+		while (!areas.empty())
+		{
+			cv::Rect bounding_area = areas.front();
+			for (const auto& area : areas)
+			{
+				bounding_area |= area;
+			}
+			if (bounding_area.area() <= max_area) break;
+
+			if (areas.size() == 1)
+			{
+				areas.clear();
+			}
+			else
+			{
+				areas.pop_back();
+			}
+		}
+	}
+}
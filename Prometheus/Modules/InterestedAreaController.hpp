@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <opencv4/opencv2/opencv.hpp>
+
+#include "KalmanTracker.hpp"
+
+namespace RoboPioneers::Modules
+{
+	/**
+	 * @brief 兴趣区域控制器
+	 * @author Vincent
+	 * @details
+	 *  ~ 由目标在下一帧采集时刻的预测状态确定兴趣区域：
+	 *    区域以预测中心为中心，半宽为预测长宽乘以缩放比例的一半，再加上预测中心标准差的倍数。
+	 *  ~ 目标运动越快、丢失越久，预测方差越大，区域随之扩大；静止且稳定跟踪的目标只保留很小的区域。
+	 *  ~ 区域限制在图像范围内。多个区域由图像裁剪服务复制到其外接矩形大小的图像中，处理的像素数为外接矩形的面积，
+	 *    因此以外接矩形的面积衡量区域列表：超过图像的一定比例时依次舍弃靠后的区域，
+	 *    只剩一个区域仍然超过时不如直接处理整幅图像，此时不给出区域。
+	 */
+	class InterestedAreaController
+	{
+	public:
+		/// 控制设定
+		struct SettingsType {
+			/// 预测中心标准差的倍数，越大越不容易丢失机动的目标
+			double SigmaMultiple {3.0};
+			/// 区域的最小尺寸，避免远处的小目标区域过小
+			cv::Size MinimumSize {120, 80};
+			/// 所有区域的外接矩形面积与图像面积之比的上限，0.0~1.0
+			double MaxAreaRatio {0.6};
+		}Settings;
+
+		/**
+		 * @brief 获取目标的兴趣区域
+		 * @param state 目标在下一帧采集时刻的预测状态，为全图坐标
+		 * @param scale 长宽的缩放比例
+		 * @param picture_size 图像尺寸
+		 * @return 限制在图像范围内的兴趣区域，目标预测在图像外时返回空矩形
+		 */
+		[[nodiscard]] cv::Rect GetArea(const KalmanTracker::State& state, double scale, cv::Size picture_size) const;
+
+		/**
+		 * @brief 合并相交的区域
+		 * @param areas 区域列表，按优先级从高到低排列；合并后相互之间不再相交，顺序保持各组中第一个区域的顺序
+		 * @param picture_size 图像尺寸
+		 * @details
+		 *  ~ 先移除空的区域，再将相交的区域以外接矩形代替，重复直到没有相交的区域。
+		 *  ~ 合并后所有区域的外接矩形过大时，从末尾起依次舍弃区域，直到外接矩形不再过大；
+		 *    只剩一个区域仍然过大时清空列表，表示处理整幅图像。
+		 */
+		void MergeAreas(std::vector<cv::Rect>& areas, cv::Size picture_size) const;
+	};
+}
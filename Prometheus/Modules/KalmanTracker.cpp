@@ -0,0 +1,161 @@
+#include "KalmanTracker.hpp"
+
+#include <algorithm>
+
+namespace RoboPioneers::Modules
+{
+	//==============================
+	// 单个量部分
+	//==============================
+
+	/// 预测
+	void KalmanTracker::Axis::Predict(double delta_time, double noise)
+	{
+		if (delta_time <= 0.0) return;
+
+		const double square_time = delta_time * delta_time;
+
+		Position += Velocity * delta_time;
+
+		// P = F P F^T + Q，其中 F = [1 dt; 0 1]，Q = q [dt^3/3 dt^2/2; dt^2/2 dt]
+		PositionVariance += 2.0 * delta_time * Covariance + square_time * VelocityVariance +
+				noise * square_time * delta_time / 3.0;
+		Covariance += delta_time * VelocityVariance + noise * square_time / 2.0;
+		VelocityVariance += noise * delta_time;
+	}
+
+	/// 以观测更新
+	void KalmanTracker::Axis::Correct(double measurement, double noise)
+	{
+		const double innovation_variance = PositionVariance + noise;
+		if (innovation_variance <= 0.0) return;
+
+		const double position_gain = PositionVariance / innovation_variance;
+		const double velocity_gain = Covariance / innovation_variance;
+		const double innovation = measurement - Position;
+
+		Position += position_gain * innovation;
+		Velocity += velocity_gain * innovation;
+
+		// P = (I - K H) P
+		VelocityVariance -= velocity_gain * Covariance;
+		Covariance -= position_gain * Covariance;
+		PositionVariance -= position_gain * PositionVariance;
+	}
+
+	//==============================
+	// 控制方法部分
+	//==============================
+
+	/// 初始化
+	void KalmanTracker::Reset(const cv::Point2d &center, const cv::Size2d &size, TimePoint time)
+	{
+		const std::array<double, 4> measurements {center.x, center.y, size.width, size.height};
+		for (std::size_t index = 0; index < Axes.size(); ++index)
+		{
+			auto& axis = Axes[index];
+			axis.Position = measurements[index];
+			axis.Velocity = 0.0;
+			axis.PositionVariance = index < 2 ? Settings.CenterMeasurementNoise : Settings.SizeMeasurementNoise;
+			axis.Covariance = 0.0;
+			axis.VelocityVariance = Settings.InitialVelocityVariance;
+		}
+		Time = time;
+		Initialized = true;
+	}
+
+	/// 更新
+	void KalmanTracker::Update(const cv::Point2d &center, const cv::Size2d &size, TimePoint time)
+	{
+		if (!Initialized)
+		{
+			Reset(center, size, time);
+			return;
+		}
+
+		Predict(time);
+
+		const std::array<double, 4> measurements {center.x, center.y, size.width, size.height};
+		for (std::size_t index = 0; index < Axes.size(); ++index)
+		{
+			Axes[index].Correct(measurements[index],
+					   index < 2 ? Settings.CenterMeasurementNoise : Settings.SizeMeasurementNoise);
+		}
+	}
+
+	/// 预测
+	void KalmanTracker::Predict(TimePoint time)
+	{
+		if (!Initialized) return;
+
+		const double delta_time = GetElapsedSeconds(time);
+		if (delta_time <= 0.0) return;
+
+		for (std::size_t index = 0; index < Axes.size(); ++index)
+		{
+			Axes[index].Predict(delta_time,
+					   index < 2 ? Settings.CenterAccelerationNoise : Settings.SizeAccelerationNoise);
+		}
+		Time = time;
+	}
+
+	/// 清除状态
+	void KalmanTracker::Clear()
+	{
+		Initialized = false;
+	}
+
+	//==============================
+	// 属性部分
+	//==============================
+
+	/// 是否已经初始化
+	bool KalmanTracker::IsInitialized() const
+	{
+		return Initialized;
+	}
+
+	/// 获取状态时间
+	auto KalmanTracker::GetTime() const -> TimePoint
+	{
+		return Time;
+	}
+
+	/// 获取当前状态
+	auto KalmanTracker::GetState() const -> State
+	{
+		return ComposeState(Axes);
+	}
+
+	/// 外推状态
+	auto KalmanTracker::Extrapolate(TimePoint time) const -> State
+	{
+		auto axes = Axes;
+		const double delta_time = GetElapsedSeconds(time);
+		for (std::size_t index = 0; index < axes.size(); ++index)
+		{
+			axes[index].Predict(delta_time,
+					   index < 2 ? Settings.CenterAccelerationNoise : Settings.SizeAccelerationNoise);
+		}
+		return ComposeState(axes);
+	}
+
+	/// 获取经过的秒数
+	double KalmanTracker::GetElapsedSeconds(TimePoint time) const
+	{
+		return std::max(std::chrono::duration<double>(time - Time).count(), 0.0);
+	}
+
+	/// 组合状态
+	auto KalmanTracker::ComposeState(const std::array<Axis, 4>& axes) -> State
+	{
+		State state;
+		state.Center = cv::Point2d(axes[0].Position, axes[1].Position);
+		state.Velocity = cv::Vec2d(axes[0].Velocity, axes[1].Velocity);
+		// 长宽不会为负，滤波的超调截断为0
+		state.Size = cv::Size2d(std::max(axes[2].Position, 0.0), std::max(axes[3].Position, 0.0));
+		state.CenterVariance = cv::Vec2d(axes[0].PositionVariance, axes[1].PositionVariance);
+		state.VelocityVariance = cv::Vec2d(axes[0].VelocityVariance, axes[1].VelocityVariance);
+		return state;
+	}
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <opencv4/opencv2/opencv.hpp>
+
+namespace RoboPioneers::Modules
+{
+	/**
+	 * @brief 匀速卡尔曼跟踪器
+	 * @author Vincent
+	 * @details
+	 *  ~ 以匀速模型分别滤波目标中心的横纵坐标与目标的长宽，每个量的状态为位置与速度，过程噪声为白噪声加速度。
+	 *  ~ 四个量相互独立，协方差为4个2x2的块，预测与更新都只需要常数次标量运算。
+	 *  ~ 时间取自帧的采集时间，两次观测的间隔不必相等；外推到任意时刻时不修改滤波器状态。
+	 */
+	class KalmanTracker
+	{
+	public:
+		/// 时间点
+		using TimePoint = std::chrono::steady_clock::time_point;
+
+		/// 目标状态
+		struct State
+		{
+			/// 中心
+			cv::Point2d Center;
+			/// 中心速度，单位为像素每秒
+			cv::Vec2d Velocity;
+			/// 长宽
+			cv::Size2d Size;
+			/// 中心横纵坐标的方差，单位为像素的平方
+			cv::Vec2d CenterVariance;
+			/// 中心速度横纵分量的方差
+			cv::Vec2d VelocityVariance;
+		};
+
+		/// 滤波设定
+		struct SettingsType {
+			/// 中心的加速度噪声谱密度，单位为像素平方每三次方秒，越大则越快跟上机动
+			double CenterAccelerationNoise {4.0e5};
+			/// 长宽的变化加速度噪声谱密度
+			double SizeAccelerationNoise {1.0e4};
+			/// 中心的观测方差，单位为像素的平方
+			double CenterMeasurementNoise {4.0};
+			/// 长宽的观测方差
+			double SizeMeasurementNoise {16.0};
+			/// 初始化时速度的方差，单位为像素平方每平方秒
+			double InitialVelocityVariance {1.0e6};
+		}Settings;
+
+	private:
+		/// 单个量的位置与速度
+		struct Axis
+		{
+			/// 位置
+			double Position {0.0};
+			/// 速度
+			double Velocity {0.0};
+			/// 位置方差
+			double PositionVariance {0.0};
+			/// 位置与速度的协方差
+			double Covariance {0.0};
+			/// 速度方差
+			double VelocityVariance {0.0};
+
+			/**
+			 * @brief 预测
+			 * @param delta_time 时间间隔，单位为秒
+			 * @param noise 加速度噪声谱密度
+			 */
+			void Predict(double delta_time, double noise);
+
+			/**
+			 * @brief 以观测更新
+			 * @param measurement 观测值
+			 * @param noise 观测方差
+			 */
+			void Correct(double measurement, double noise);
+		};
+
+		/// 各个量，依次为中心横坐标、中心纵坐标、长、宽
+		std::array<Axis, 4> Axes;
+		/// 状态对应的时间
+		TimePoint Time {};
+		/// 是否已经初始化
+		bool Initialized {false};
+
+	public:
+		/**
+		 * @brief 以观测初始化
+		 * @param center 中心
+		 * @param size 长宽
+		 * @param time 观测时间
+		 */
+		void Reset(const cv::Point2d& center, const cv::Size2d& size, TimePoint time);
+
+		/**
+		 * @brief 以观测更新
+		 * @param center 中心
+		 * @param size 长宽
+		 * @param time 观测时间
+		 * @details
+		 *  ~ 先预测到观测时间，再以观测修正；尚未初始化时等同于Reset。
+		 *  ~ 观测时间早于状态时间时不预测，直接修正。
+		 */
+		void Update(const cv::Point2d& center, const cv::Size2d& size, TimePoint time);
+
+		/**
+		 * @brief 预测到指定时间
+		 * @param time 目标时间
+		 * @details
+		 *  ~ 用于丢失目标时推进状态，方差随之增大；时间早于状态时间时不做任何事。
+		 */
+		void Predict(TimePoint time);
+
+		/// 清除状态
+		void Clear();
+
+		/// 是否已经初始化
+		[[nodiscard]] bool IsInitialized() const;
+
+		/// 获取状态对应的时间
+		[[nodiscard]] TimePoint GetTime() const;
+
+		/// 获取当前状态
+		[[nodiscard]] State GetState() const;
+
+		/**
+		 * @brief 外推状态
+		 * @param time 目标时间
+		 * @return 外推到目标时间的状态，不修改滤波器
+		 */
+		[[nodiscard]] State Extrapolate(TimePoint time) const;
+
+	protected:
+		/// 获取从状态时间到目标时间的秒数，目标时间较早时为0
+		[[nodiscard]] double GetElapsedSeconds(TimePoint time) const;
+
+		/// 将各个量组合为状态
+		[[nodiscard]] static State ComposeState(const std::array<Axis, 4>& axes);
+	};
+}
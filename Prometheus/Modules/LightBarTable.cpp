@@ -0,0 +1,304 @@
+#include "LightBarTable.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace RoboPioneers::Modules
+{
+	//==============================
+	// 属性部分
+	//==============================
+
+	/// 获取候选数量
+	std::size_t LightBarTable::Size() const
+	{
+		return ShapesSource.size();
+	}
+
+	/// 判断是否为空
+	bool LightBarTable::Empty() const
+	{
+		return ShapesSource.empty();
+	}
+
+	/// 获取中心横坐标列
+	const float* LightBarTable::CentersX() const
+	{
+		return CentersXSource.data();
+	}
+
+	/// 获取中心纵坐标列
+	const float* LightBarTable::CentersY() const
+	{
+		return CentersYSource.data();
+	}
+
+	/// 获取标准化转角列
+	const float* LightBarTable::Angles() const
+	{
+		return AnglesSource.data();
+	}
+
+	/// 获取长度列
+	const float* LightBarTable::Lengths() const
+	{
+		return LengthsSource.data();
+	}
+
+	/// 获取宽度列
+	const float* LightBarTable::Widths() const
+	{
+		return WidthsSource.data();
+	}
+
+	/// 获取方向向量横分量列
+	const float* LightBarTable::DirectionsX() const
+	{
+		return DirectionsXSource.data();
+	}
+
+	/// 获取方向向量纵分量列
+	const float* LightBarTable::DirectionsY() const
+	{
+		return DirectionsYSource.data();
+	}
+
+	/// 获取稳定转角列
+	const float* LightBarTable::StableAngles() const
+	{
+		return StableAnglesSource.data();
+	}
+
+	/// 获取单位方向向量横分量列
+	const float* LightBarTable::UnitDirectionsX() const
+	{
+		return UnitDirectionsXSource.data();
+	}
+
+	/// 获取单位方向向量纵分量列
+	const float* LightBarTable::UnitDirectionsY() const
+	{
+		return UnitDirectionsYSource.data();
+	}
+
+	/// 获取单位正交向量横分量列
+	const float* LightBarTable::OrthogonalsX() const
+	{
+		return OrthogonalsXSource.data();
+	}
+
+	/// 获取单位正交向量纵分量列
+	const float* LightBarTable::OrthogonalsY() const
+	{
+		return OrthogonalsYSource.data();
+	}
+
+	/// 获取边界半径列
+	const float* LightBarTable::BoundaryRadii() const
+	{
+		return BoundaryRadiiSource.data();
+	}
+
+	/// 获取匹配形状列
+	auto LightBarTable::Shapes() const -> const Shape*
+	{
+		return ShapesSource.data();
+	}
+
+	/// 获取外接矩形列
+	const cv::RotatedRect* LightBarTable::Rectangles() const
+	{
+		return RectanglesSource.data();
+	}
+
+	/// 获取中心
+	cv::Point2f LightBarTable::GetCenter(std::size_t index) const
+	{
+		return cv::Point2f(CentersXSource[index], CentersYSource[index]);
+	}
+
+	/// 获取方向向量
+	cv::Vec2f LightBarTable::GetDirection(std::size_t index) const
+	{
+		return cv::Vec2f(DirectionsXSource[index], DirectionsYSource[index]);
+	}
+
+	/// 获取单位方向向量
+	cv::Vec2f LightBarTable::GetUnitDirection(std::size_t index) const
+	{
+		return cv::Vec2f(UnitDirectionsXSource[index], UnitDirectionsYSource[index]);
+	}
+
+	/// 获取单位正交向量
+	cv::Vec2f LightBarTable::GetOrthogonal(std::size_t index) const
+	{
+		return cv::Vec2f(OrthogonalsXSource[index], OrthogonalsYSource[index]);
+	}
+
+	/// 获取灯条参数
+	GeometryFeatureModule::BarParameters LightBarTable::GetBarParameters(std::size_t index) const
+	{
+		return GeometryFeatureModule::BarParameters{GetCenter(index), GetUnitDirection(index),
+											  LengthsSource[index], WidthsSource[index]};
+	}
+
+	/// 获取点到轮廓的外部距离
+	double LightBarTable::GetOutsideDistance(std::size_t index, const cv::Point2f &point, double limit) const
+	{
+		const double delta_x = point.x - CentersXSource[index];
+		const double delta_y = point.y - CentersYSource[index];
+
+		// 轮廓上的点都在以中心为圆心、边界半径为半径的圆内，轮廓边同样在圆内
+		const double lower_bound = std::sqrt(delta_x * delta_x + delta_y * delta_y) - BoundaryRadiiSource[index];
+		if (lower_bound > limit) return lower_bound;
+
+		if (ContourLengthsSource[index] == 0) return std::numeric_limits<double>::max();
+		return -cv::pointPolygonTest(GetContour(index), point, true);
+	}
+
+	/// 获取点到灯条的解析符号距离
+	double LightBarTable::GetSignedDistance(std::size_t index, const cv::Point2f &point) const
+	{
+		if (ShapesSource[index] == Shape::Ellipse)
+		{
+			return GeometryFeatureModule::GetEllipseSignedDistance(point, GetCenter(index), GetUnitDirection(index),
+														  LengthsSource[index], WidthsSource[index]);
+		}
+		return GeometryFeatureModule::GetRectangleSignedDistance(point, GetCenter(index), GetUnitDirection(index),
+															LengthsSource[index], WidthsSource[index]);
+	}
+
+	/// 获取轮廓点数
+	int LightBarTable::GetContourLength(std::size_t index) const
+	{
+		return ContourLengthsSource[index];
+	}
+
+	/// 获取轮廓视图
+	cv::Mat LightBarTable::GetContour(std::size_t index) const
+	{
+		if (ContourLengthsSource[index] == 0) return cv::Mat();
+
+		return cv::Mat(ContourLengthsSource[index], 1, CV_32SC2,
+				 const_cast<cv::Point*>(ContourPointsSource.data() + ContourOffsetsSource[index]));
+	}
+
+	/// 还原几何特征
+	auto LightBarTable::GetFeature(std::size_t index) const -> GeometryFeature
+	{
+		auto begin = ContourPointsSource.begin() + ContourOffsetsSource[index];
+		auto feature = GeometryFeatureModule::StandardizeRotatedRectangle(
+				RectanglesSource[index],
+				std::vector<cv::Point>(begin, begin + ContourLengthsSource[index]));
+		feature.MatchingShape = ShapesSource[index];
+		return feature;
+	}
+
+	//==============================
+	// 修改部分
+	//==============================
+
+	/// 清空
+	void LightBarTable::Clear()
+	{
+		CentersXSource.clear();
+		CentersYSource.clear();
+		AnglesSource.clear();
+		LengthsSource.clear();
+		WidthsSource.clear();
+		DirectionsXSource.clear();
+		DirectionsYSource.clear();
+		StableAnglesSource.clear();
+		UnitDirectionsXSource.clear();
+		UnitDirectionsYSource.clear();
+		OrthogonalsXSource.clear();
+		OrthogonalsYSource.clear();
+		BoundaryRadiiSource.clear();
+		ShapesSource.clear();
+		RectanglesSource.clear();
+
+		ContourOffsetsSource.clear();
+		ContourLengthsSource.clear();
+		ContourPointsSource.clear();
+	}
+
+	/// 预留容量
+	void LightBarTable::Reserve(std::size_t count, std::size_t contour_points)
+	{
+		CentersXSource.reserve(count);
+		CentersYSource.reserve(count);
+		AnglesSource.reserve(count);
+		LengthsSource.reserve(count);
+		WidthsSource.reserve(count);
+		DirectionsXSource.reserve(count);
+		DirectionsYSource.reserve(count);
+		StableAnglesSource.reserve(count);
+		UnitDirectionsXSource.reserve(count);
+		UnitDirectionsYSource.reserve(count);
+		OrthogonalsXSource.reserve(count);
+		OrthogonalsYSource.reserve(count);
+		BoundaryRadiiSource.reserve(count);
+		ShapesSource.reserve(count);
+		RectanglesSource.reserve(count);
+
+		ContourOffsetsSource.reserve(count);
+		ContourLengthsSource.reserve(count);
+		ContourPointsSource.reserve(contour_points);
+	}
+
+	/// 添加候选
+	std::size_t LightBarTable::Append(const GeometryFeature &feature)
+	{
+		// 中心沿用几何特征中的整数坐标，使匹配结果与几何特征完全一致
+		CentersXSource.push_back(static_cast<float>(feature.Center.x));
+		CentersYSource.push_back(static_cast<float>(feature.Center.y));
+		AnglesSource.push_back(static_cast<float>(feature.Angle));
+		LengthsSource.push_back(static_cast<float>(feature.Length));
+		WidthsSource.push_back(static_cast<float>(feature.Width));
+		DirectionsXSource.push_back(feature.Vectors.Direction(0));
+		DirectionsYSource.push_back(feature.Vectors.Direction(1));
+		ShapesSource.push_back(feature.MatchingShape);
+		RectanglesSource.push_back(feature.Raw.CircumscribedRectangle);
+
+		ContourOffsetsSource.push_back(static_cast<int>(ContourPointsSource.size()));
+		ContourLengthsSource.push_back(static_cast<int>(feature.Raw.Contour.size()));
+		ContourPointsSource.insert(ContourPointsSource.end(), feature.Raw.Contour.begin(), feature.Raw.Contour.end());
+
+		//==============================
+		// 计算派生量
+		//==============================
+
+		// 椭圆匹配的转角已经来自椭圆拟合，只有矩形匹配的候选需要重新拟合
+		double stable_angle = feature.Angle;
+		if (feature.MatchingShape != Shape::Ellipse && feature.Raw.Contour.size() > 5)
+		{
+			stable_angle = GeometryFeatureModule::StandardizeRotatedRectangle(
+					cv::fitEllipseDirect(feature.Raw.Contour)).Angle;
+		}
+		StableAnglesSource.push_back(static_cast<float>(stable_angle));
+
+		const double direction_x = feature.Vectors.Direction(0);
+		const double direction_y = feature.Vectors.Direction(1);
+		const double norm = std::sqrt(direction_x * direction_x + direction_y * direction_y);
+		const auto unit_x = static_cast<float>(norm > 0 ? direction_x / norm : 0.0);
+		const auto unit_y = static_cast<float>(norm > 0 ? direction_y / norm : 0.0);
+		UnitDirectionsXSource.push_back(unit_x);
+		UnitDirectionsYSource.push_back(unit_y);
+		OrthogonalsXSource.push_back(-unit_y);
+		OrthogonalsYSource.push_back(unit_x);
+
+		double square_radius = 0.0;
+		for (const auto& point : feature.Raw.Contour)
+		{
+			const double delta_x = point.x - feature.Center.x;
+			const double delta_y = point.y - feature.Center.y;
+			square_radius = std::max(square_radius, delta_x * delta_x + delta_y * delta_y);
+		}
+		// 向上取整，避免浮点误差使下界略大于真实距离
+		BoundaryRadiiSource.push_back(std::nextafter(static_cast<float>(std::sqrt(square_radius)),
+											   std::numeric_limits<float>::max()));
+
+		return ShapesSource.size() - 1;
+	}
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+#include <opencv4/opencv2/opencv.hpp>
+
+#include "GeometryFeatureModule.hpp"
+
+namespace RoboPioneers::Modules
+{
+	/**
+	 * @brief 灯条候选表
+	 * @author Vincent
+	 * @details
+	 *  ~ 以结构数组的形式存储灯条候选：中心、转角、长宽与方向向量的各分量分别存储在按缓存行对齐的连续float数组中，
+	 *    两两匹配时只需顺序读取需要的列，便于向量化。
+	 *  ~ 轮廓不随候选存储，而是连续存放在表内的轮廓点集中，候选只记录起始下标与点数。
+	 *  ~ 清空时保留容量，在帧间复用时不会重新分配内存。
+	 */
+	class LightBarTable
+	{
+	public:
+		/// 几何特征
+		using GeometryFeature = GeometryFeatureModule::GeometryFeature;
+		/// 匹配形状
+		using Shape = GeometryFeature::Shape;
+		/// 候选下标对，较小的下标在前
+		using IndexPair = std::pair<std::size_t, std::size_t>;
+
+		/// 列的对齐字节数，为一个缓存行
+		static constexpr std::size_t Alignment = 64;
+
+		/// 按缓存行对齐的分配器
+		template <typename Type>
+		struct AlignedAllocator
+		{
+			using value_type = Type;
+
+			AlignedAllocator() noexcept = default;
+			template <typename OtherType>
+			explicit AlignedAllocator(const AlignedAllocator<OtherType>&) noexcept {}
+
+			/// 分配内存
+			Type* allocate(std::size_t count)
+			{
+				return static_cast<Type*>(::operator new(count * sizeof(Type), std::align_val_t(Alignment)));
+			}
+
+			/// 释放内存
+			void deallocate(Type* pointer, std::size_t) noexcept
+			{
+				::operator delete(pointer, std::align_val_t(Alignment));
+			}
+
+			template <typename OtherType>
+			bool operator==(const AlignedAllocator<OtherType>&) const noexcept { return true; }
+			template <typename OtherType>
+			bool operator!=(const AlignedAllocator<OtherType>&) const noexcept { return false; }
+		};
+
+		/// 对齐的列
+		template <typename Type>
+		using Column = std::vector<Type, AlignedAllocator<Type>>;
+
+	private:
+		/// 中心横坐标
+		Column<float> CentersXSource;
+		/// 中心纵坐标
+		Column<float> CentersYSource;
+		/// 标准化转角
+		Column<float> AnglesSource;
+		/// 长度
+		Column<float> LengthsSource;
+		/// 宽度
+		Column<float> WidthsSource;
+		/// 方向向量横分量
+		Column<float> DirectionsXSource;
+		/// 方向向量纵分量
+		Column<float> DirectionsYSource;
+		/// 稳定转角，为轮廓拟合椭圆的标准化转角
+		Column<float> StableAnglesSource;
+		/// 单位方向向量横分量
+		Column<float> UnitDirectionsXSource;
+		/// 单位方向向量纵分量
+		Column<float> UnitDirectionsYSource;
+		/// 单位正交向量横分量，为单位方向向量逆时针旋转90度
+		Column<float> OrthogonalsXSource;
+		/// 单位正交向量纵分量
+		Column<float> OrthogonalsYSource;
+		/// 边界半径，为中心到轮廓点的最大距离
+		Column<float> BoundaryRadiiSource;
+		/// 匹配形状
+		std::vector<Shape> ShapesSource;
+		/// 未标准化的外接矩形，只在还原几何特征时使用
+		std::vector<cv::RotatedRect> RectanglesSource;
+
+		/// 轮廓起始下标
+		std::vector<int> ContourOffsetsSource;
+		/// 轮廓点数
+		std::vector<int> ContourLengthsSource;
+		/// 所有候选的轮廓点
+		std::vector<cv::Point> ContourPointsSource;
+
+	public:
+		//==============================
+		// 属性部分
+		//==============================
+
+		/// 获取候选数量
+		[[nodiscard]] std::size_t Size() const;
+		/// 判断是否为空
+		[[nodiscard]] bool Empty() const;
+
+		/// 获取中心横坐标列
+		[[nodiscard]] const float* CentersX() const;
+		/// 获取中心纵坐标列
+		[[nodiscard]] const float* CentersY() const;
+		/// 获取标准化转角列
+		[[nodiscard]] const float* Angles() const;
+		/// 获取长度列
+		[[nodiscard]] const float* Lengths() const;
+		/// 获取宽度列
+		[[nodiscard]] const float* Widths() const;
+		/// 获取方向向量横分量列
+		[[nodiscard]] const float* DirectionsX() const;
+		/// 获取方向向量纵分量列
+		[[nodiscard]] const float* DirectionsY() const;
+		/// 获取稳定转角列
+		[[nodiscard]] const float* StableAngles() const;
+		/// 获取单位方向向量横分量列
+		[[nodiscard]] const float* UnitDirectionsX() const;
+		/// 获取单位方向向量纵分量列
+		[[nodiscard]] const float* UnitDirectionsY() const;
+		/// 获取单位正交向量横分量列
+		[[nodiscard]] const float* OrthogonalsX() const;
+		/// 获取单位正交向量纵分量列
+		[[nodiscard]] const float* OrthogonalsY() const;
+		/// 获取边界半径列
+		[[nodiscard]] const float* BoundaryRadii() const;
+		/// 获取匹配形状列
+		[[nodiscard]] const Shape* Shapes() const;
+		/// 获取外接矩形列
+		[[nodiscard]] const cv::RotatedRect* Rectangles() const;
+
+		/// 获取中心
+		[[nodiscard]] cv::Point2f GetCenter(std::size_t index) const;
+		/// 获取方向向量
+		[[nodiscard]] cv::Vec2f GetDirection(std::size_t index) const;
+		/// 获取单位方向向量
+		[[nodiscard]] cv::Vec2f GetUnitDirection(std::size_t index) const;
+		/// 获取单位正交向量
+		[[nodiscard]] cv::Vec2f GetOrthogonal(std::size_t index) const;
+		/// 获取以旋转矩形描述的灯条参数
+		[[nodiscard]] GeometryFeatureModule::BarParameters GetBarParameters(std::size_t index) const;
+
+		/**
+		 * @brief 获取点到轮廓的外部距离
+		 * @param index 候选下标
+		 * @param point 点
+		 * @param limit 关心的距离上限
+		 * @return 点在轮廓外时为正的距离，在轮廓内时为负的距离，与-cv::pointPolygonTest一致
+		 * @details
+		 *  ~ 先以边界半径求距离的下界，下界已经超过上限时直接返回下界，不遍历轮廓。
+		 *  ~ 因此返回值大于上限时只保证大于上限，不保证是精确距离。
+		 */
+		[[nodiscard]] double GetOutsideDistance(std::size_t index, const cv::Point2f& point, double limit) const;
+
+		/**
+		 * @brief 获取点到灯条的解析符号距离
+		 * @param index 候选下标
+		 * @param point 点
+		 * @return 点在灯条外时为正，在灯条内时为负
+		 * @details
+		 *  ~ 椭圆匹配的候选视为椭圆，其余视为旋转矩形，只使用中心、单位方向向量与长宽，不遍历轮廓。
+		 *  ~ 与GetOutsideDistance的差别在于以拟合形状代替轮廓，对边缘不规则的轮廓两者会略有差异。
+		 */
+		[[nodiscard]] double GetSignedDistance(std::size_t index, const cv::Point2f& point) const;
+
+		/// 获取轮廓点数
+		[[nodiscard]] int GetContourLength(std::size_t index) const;
+
+		/**
+		 * @brief 获取轮廓
+		 * @param index 候选下标
+		 * @return CV_32SC2格式的点集，为轮廓点集的视图，不复制数据；轮廓为空时返回空矩阵
+		 */
+		[[nodiscard]] cv::Mat GetContour(std::size_t index) const;
+
+		/**
+		 * @brief 还原几何特征
+		 * @param index 候选下标
+		 * @return 包含轮廓副本的完整几何特征
+		 * @details
+		 *  ~ 供仍然需要完整几何特征的场合使用，会复制轮廓，不应在两两匹配的循环中调用。
+		 */
+		[[nodiscard]] GeometryFeature GetFeature(std::size_t index) const;
+
+		//==============================
+		// 修改部分
+		//==============================
+
+		/// 清空候选，保留容量
+		void Clear();
+
+		/**
+		 * @brief 预留容量
+		 * @param count 候选数量
+		 * @param contour_points 轮廓点总数
+		 */
+		void Reserve(std::size_t count, std::size_t contour_points = 0);
+
+		/**
+		 * @brief 添加候选
+		 * @param feature 几何特征，其轮廓将被复制到表内
+		 * @return 新候选的下标
+		 * @details
+		 *  ~ 同时计算候选的派生量；矩形匹配且轮廓多于5个点的候选需要拟合一次椭圆以得到稳定转角。
+		 */
+		std::size_t Append(const GeometryFeature& feature);
+	};
+}
@@ -1,6 +1,7 @@
 #include "MathUtility.hpp"
 
 #include <cmath>
+#include <opencv4/opencv2/core/hal/intrin.hpp>
 
 namespace RoboPioneers::Modules
 {
@@ -43,6 +44,127 @@ namespace RoboPioneers::Modules
 		return a.ddot(b) / cv::norm(a) / cv::norm(b);
 	}
 
+	/// 批量求正交向量
+	void MathUtility::OrthogonalVectors(std::size_t count, const float *direction_x, const float *direction_y,
+										float *orthogonal_x, float *orthogonal_y)
+	{
+		std::size_t index = 0;
+
+		#if (CV_SIMD || CV_SIMD_SCALABLE)
+		const cv::v_float32 zero = cv::vx_setzero_f32();
+		const auto lanes = static_cast<std::size_t>(cv::VTraits<cv::v_float32>::vlanes());
+		for (; index + lanes <= count; index += lanes)
+		{
+			const cv::v_float32 x = cv::vx_load(direction_x + index);
+			const cv::v_float32 y = cv::vx_load(direction_y + index);
+			cv::v_store(orthogonal_x + index, cv::v_sub(zero, y));
+			cv::v_store(orthogonal_y + index, x);
+		}
+		#endif
+
+		for (; index < count; ++index)
+		{
+			const float x = direction_x[index];
+			orthogonal_x[index] = -direction_y[index];
+			orthogonal_y[index] = x;
+		}
+	}
+
+	/// 批量求线交点
+	void MathUtility::LineCrossPoints(std::size_t count, const LineArrays &line1, const LineArrays &line2,
+									  float *cross_x, float *cross_y, float *valid)
+	{
+		std::size_t index = 0;
+
+		// 线1上的交点为 p1 + t * d1，其中 t = ((p2 - p1) x d2) / (d1 x d2)
+		#if (CV_SIMD || CV_SIMD_SCALABLE)
+		const cv::v_float32 zero = cv::vx_setzero_f32();
+		const cv::v_float32 one = cv::vx_setall_f32(1.0f);
+		const cv::v_float32 threshold = cv::vx_setall_f32(ParallelSlopeThreshold);
+		const auto lanes = static_cast<std::size_t>(cv::VTraits<cv::v_float32>::vlanes());
+		for (; index + lanes <= count; index += lanes)
+		{
+			const cv::v_float32 point1_x = cv::vx_load(line1.PointX + index);
+			const cv::v_float32 point1_y = cv::vx_load(line1.PointY + index);
+			const cv::v_float32 direction1_x = cv::vx_load(line1.DirectionX + index);
+			const cv::v_float32 direction1_y = cv::vx_load(line1.DirectionY + index);
+			const cv::v_float32 direction2_x = cv::vx_load(line2.DirectionX + index);
+			const cv::v_float32 direction2_y = cv::vx_load(line2.DirectionY + index);
+			const cv::v_float32 offset_x = cv::v_sub(cv::vx_load(line2.PointX + index), point1_x);
+			const cv::v_float32 offset_y = cv::v_sub(cv::vx_load(line2.PointY + index), point1_y);
+
+			// 任一方向向量的分量为0时直线水平或竖直，此时以1代替除数，避免产生非数值
+			const cv::v_float32 axis_aligned = cv::v_or(
+					cv::v_or(cv::v_eq(direction1_x, zero), cv::v_eq(direction1_y, zero)),
+					cv::v_or(cv::v_eq(direction2_x, zero), cv::v_eq(direction2_y, zero)));
+			const cv::v_float32 slope1 = cv::v_div(direction1_y, cv::v_select(axis_aligned, one, direction1_x));
+			const cv::v_float32 slope2 = cv::v_div(direction2_y, cv::v_select(axis_aligned, one, direction2_x));
+			const cv::v_float32 rejected = cv::v_or(axis_aligned,
+					cv::v_lt(cv::v_abs(cv::v_sub(slope1, slope2)), threshold));
+
+			const cv::v_float32 determinant = cv::v_sub(cv::v_mul(direction1_x, direction2_y),
+					cv::v_mul(direction1_y, direction2_x));
+			const cv::v_float32 ratio = cv::v_div(
+					cv::v_sub(cv::v_mul(offset_x, direction2_y), cv::v_mul(offset_y, direction2_x)),
+					cv::v_select(rejected, one, determinant));
+			cv::v_store(cross_x + index, cv::v_muladd(ratio, direction1_x, point1_x));
+			cv::v_store(cross_y + index, cv::v_muladd(ratio, direction1_y, point1_y));
+			cv::v_store(valid + index, cv::v_select(rejected, zero, one));
+		}
+		#endif
+
+		for (; index < count; ++index)
+		{
+			const bool axis_aligned = line1.DirectionX[index] == 0 || line1.DirectionY[index] == 0 ||
+					line2.DirectionX[index] == 0 || line2.DirectionY[index] == 0;
+			const bool rejected = axis_aligned ||
+					std::fabs(line1.DirectionY[index] / line1.DirectionX[index] -
+						 line2.DirectionY[index] / line2.DirectionX[index]) < ParallelSlopeThreshold;
+
+			const float determinant = line1.DirectionX[index] * line2.DirectionY[index] -
+					line1.DirectionY[index] * line2.DirectionX[index];
+			const float offset_x = line2.PointX[index] - line1.PointX[index];
+			const float offset_y = line2.PointY[index] - line1.PointY[index];
+			const float ratio = (offset_x * line2.DirectionY[index] - offset_y * line2.DirectionX[index]) /
+					(rejected ? 1.0f : determinant);
+			cross_x[index] = ratio * line1.DirectionX[index] + line1.PointX[index];
+			cross_y[index] = ratio * line1.DirectionY[index] + line1.PointY[index];
+			valid[index] = rejected ? 0.0f : 1.0f;
+		}
+	}
+
+	/// 批量计算夹角余弦
+	void MathUtility::CosIncludedAngles(std::size_t count, const float *a_x, const float *a_y,
+										const float *b_x, const float *b_y, float *results)
+	{
+		std::size_t index = 0;
+
+		#if (CV_SIMD || CV_SIMD_SCALABLE)
+		const auto lanes = static_cast<std::size_t>(cv::VTraits<cv::v_float32>::vlanes());
+		for (; index + lanes <= count; index += lanes)
+		{
+			const cv::v_float32 vector_a_x = cv::vx_load(a_x + index);
+			const cv::v_float32 vector_a_y = cv::vx_load(a_y + index);
+			const cv::v_float32 vector_b_x = cv::vx_load(b_x + index);
+			const cv::v_float32 vector_b_y = cv::vx_load(b_y + index);
+
+			const cv::v_float32 dot = cv::v_muladd(vector_a_x, vector_b_x, cv::v_mul(vector_a_y, vector_b_y));
+			const cv::v_float32 norms = cv::v_sqrt(cv::v_mul(
+					cv::v_muladd(vector_a_x, vector_a_x, cv::v_mul(vector_a_y, vector_a_y)),
+					cv::v_muladd(vector_b_x, vector_b_x, cv::v_mul(vector_b_y, vector_b_y))));
+			cv::v_store(results + index, cv::v_div(dot, norms));
+		}
+		#endif
+
+		for (; index < count; ++index)
+		{
+			const float dot = a_x[index] * b_x[index] + a_y[index] * b_y[index];
+			const float norms = std::sqrt((a_x[index] * a_x[index] + a_y[index] * a_y[index]) *
+					(b_x[index] * b_x[index] + b_y[index] * b_y[index]));
+			results[index] = dot / norms;
+		}
+	}
+
 	/// 缩放矩形
 	cv::Rect MathUtility::ScaleRectangle(const cv::Rect& target, cv::Vec2d scale)
 	{
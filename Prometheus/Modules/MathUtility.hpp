@@ -1,6 +1,7 @@
 #pragma once
 
 #include <opencv4/opencv2/opencv.hpp>
+#include <cstddef>
 #include <optional>
 #include <cmath>
 #include <type_traits>
@@ -83,6 +84,73 @@ namespace RoboPioneers::Modules
 		 */
 		static double CosIncludedAngle(cv::Vec2f a, cv::Vec2f b);
 
+		//==============================
+		// 批量计算部分
+		//==============================
+
+		/// 批量求交点时判定两直线平行的斜率差上限，与LineCrossPoint一致
+		static constexpr float ParallelSlopeThreshold = 0.001f;
+
+		/**
+		 * @brief 批量直线参数
+		 * @details
+		 *  ~ 各数组的第i项描述第i条直线。
+		 */
+		struct LineArrays
+		{
+			/// 线上一点的横坐标
+			const float* PointX;
+			/// 线上一点的纵坐标
+			const float* PointY;
+			/// 方向向量横分量
+			const float* DirectionX;
+			/// 方向向量纵分量
+			const float* DirectionY;
+		};
+
+		/**
+		 * @brief 批量求正交向量
+		 * @param count 数量
+		 * @param direction_x 原方向向量横分量
+		 * @param direction_y 原方向向量纵分量
+		 * @param orthogonal_x 输出的正交向量横分量
+		 * @param orthogonal_y 输出的正交向量纵分量
+		 * @details
+		 *  ~ 与OrthogonalVector一致，为原方向向量逆时针旋转90度。
+		 */
+		static void OrthogonalVectors(std::size_t count, const float* direction_x, const float* direction_y,
+								float* orthogonal_x, float* orthogonal_y);
+
+		/**
+		 * @brief 批量求两条直线的交点
+		 * @param count 数量
+		 * @param line1 各组中的线1
+		 * @param line2 各组中的线2
+		 * @param cross_x 输出的交点横坐标
+		 * @param cross_y 输出的交点纵坐标
+		 * @param valid 输出的有效标志，存在交点时为1，否则为0
+		 * @details
+		 *  ~ 有效性与LineCrossPoint一致：任一直线水平或竖直时无效，两直线斜率之差小于ParallelSlopeThreshold时视为平行。
+		 *    LineCrossPoint对水平直线不求交点，对竖直直线因斜率无穷大得到非数值，两者都不能通过后续的距离检测。
+		 *  ~ 有效的交点以行列式求解，与经过斜率求得的交点只有舍入误差；无效时交点无意义。
+		 */
+		static void LineCrossPoints(std::size_t count, const LineArrays& line1, const LineArrays& line2,
+							  float* cross_x, float* cross_y, float* valid);
+
+		/**
+		 * @brief 批量求向量a与b夹角的cos
+		 * @param count 数量
+		 * @param a_x 向量a的横分量
+		 * @param a_y 向量a的纵分量
+		 * @param b_x 向量b的横分量
+		 * @param b_y 向量b的纵分量
+		 * @param results 输出的夹角余弦值
+		 * @details
+		 *  ~ 以单精度计算，零向量的结果为NaN，与CosIncludedAngle一致。
+		 */
+		static void CosIncludedAngles(std::size_t count, const float* a_x, const float* a_y,
+								const float* b_x, const float* b_y, float* results);
+
 		/**
 		 * @brief 将二维点转换为二维向量
 		 * @param point 点
@@ -0,0 +1,196 @@
+#include "MultiTargetTracker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace RoboPioneers::Modules
+{
+	/// 更新
+	void MultiTargetTracker::Update(const std::vector<Detection> &detections, TimePoint time)
+	{
+		//==============================
+		// 预测所有轨迹
+		//==============================
+
+		for (auto& track : Tracks)
+		{
+			track.Filter.Settings = Settings.Filter;
+			track.Filter.Predict(time);
+			track.Matched = false;
+		}
+
+		//==============================
+		// 收集门限内的关联候选
+		//==============================
+
+		Associations.clear();
+		for (std::size_t track_index = 0; track_index < Tracks.size(); ++track_index)
+		{
+			const auto state = Tracks[track_index].Filter.GetState();
+			const double predicted_area = state.Size.width * state.Size.height;
+			const double sigma = std::sqrt(state.CenterVariance[0] + state.CenterVariance[1]);
+			const double gate = std::max(Settings.GateLengthMultiple * state.Size.width,
+								Settings.GateSigmaMultiple * sigma);
+			if (gate <= 0.0) continue;
+
+			for (std::size_t detection_index = 0; detection_index < detections.size(); ++detection_index)
+			{
+				const auto& detection = detections[detection_index];
+
+				const double distance = std::hypot(detection.Center.x - state.Center.x,
+											 detection.Center.y - state.Center.y);
+				if (distance > gate) continue;
+
+				const double detection_area = detection.Size.width * detection.Size.height;
+				if (std::min(detection_area, predicted_area) <
+					Settings.MinAreaRatio * std::max(detection_area, predicted_area))
+				{
+					continue;
+				}
+
+				Associations.push_back({distance / gate, track_index, detection_index});
+			}
+		}
+
+		//==============================
+		// 按代价从小到大贪心配对
+		//==============================
+
+		// 代价相同时按下标排序，使结果与输入顺序以外的因素无关
+		std::sort(Associations.begin(), Associations.end(), [](const Association& a, const Association& b){
+			if (a.Cost != b.Cost) return a.Cost < b.Cost;
+			if (a.TrackIndex != b.TrackIndex) return a.TrackIndex < b.TrackIndex;
+			return a.DetectionIndex < b.DetectionIndex;
+		});
+
+		DetectionAssigned.assign(detections.size(), false);
+		for (const auto& association : Associations)
+		{
+			auto& track = Tracks[association.TrackIndex];
+			if (track.Matched || DetectionAssigned[association.DetectionIndex]) continue;
+
+			const auto& detection = detections[association.DetectionIndex];
+			track.Filter.Update(detection.Center, detection.Size, time);
+			track.LastRectangle = detection.Rectangle;
+			track.Score = detection.Score;
+			track.Matched = true;
+			DetectionAssigned[association.DetectionIndex] = true;
+		}
+
+		//==============================
+		// 更新轨迹统计量并删除丢失的轨迹
+		//==============================
+
+		for (auto& track : Tracks)
+		{
+			++track.Age;
+			track.History <<= 1;
+			if (track.Matched)
+			{
+				++track.Hits;
+				track.Misses = 0;
+				track.History.set(0);
+				track.Confidence += Settings.ConfidenceGain * (1.0 - track.Confidence);
+			}
+			else
+			{
+				++track.Misses;
+				track.Confidence *= 1.0 - Settings.ConfidenceGain;
+			}
+		}
+
+		Tracks.erase(std::remove_if(Tracks.begin(), Tracks.end(), [this](const Track& track){
+			return track.Misses > Settings.MaxMisses;
+		}), Tracks.end());
+
+		//==============================
+		// 为未关联的观测建立新轨迹
+		//==============================
+
+		for (std::size_t detection_index = 0; detection_index < detections.size(); ++detection_index)
+		{
+			if (DetectionAssigned[detection_index]) continue;
+			if (Tracks.size() >= Settings.MaxTracks) break;
+
+			CreateTrack(detections[detection_index], time, true);
+		}
+	}
+
+	/// 以较早时刻的观测补充轨迹
+	void MultiTargetTracker::Seed(const std::vector<Detection> &detections, TimePoint time)
+	{
+		// 新建的轨迹不参与后续观测的比较，同一次搜索中的观测互不重叠
+		const std::size_t existing_count = Tracks.size();
+		for (const auto& detection : detections)
+		{
+			if (Tracks.size() >= Settings.MaxTracks) break;
+
+			bool covered = false;
+			for (std::size_t track_index = 0; track_index < existing_count && !covered; ++track_index)
+			{
+				const auto& filter = Tracks[track_index].Filter;
+				const auto state = filter.GetState();
+				const double elapsed = std::max(std::chrono::duration<double>(filter.GetTime() - time).count(), 0.0);
+				const double sigma = std::sqrt(state.CenterVariance[0] + state.CenterVariance[1]);
+				const double gate = std::max(Settings.GateLengthMultiple * state.Size.width,
+									Settings.GateSigmaMultiple * sigma) +
+							std::hypot(state.Velocity[0], state.Velocity[1]) * elapsed;
+
+				covered = std::hypot(detection.Center.x - state.Center.x, detection.Center.y - state.Center.y) <= gate;
+			}
+
+			if (!covered)
+			{
+				CreateTrack(detection, time, false);
+			}
+		}
+	}
+
+	/// 以观测建立新轨迹
+	void MultiTargetTracker::CreateTrack(const Detection &detection, TimePoint time, bool matched)
+	{
+		Track track;
+		track.Id = NextId++;
+		track.Filter.Settings = Settings.Filter;
+		track.Filter.Reset(detection.Center, detection.Size, time);
+		track.Age = 1;
+		track.Hits = 1;
+		track.History.set(0);
+		track.Confidence = Settings.ConfidenceGain;
+		track.Score = detection.Score;
+		track.LastRectangle = detection.Rectangle;
+		track.Matched = matched;
+		Tracks.push_back(track);
+	}
+
+	/// 清除所有轨迹
+	void MultiTargetTracker::Clear()
+	{
+		Tracks.clear();
+	}
+
+	/// 获取轨迹列表
+	auto MultiTargetTracker::GetTracks() const -> const std::vector<Track>&
+	{
+		return Tracks;
+	}
+
+	/// 按编号查找轨迹
+	auto MultiTargetTracker::FindTrack(unsigned int id) const -> const Track*
+	{
+		for (const auto& track : Tracks)
+		{
+			if (track.Id == id) return &track;
+		}
+		return nullptr;
+	}
+
+	/// 判断轨迹是否已确认
+	bool MultiTargetTracker::IsConfirmed(const Track &track) const
+	{
+		// 左移舍去近期帧数以外的较早历史
+		const std::size_t frames = std::min<std::size_t>(Settings.HistoryFrames, MaxHistoryFrames);
+		return (track.History << (MaxHistoryFrames - frames)).count() >= Settings.MinHits;
+	}
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <bitset>
+#include <vector>
+#include <opencv4/opencv2/opencv.hpp>
+
+#include "KalmanTracker.hpp"
+
+namespace RoboPioneers::Modules
+{
+	/**
+	 * @brief 多目标跟踪器
+	 * @author Vincent
+	 * @details
+	 *  ~ 为每个目标维护一条带编号的轨迹，轨迹以卡尔曼跟踪器预测目标的位置与大小。
+	 *  ~ 每帧先将所有轨迹预测到采集时刻，再以门限内的中心距离为代价贪心地关联观测与轨迹：
+	 *    代价从小到大依次配对，轨迹与观测都只能使用一次。
+	 *  ~ 未关联的观测建立新轨迹，连续丢失超过上限的轨迹被删除。
+	 *  ~ 近期出现次数达标的轨迹视为已确认，只有已确认的轨迹应当作为射击目标。
+	 *  ~ 来自较早时刻的观测（如后台的全图搜索结果）不参与关联，只以Seed为不在已有轨迹附近的观测建立新轨迹。
+	 */
+	class MultiTargetTracker
+	{
+	public:
+		/// 时间点
+		using TimePoint = KalmanTracker::TimePoint;
+
+		/// 关联历史的最大帧数
+		static constexpr std::size_t MaxHistoryFrames = 32;
+
+		/// 观测
+		struct Detection
+		{
+			/// 装甲板矩形，为全图坐标
+			cv::RotatedRect Rectangle;
+			/// 中心
+			cv::Point2d Center;
+			/// 长宽
+			cv::Size2d Size;
+			/// 评分，越大越适合作为目标
+			double Score {0.0};
+		};
+
+		/// 轨迹
+		struct Track
+		{
+			/// 编号，从1开始递增，不会重复使用
+			unsigned int Id {0};
+			/// 位置与大小的滤波器
+			KalmanTracker Filter;
+			/// 存在的帧数
+			unsigned int Age {0};
+			/// 累计关联成功的帧数
+			unsigned int Hits {0};
+			/// 连续关联失败的帧数
+			unsigned int Misses {0};
+			/// 近期关联历史，最低位为最近一帧，置位表示关联成功
+			std::bitset<MaxHistoryFrames> History;
+			/// 置信度，0.0~1.0，关联成功时上升，失败时下降
+			double Confidence {0.0};
+			/// 最近一次关联的观测评分
+			double Score {0.0};
+			/// 最近一次关联的装甲板矩形
+			cv::RotatedRect LastRectangle;
+			/// 本帧是否关联成功
+			bool Matched {false};
+		};
+
+		/// 跟踪设定
+		struct SettingsType {
+			/// 轨迹滤波设定
+			KalmanTracker::SettingsType Filter;
+			/// 关联门限，为预测长度的倍数
+			double GateLengthMultiple {1.5};
+			/// 关联门限，为预测中心标准差的倍数，与长度门限取较大者
+			double GateSigmaMultiple {3.0};
+			/// 观测与预测的最小面积比，0.0~1.0
+			double MinAreaRatio {0.5};
+			/// 统计出现次数的近期帧数，超过MaxHistoryFrames时按MaxHistoryFrames计
+			unsigned int HistoryFrames {5};
+			/// 确认轨迹所需的近期出现次数
+			unsigned int MinHits {3};
+			/// 连续丢失超过该帧数的轨迹被删除
+			unsigned int MaxMisses {5};
+			/// 置信度的更新系数，0.0~1.0
+			double ConfidenceGain {0.3};
+			/// 最大轨迹数，超出时不再建立新轨迹
+			std::size_t MaxTracks {32};
+		}Settings;
+
+	private:
+		/// 关联候选
+		struct Association
+		{
+			/// 归一化的代价，0.0~1.0
+			double Cost;
+			/// 轨迹下标
+			std::size_t TrackIndex;
+			/// 观测下标
+			std::size_t DetectionIndex;
+		};
+
+		/// 轨迹列表
+		std::vector<Track> Tracks;
+		/// 下一个轨迹编号
+		unsigned int NextId {1};
+
+		/// 关联候选缓冲区
+		std::vector<Association> Associations;
+		/// 各观测是否已经关联
+		std::vector<bool> DetectionAssigned;
+
+		/**
+		 * @brief 以观测建立新轨迹
+		 * @param detection 观测
+		 * @param time 观测时刻
+		 * @param matched 是否视为本帧关联成功
+		 */
+		void CreateTrack(const Detection& detection, TimePoint time, bool matched);
+
+	public:
+		/**
+		 * @brief 以一帧的观测更新
+		 * @param detections 本帧的观测，为全图坐标
+		 * @param time 本帧采集时刻
+		 */
+		void Update(const std::vector<Detection>& detections, TimePoint time);
+
+		/**
+		 * @brief 以较早时刻的观测补充轨迹
+		 * @param detections 观测，为全图坐标
+		 * @param time 观测的采集时刻，可以早于轨迹的时刻
+		 * @details
+		 *  ~ 观测与轨迹的当前状态比较，门限在Update所用门限的基础上加上轨迹速度与时间差之积，
+		 *    不在任何轨迹门限内的观测建立新轨迹，其余观测被忽略。
+		 *  ~ 新轨迹的滤波器从观测时刻开始，在下一次Update时预测到当前帧，不计入当前帧的关联结果。
+		 *  ~ 应当在同一帧的Update之前调用。
+		 */
+		void Seed(const std::vector<Detection>& detections, TimePoint time);
+
+		/// 清除所有轨迹
+		void Clear();
+
+		/// 获取轨迹列表
+		[[nodiscard]] const std::vector<Track>& GetTracks() const;
+
+		/**
+		 * @brief 按编号查找轨迹
+		 * @param id 轨迹编号
+		 * @return 轨迹指针，不存在时为空，在下一次更新前有效
+		 */
+		[[nodiscard]] const Track* FindTrack(unsigned int id) const;
+
+		/// 判断轨迹是否已确认
+		[[nodiscard]] bool IsConfirmed(const Track& track) const;
+	};
+}
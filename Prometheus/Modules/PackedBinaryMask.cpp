@@ -0,0 +1,259 @@
+#include "PackedBinaryMask.hpp"
+
+#include <stdexcept>
+#include <tbb/tbb.h>
+
+#ifndef NO_CUDA
+/// 显存版本的蒙版压缩，实现于PackedBinaryMask.cu
+extern void CUDAPackMask(const cv::cuda::PtrStepSzb& mask, cv::cuda::PtrStepb packed, int words_per_row, void* stream);
+#endif
+
+namespace RoboPioneers::Modules
+{
+	//==============================
+	// 属性部分
+	//==============================
+
+	/// 获取行数
+	int PackedBinaryMask::Rows() const
+	{
+		return RowsSource;
+	}
+
+	/// 获取列数
+	int PackedBinaryMask::Cols() const
+	{
+		return ColsSource;
+	}
+
+	/// 获取每行的字数
+	int PackedBinaryMask::WordsPerRow() const
+	{
+		return WordsPerRowSource;
+	}
+
+	/// 获取尺寸
+	cv::Size PackedBinaryMask::Size() const
+	{
+		return cv::Size(ColsSource, RowsSource);
+	}
+
+	/// 判断是否为空
+	bool PackedBinaryMask::Empty() const
+	{
+		return RowsSource == 0 || ColsSource == 0;
+	}
+
+	/// 获取一行
+	auto PackedBinaryMask::Row(int y) -> Word*
+	{
+		return WordsSource.data() + static_cast<std::size_t>(y) * WordsPerRowSource;
+	}
+
+	/// 获取一行
+	auto PackedBinaryMask::Row(int y) const -> const Word*
+	{
+		return WordsSource.data() + static_cast<std::size_t>(y) * WordsPerRowSource;
+	}
+
+	/// 获取像素值
+	bool PackedBinaryMask::Get(int x, int y) const
+	{
+		return (Row(y)[x / WordBits] >> (x % WordBits)) & Word{1};
+	}
+
+	//==============================
+	// 创建与转换部分
+	//==============================
+
+	/// 创建蒙版
+	void PackedBinaryMask::Create(int rows, int cols)
+	{
+		RowsSource = rows;
+		ColsSource = cols;
+		WordsPerRowSource = (cols + WordBits - 1) / WordBits;
+		WordsSource.assign(static_cast<std::size_t>(rows) * WordsPerRowSource, Word{0});
+	}
+
+	/// 由内存蒙版压缩
+	void PackedBinaryMask::Pack(const cv::Mat &mask)
+	{
+		if (mask.type() != CV_8UC1)
+		{
+			throw std::logic_error("PackedBinaryMask::Pack Mask Must Be CV_8UC1.");
+		}
+
+		Create(mask.rows, mask.cols);
+
+		tbb::parallel_for(tbb::blocked_range<int>(0, RowsSource), [this, &mask](const tbb::blocked_range<int>& range){
+			for (int y = range.begin(); y < range.end(); ++y)
+			{
+				const unsigned char* source = mask.ptr<unsigned char>(y);
+				Word* target = Row(y);
+
+				for (int word_index = 0; word_index < WordsPerRowSource; ++word_index)
+				{
+					const int begin = word_index * WordBits;
+					const int end = std::min(begin + WordBits, ColsSource);
+
+					Word word = 0;
+					for (int x = begin; x < end; ++x)
+					{
+						word |= static_cast<Word>(source[x] != 0) << (x - begin);
+					}
+					target[word_index] = word;
+				}
+			}
+		});
+	}
+
+	#ifndef NO_CUDA
+	/// 由显存蒙版压缩并下载
+	void PackedBinaryMask::Download(const cv::cuda::GpuMat &mask, cv::cuda::GpuMat &device_buffer,
+								 cv::cuda::Stream &stream)
+	{
+		if (mask.type() != CV_8UC1)
+		{
+			throw std::logic_error("PackedBinaryMask::Download Mask Must Be CV_8UC1.");
+		}
+
+		Create(mask.rows, mask.cols);
+		if (Empty()) return;
+
+		const int bytes_per_row = WordsPerRowSource * static_cast<int>(sizeof(Word));
+		device_buffer.create(RowsSource, bytes_per_row, CV_8UC1);
+
+		CUDAPackMask(mask, device_buffer, WordsPerRowSource, stream.cudaPtr());
+
+		// 以自身的字数据作为下载目标，避免额外复制
+		cv::Mat host_buffer(RowsSource, bytes_per_row, CV_8UC1, WordsSource.data());
+		device_buffer.download(host_buffer, stream);
+		stream.waitForCompletion();
+	}
+	#endif
+
+	/// 解压
+	void PackedBinaryMask::Unpack(cv::Mat &mask) const
+	{
+		mask.create(RowsSource, ColsSource, CV_8UC1);
+
+		tbb::parallel_for(tbb::blocked_range<int>(0, RowsSource), [this, &mask](const tbb::blocked_range<int>& range){
+			for (int y = range.begin(); y < range.end(); ++y)
+			{
+				const Word* source = Row(y);
+				unsigned char* target = mask.ptr<unsigned char>(y);
+
+				for (int x = 0; x < ColsSource; ++x)
+				{
+					target[x] = ((source[x / WordBits] >> (x % WordBits)) & Word{1}) ? 255 : 0;
+				}
+			}
+		});
+	}
+
+	//==============================
+	// 形态学运算部分
+	//==============================
+
+	/// 十字形膨胀
+	void PackedBinaryMask::DilateCross(const PackedBinaryMask &source, PackedBinaryMask &target, int radius)
+	{
+		MorphologyCross(source, target, radius, true);
+	}
+
+	/// 十字形腐蚀
+	void PackedBinaryMask::ErodeCross(const PackedBinaryMask &source, PackedBinaryMask &target, int radius)
+	{
+		MorphologyCross(source, target, radius, false);
+	}
+
+	/// 十字形闭运算
+	void PackedBinaryMask::CloseCross(PackedBinaryMask &temporary, int radius)
+	{
+		DilateCross(*this, temporary, radius);
+		ErodeCross(temporary, *this, radius);
+	}
+
+	/// 获取最后一个字的有效位掩码
+	auto PackedBinaryMask::GetTailMask() const -> Word
+	{
+		const int tail_bits = ColsSource % WordBits;
+		return tail_bits == 0 ? ~Word{0} : (Word{1} << tail_bits) - 1;
+	}
+
+	/// 十字形形态学运算
+	void PackedBinaryMask::MorphologyCross(const PackedBinaryMask &source, PackedBinaryMask &target,
+										int radius, bool dilate)
+	{
+		if (&source == &target)
+		{
+			throw std::logic_error("PackedBinaryMask::MorphologyCross Source And Target Must Be Different.");
+		}
+		if (radius < 0 || radius >= WordBits)
+		{
+			throw std::logic_error("PackedBinaryMask::MorphologyCross Radius Must Be in [0, 63].");
+		}
+
+		target.Create(source.RowsSource, source.ColsSource);
+		if (source.Empty()) return;
+
+		const int words_per_row = source.WordsPerRowSource;
+		const int rows = source.RowsSource;
+		// 膨胀时蒙版外视为0，腐蚀时蒙版外视为1，二者均使边界不影响结果
+		const Word border = dilate ? Word{0} : ~Word{0};
+		const Word tail_mask = source.GetTailMask();
+
+		tbb::parallel_for(tbb::blocked_range<int>(0, rows), [&](const tbb::blocked_range<int>& range){
+			// 在行首尾各补一个边界字，使水平移位不需要判断边界
+			std::vector<Word> padded(words_per_row + 2);
+
+			for (int y = range.begin(); y < range.end(); ++y)
+			{
+				const Word* source_row = source.Row(y);
+				Word* target_row = target.Row(y);
+
+				padded.front() = border;
+				std::copy(source_row, source_row + words_per_row, padded.begin() + 1);
+				padded.back() = border;
+				padded[words_per_row] |= border & ~tail_mask;
+
+				for (int word_index = 0; word_index < words_per_row; ++word_index)
+				{
+					const Word previous = padded[word_index];
+					const Word current = padded[word_index + 1];
+					const Word next = padded[word_index + 2];
+
+					//==============================
+					// 水平臂
+					//==============================
+
+					Word result = current;
+					for (int shift = 1; shift <= radius; ++shift)
+					{
+						// 第x位取第x-shift列与第x+shift列的值
+						const Word left = (current << shift) | (previous >> (WordBits - shift));
+						const Word right = (current >> shift) | (next << (WordBits - shift));
+						result = dilate ? (result | left | right) : (result & left & right);
+					}
+
+					//==============================
+					// 竖直臂，蒙版外的行对结果没有影响，直接跳过
+					//==============================
+
+					const int row_begin = std::max(y - radius, 0);
+					const int row_end = std::min(y + radius, rows - 1);
+					for (int row = row_begin; row <= row_end; ++row)
+					{
+						if (row == y) continue;
+						const Word neighbour = source.Row(row)[word_index];
+						result = dilate ? (result | neighbour) : (result & neighbour);
+					}
+
+					target_row[word_index] = result;
+				}
+
+				target_row[words_per_row - 1] &= tail_mask;
+			}
+		});
+	}
+}
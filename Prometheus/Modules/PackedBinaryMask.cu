@@ -0,0 +1,34 @@
+#include <opencv4/opencv2/core/cuda_types.hpp>
+
+/**
+ * @brief 蒙版压缩核函数
+ * @details
+ *  ~ 每个线程束处理一行中连续的32个像素，通过投票得到32位的压缩结果，由首个线程写出。
+ *  ~ 64位字在小端序下由两个32位半字组成，低半字在前，因此按32位写出即可得到64位字的布局。
+ */
+__global__ void PackMaskKernel(const cv::cuda::PtrStepSzb mask, cv::cuda::PtrStepb packed, int half_words_per_row)
+{
+	const int x = blockIdx.x * blockDim.x + threadIdx.x;
+	const int y = blockIdx.y;
+
+	if (y >= mask.rows || x >= half_words_per_row * 32) return;
+
+	const bool value = x < mask.cols && mask.ptr(y)[x] != 0;
+	const unsigned int bits = __ballot_sync(0xFFFFFFFFu, value);
+
+	if ((threadIdx.x & 31) == 0)
+	{
+		reinterpret_cast<unsigned int*>(packed.ptr(y))[x >> 5] = bits;
+	}
+}
+
+/// 显存版本的蒙版压缩
+void CUDAPackMask(const cv::cuda::PtrStepSzb& mask, cv::cuda::PtrStepb packed, int words_per_row, void* stream)
+{
+	// 每行的线程数为32的整数倍，保证投票时线程束完整
+	const int half_words_per_row = words_per_row * 2;
+	const dim3 block(128, 1);
+	const dim3 grid((half_words_per_row * 32 + block.x - 1) / block.x, mask.rows);
+
+	PackMaskKernel<<<grid, block, 0, static_cast<cudaStream_t>(stream)>>>(mask, packed, half_words_per_row);
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <opencv4/opencv2/opencv.hpp>
+
+namespace RoboPioneers::Modules
+{
+	/**
+	 * @brief 位压缩二值蒙版
+	 * @author Vincent
+	 * @details
+	 *  ~ 每个像素占用一位，每64个像素组成一个字，每行从字边界开始。
+	 *  ~ 第x列像素位于该行第x/64个字的第x%64位，低位在前。
+	 *  ~ 每行最后一个字中超出列数的位始终为0。
+	 *  ~ 与8位蒙版相比，存储与传输的数据量为其1/8，形态学运算可以一次处理64个像素。
+	 */
+	class PackedBinaryMask
+	{
+	public:
+		/// 字类型
+		using Word = std::uint64_t;
+		/// 每个字的位数
+		static constexpr int WordBits = 64;
+
+	private:
+		/// 行数
+		int RowsSource {0};
+		/// 列数
+		int ColsSource {0};
+		/// 每行的字数
+		int WordsPerRowSource {0};
+		/// 字数据，按行连续存储
+		std::vector<Word> WordsSource;
+
+	public:
+		//==============================
+		// 属性部分
+		//==============================
+
+		/// 获取行数
+		[[nodiscard]] int Rows() const;
+		/// 获取列数
+		[[nodiscard]] int Cols() const;
+		/// 获取每行的字数
+		[[nodiscard]] int WordsPerRow() const;
+		/// 获取尺寸
+		[[nodiscard]] cv::Size Size() const;
+		/// 判断是否为空
+		[[nodiscard]] bool Empty() const;
+
+		/// 获取一行的字数据
+		[[nodiscard]] Word* Row(int y);
+		/// 获取一行的字数据
+		[[nodiscard]] const Word* Row(int y) const;
+
+		/**
+		 * @brief 获取像素值
+		 * @param x 列
+		 * @param y 行
+		 * @return 像素是否被设置
+		 */
+		[[nodiscard]] bool Get(int x, int y) const;
+
+		//==============================
+		// 创建与转换部分
+		//==============================
+
+		/**
+		 * @brief 创建蒙版
+		 * @param rows 行数
+		 * @param cols 列数
+		 * @details
+		 *  ~ 所有像素被清零，容量足够时不会重新分配内存。
+		 */
+		void Create(int rows, int cols);
+
+		/**
+		 * @brief 由内存中的8位蒙版压缩
+		 * @param mask CV_8UC1蒙版，非0像素被视为设置
+		 */
+		void Pack(const cv::Mat& mask);
+
+		#ifndef NO_CUDA
+		/**
+		 * @brief 由显存中的8位蒙版压缩并下载
+		 * @param mask CV_8UC1蒙版，非0像素被视为设置
+		 * @param device_buffer 显存中的压缩缓冲区，尺寸不符时才会重新分配，应当在帧间复用
+		 * @param stream CUDA流，调用返回时下载已经完成
+		 * @details
+		 *  ~ 在显存中完成压缩，只下载压缩后的数据。
+		 */
+		void Download(const cv::cuda::GpuMat& mask, cv::cuda::GpuMat& device_buffer,
+				cv::cuda::Stream& stream = cv::cuda::Stream::Null());
+		#endif
+
+		/**
+		 * @brief 解压为8位蒙版
+		 * @param mask 输出CV_8UC1蒙版，设置的像素为255，否则为0；尺寸不符时才会重新分配
+		 */
+		void Unpack(cv::Mat& mask) const;
+
+		//==============================
+		// 形态学运算部分
+		//==============================
+
+		/**
+		 * @brief 十字形膨胀
+		 * @param source 源蒙版
+		 * @param target 目标蒙版，不能与源蒙版相同
+		 * @param radius 十字的臂长，5x5十字对应2，范围为0~63
+		 * @details
+		 *  ~ 蒙版之外的像素被视为未设置。
+		 */
+		static void DilateCross(const PackedBinaryMask& source, PackedBinaryMask& target, int radius);
+
+		/**
+		 * @brief 十字形腐蚀
+		 * @param source 源蒙版
+		 * @param target 目标蒙版，不能与源蒙版相同
+		 * @param radius 十字的臂长，5x5十字对应2，范围为0~63
+		 * @details
+		 *  ~ 蒙版之外的像素被视为已设置，即边界不会向内腐蚀，与cv::erode的默认边界一致。
+		 */
+		static void ErodeCross(const PackedBinaryMask& source, PackedBinaryMask& target, int radius);
+
+		/**
+		 * @brief 十字形闭运算
+		 * @param temporary 临时蒙版，应当在帧间复用
+		 * @param radius 十字的臂长，5x5十字对应2
+		 * @details
+		 *  ~ 先膨胀后腐蚀，结果写回自身。
+		 *  ~ 结果与以BORDER_REFLECT_101填充边界的闭运算一致，即cv::cuda::createMorphologyFilter的边界规则：
+		 *    十字以中心为锚点时，反射到蒙版外的像素总是落在同一十字覆盖的蒙版内像素上，
+		 *    因此膨胀与腐蚀各自的结果都与蒙版外像素不参与运算时相同。
+		 */
+		void CloseCross(PackedBinaryMask& temporary, int radius);
+
+	protected:
+		/// 获取最后一个字中有效位的掩码
+		[[nodiscard]] Word GetTailMask() const;
+
+		/**
+		 * @brief 十字形形态学运算
+		 * @param source 源蒙版
+		 * @param target 目标蒙版
+		 * @param radius 十字的臂长
+		 * @param dilate 为真时膨胀，为假时腐蚀
+		 */
+		static void MorphologyCross(const PackedBinaryMask& source, PackedBinaryMask& target, int radius, bool dilate);
+	};
+}
@@ -0,0 +1,302 @@
+#include "RunLengthLabeler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <numeric>
+#include <tbb/tbb.h>
+
+namespace RoboPioneers::Modules
+{
+	namespace
+	{
+		using Word = PackedBinaryMask::Word;
+
+		/**
+		 * @brief 查找下一个指定值的像素
+		 * @param row 行的字数据
+		 * @param words_per_row 每行字数
+		 * @param from 起始列
+		 * @param value 要查找的值
+		 * @return 第一个不小于起始列且值符合的像素的列，不存在时返回行的位数
+		 * @details
+		 *  ~ 行尾多余的位为0，因此查找0时最多返回列数。
+		 */
+		int FindNextPixel(const Word* row, int words_per_row, int from, bool value)
+		{
+			int word_index = from / PackedBinaryMask::WordBits;
+			if (word_index >= words_per_row) return words_per_row * PackedBinaryMask::WordBits;
+
+			Word word = (value ? row[word_index] : ~row[word_index]) & (~Word{0} << (from % PackedBinaryMask::WordBits));
+			while (word == 0)
+			{
+				if (++word_index >= words_per_row) return words_per_row * PackedBinaryMask::WordBits;
+				word = value ? row[word_index] : ~row[word_index];
+			}
+			return word_index * PackedBinaryMask::WordBits + __builtin_ctzll(word);
+		}
+
+		/// 自然数前缀的幂和，Σ_{i=0}^{n} i^k，k = 1, 2, 3
+		inline double PowerSum1(double n) { return n * (n + 1) / 2; }
+		inline double PowerSum2(double n) { return n * (n + 1) * (2 * n + 1) / 6; }
+		inline double PowerSum3(double n) { double s = PowerSum1(n); return s * s; }
+	}
+
+	/// 获取边界视图
+	cv::Mat RunLengthLabeler::Result::GetBoundary(std::size_t index) const
+	{
+		const auto& blob = Blobs[index];
+		if (blob.BoundaryLength == 0) return cv::Mat();
+
+		return cv::Mat(blob.BoundaryLength, 1, CV_32SC2,
+				 const_cast<cv::Point*>(BoundaryPoints.data() + blob.BoundaryOffset));
+	}
+
+	/// 标记连通域
+	void RunLengthLabeler::Label(const PackedBinaryMask &mask, Result &result)
+	{
+		result.Blobs.clear();
+		result.BoundaryPoints.clear();
+
+		const int rows = mask.Rows();
+		const int cols = mask.Cols();
+		if (mask.Empty()) return;
+
+		const int stripe_rows = std::max(Settings.StripeRows, 1);
+		const int stripes = (rows + stripe_rows - 1) / stripe_rows;
+
+		//==============================
+		// 按条带并行提取游程
+		//==============================
+
+		StripeRuns.resize(stripes);
+		RowRunCounts.assign(rows, 0);
+
+		tbb::parallel_for(0, stripes, [&](int stripe){
+			auto& runs = StripeRuns[stripe];
+			runs.clear();
+
+			const int row_end = std::min((stripe + 1) * stripe_rows, rows);
+			for (int y = stripe * stripe_rows; y < row_end; ++y)
+			{
+				const Word* row = mask.Row(y);
+				const auto count_before = runs.size();
+
+				for (int x = FindNextPixel(row, mask.WordsPerRow(), 0, true); x < cols;
+					 x = FindNextPixel(row, mask.WordsPerRow(), x, true))
+				{
+					const int end = std::min(FindNextPixel(row, mask.WordsPerRow(), x, false), cols);
+					runs.push_back(Run{x, end - 1});
+					x = end;
+				}
+				RowRunCounts[y] = static_cast<int>(runs.size() - count_before);
+			}
+		});
+
+		RowOffsets.resize(rows + 1);
+		RowOffsets[0] = 0;
+		std::partial_sum(RowRunCounts.begin(), RowRunCounts.end(), RowOffsets.begin() + 1);
+
+		const int run_count = RowOffsets[rows];
+		if (run_count == 0) return;
+
+		Runs.resize(run_count);
+		Parents.resize(run_count);
+		std::iota(Parents.begin(), Parents.end(), 0);
+
+		//==============================
+		// 按条带并行连接条带内的行
+		//==============================
+
+		// 条带内的合并只涉及条带内的游程，各条带的并查集互不相交
+		tbb::parallel_for(0, stripes, [&](int stripe){
+			const int row_begin = stripe * stripe_rows;
+			const int row_end = std::min(row_begin + stripe_rows, rows);
+
+			std::copy(StripeRuns[stripe].begin(), StripeRuns[stripe].end(), Runs.begin() + RowOffsets[row_begin]);
+			for (int y = row_begin + 1; y < row_end; ++y)
+			{
+				ConnectRows(y);
+			}
+		});
+
+		//==============================
+		// 合并条带边界
+		//==============================
+
+		for (int stripe = 1; stripe < stripes; ++stripe)
+		{
+			ConnectRows(stripe * stripe_rows);
+		}
+
+		//==============================
+		// 分配编号并统计
+		//==============================
+
+		// 根节点为集合中下标最小的游程，按下标顺序遍历时根节点总是先于其他成员出现
+		Labels.resize(run_count);
+		Accumulators.clear();
+		for (int y = 0; y < rows; ++y)
+		{
+			const double row = y;
+			for (int index = RowOffsets[y]; index < RowOffsets[y + 1]; ++index)
+			{
+				const int root = Find(index);
+				if (root == index)
+				{
+					Labels[index] = static_cast<int>(Accumulators.size());
+					Accumulators.emplace_back();
+				}
+				else
+				{
+					Labels[index] = Labels[root];
+				}
+
+				const auto& run = Runs[index];
+				auto& accumulator = Accumulators[Labels[index]];
+
+				// 游程[Begin, End]上各阶幂和
+				const double count = run.End - run.Begin + 1;
+				const double sum1 = PowerSum1(run.End) - PowerSum1(run.Begin - 1);
+				const double sum2 = PowerSum2(run.End) - PowerSum2(run.Begin - 1);
+				const double sum3 = PowerSum3(run.End) - PowerSum3(run.Begin - 1);
+
+				auto& moments = accumulator.Moments;
+				moments[0] += count;
+				moments[1] += sum1;
+				moments[2] += count * row;
+				moments[3] += sum2;
+				moments[4] += sum1 * row;
+				moments[5] += count * row * row;
+				moments[6] += sum3;
+				moments[7] += sum2 * row;
+				moments[8] += sum1 * row * row;
+				moments[9] += count * row * row * row;
+
+				accumulator.TopLeft.x = std::min(accumulator.TopLeft.x, run.Begin);
+				accumulator.TopLeft.y = std::min(accumulator.TopLeft.y, y);
+				accumulator.BottomRight.x = std::max(accumulator.BottomRight.x, run.End);
+				accumulator.BottomRight.y = std::max(accumulator.BottomRight.y, y);
+			}
+		}
+
+		//==============================
+		// 生成连通域
+		//==============================
+
+		BlobIndices.assign(Accumulators.size(), -1);
+		int boundary_length = 0;
+
+		for (std::size_t label = 0; label < Accumulators.size(); ++label)
+		{
+			const auto& accumulator = Accumulators[label];
+			const auto& m = accumulator.Moments;
+			if (m[0] < Settings.MinimumArea) continue;
+
+			Blob blob;
+			blob.Area = static_cast<int>(m[0]);
+			blob.BoundingBox = cv::Rect(accumulator.TopLeft, accumulator.BottomRight + cv::Point(1, 1));
+			blob.Centroid = cv::Point2d(m[1] / m[0], m[2] / m[0]);
+			blob.Moments = cv::Moments(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9]);
+
+			if (Settings.ExtractBoundary)
+			{
+				// 连通域的每一行至少有一个像素，左右两侧各贡献一个点
+				blob.BoundaryOffset = boundary_length;
+				blob.BoundaryLength = 2 * blob.BoundingBox.height;
+				boundary_length += blob.BoundaryLength;
+			}
+
+			BlobIndices[label] = static_cast<int>(result.Blobs.size());
+			result.Blobs.push_back(blob);
+		}
+
+		//==============================
+		// 提取紧凑边界
+		//==============================
+
+		if (!Settings.ExtractBoundary) return;
+
+		// 左侧点自上而下，右侧点自下而上，组成闭合多边形
+		result.BoundaryPoints.resize(boundary_length);
+		for (const auto& blob : result.Blobs)
+		{
+			for (int offset = 0; offset < blob.BoundingBox.height; ++offset)
+			{
+				const int y = blob.BoundingBox.y + offset;
+				result.BoundaryPoints[blob.BoundaryOffset + offset] = cv::Point(INT_MAX, y);
+				result.BoundaryPoints[blob.BoundaryOffset + blob.BoundaryLength - 1 - offset] = cv::Point(-1, y);
+			}
+		}
+
+		for (int y = 0; y < rows; ++y)
+		{
+			for (int index = RowOffsets[y]; index < RowOffsets[y + 1]; ++index)
+			{
+				const int blob_index = BlobIndices[Labels[index]];
+				if (blob_index < 0) continue;
+
+				const auto& blob = result.Blobs[blob_index];
+				const int offset = y - blob.BoundingBox.y;
+				auto& left = result.BoundaryPoints[blob.BoundaryOffset + offset];
+				auto& right = result.BoundaryPoints[blob.BoundaryOffset + blob.BoundaryLength - 1 - offset];
+
+				left.x = std::min(left.x, Runs[index].Begin);
+				right.x = std::max(right.x, Runs[index].End);
+			}
+		}
+	}
+
+	/// 连接相邻两行
+	void RunLengthLabeler::ConnectRows(int row)
+	{
+		int upper = RowOffsets[row - 1];
+		const int upper_end = RowOffsets[row];
+		int lower = RowOffsets[row];
+		const int lower_end = RowOffsets[row + 1];
+
+		// 两行的游程均按列有序，8邻域下列区间相差不超过1即相连
+		while (upper < upper_end && lower < lower_end)
+		{
+			const auto& a = Runs[upper];
+			const auto& b = Runs[lower];
+
+			if (a.End + 1 < b.Begin)
+			{
+				++upper;
+			}
+			else if (b.End + 1 < a.Begin)
+			{
+				++lower;
+			}
+			else
+			{
+				Unite(upper, lower);
+				if (a.End < b.End) ++upper;
+				else ++lower;
+			}
+		}
+	}
+
+	/// 查找根节点
+	int RunLengthLabeler::Find(int index)
+	{
+		while (Parents[index] != index)
+		{
+			Parents[index] = Parents[Parents[index]];
+			index = Parents[index];
+		}
+		return index;
+	}
+
+	/// 合并集合
+	void RunLengthLabeler::Unite(int a, int b)
+	{
+		const int root_a = Find(a);
+		const int root_b = Find(b);
+
+		// 以较小的下标为根，使编号分配可以按下标顺序一次完成
+		if (root_a < root_b) Parents[root_b] = root_a;
+		else if (root_b < root_a) Parents[root_a] = root_b;
+	}
+}
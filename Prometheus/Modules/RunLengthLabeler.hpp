@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <climits>
+#include <vector>
+#include <opencv4/opencv2/opencv.hpp>
+
+#include "PackedBinaryMask.hpp"
+
+namespace RoboPioneers::Modules
+{
+	/**
+	 * @brief 游程连通域标记器
+	 * @author Vincent
+	 * @details
+	 *  ~ 该类直接从位压缩蒙版中提取水平游程，以8邻域连接游程得到连通域，并在同一遍中统计连通域的矩。
+	 *  ~ 游程提取与行内连接按行条带并行，条带之间的连接在合并阶段串行完成。
+	 *  ~ 可选地输出紧凑边界：每行的最左与最右像素依次组成的闭合多边形，所有边界点存储在同一块连续内存中。
+	 *  ~ 各阶段的缓冲区在多次调用之间复用。
+	 */
+	class RunLengthLabeler
+	{
+	public:
+		/// 连通域
+		struct Blob
+		{
+			/// 像素数
+			int Area {0};
+			/// 外接矩形
+			cv::Rect BoundingBox;
+			/// 质心
+			cv::Point2d Centroid;
+			/// 像素矩，包含空间矩、中心矩与归一化中心矩
+			cv::Moments Moments;
+			/// 边界在边界点集中的起始下标
+			int BoundaryOffset {0};
+			/// 边界点数，未提取边界时为0
+			int BoundaryLength {0};
+		};
+
+		/// 标记结果
+		struct Result
+		{
+			/// 连通域列表，按最上方像素的行列顺序排列
+			std::vector<Blob> Blobs;
+			/// 所有连通域的边界点
+			std::vector<cv::Point> BoundaryPoints;
+
+			/**
+			 * @brief 获取连通域的边界
+			 * @param index 连通域下标
+			 * @return CV_32SC2格式的点集，为边界点集的视图，不复制数据
+			 */
+			[[nodiscard]] cv::Mat GetBoundary(std::size_t index) const;
+		};
+
+		/// 标记设定
+		struct {
+			/// 每个并行条带的行数
+			int StripeRows {32};
+			/// 是否提取紧凑边界
+			bool ExtractBoundary {true};
+			/// 最小像素数，像素数更少的连通域将被忽略
+			int MinimumArea {1};
+		}Settings;
+
+	private:
+		/// 游程
+		struct Run
+		{
+			/// 起始列
+			int Begin;
+			/// 结束列，包含
+			int End;
+		};
+
+		/// 连通域统计量
+		struct Accumulator
+		{
+			/// 空间矩 m00, m10, m01, m20, m11, m02, m30, m21, m12, m03
+			std::array<double, 10> Moments {};
+			/// 左上角
+			cv::Point TopLeft {INT_MAX, INT_MAX};
+			/// 右下角，包含
+			cv::Point BottomRight {-1, -1};
+		};
+
+		/// 各条带提取出的游程
+		std::vector<std::vector<Run>> StripeRuns;
+		/// 各条带中各行的游程数
+		std::vector<int> RowRunCounts;
+		/// 各行第一个游程的下标，最后一项为游程总数
+		std::vector<int> RowOffsets;
+		/// 全部游程，按行排列
+		std::vector<Run> Runs;
+		/// 并查集的父节点，根节点为连通域中下标最小的游程
+		std::vector<int> Parents;
+		/// 游程所属的连通域编号
+		std::vector<int> Labels;
+		/// 各连通域编号的统计量
+		std::vector<Accumulator> Accumulators;
+		/// 连通域编号到输出下标的映射，被忽略的连通域为-1
+		std::vector<int> BlobIndices;
+
+	public:
+		/**
+		 * @brief 标记连通域
+		 * @param mask 位压缩蒙版
+		 * @param result 输出结果，其中的容器在多次调用之间复用
+		 */
+		void Label(const PackedBinaryMask& mask, Result& result);
+
+	protected:
+		/**
+		 * @brief 连接相邻两行的游程
+		 * @param row 下方的行，与上一行连接
+		 */
+		void ConnectRows(int row);
+
+		/// 查找根节点，同时压缩路径
+		int Find(int index);
+
+		/// 合并两个游程所在的集合
+		void Unite(int a, int b);
+	};
+}
@@ -0,0 +1,60 @@
+#include "SpatialGrid.hpp"
+
+namespace RoboPioneers::Modules
+{
+	/// 构建索引
+	void SpatialGrid::Build(const float *points_x, const float *points_y, std::size_t count, float cell_size)
+	{
+		PointsX = points_x;
+		PointsY = points_y;
+		Columns = Rows = 0;
+		if (count == 0) return;
+
+		//==============================
+		// 确定网格范围与边长
+		//==============================
+
+		const auto [min_x, max_x] = std::minmax_element(points_x, points_x + count);
+		const auto [min_y, max_y] = std::minmax_element(points_y, points_y + count);
+		OriginX = *min_x;
+		OriginY = *min_y;
+		const float width = *max_x - *min_x;
+		const float height = *max_y - *min_y;
+
+		CellSize = cell_size > 0 ? cell_size : 1.0f;
+		// 网格数不超过点数的4倍，避免点分散时大量的空网格
+		const double maximum_cells = 4.0 * static_cast<double>(count) + 16.0;
+		while ((std::floor(width / CellSize) + 1) * (std::floor(height / CellSize) + 1) > maximum_cells)
+		{
+			CellSize *= 2.0f;
+		}
+		Columns = static_cast<int>(std::floor(width / CellSize)) + 1;
+		Rows = static_cast<int>(std::floor(height / CellSize)) + 1;
+
+		//==============================
+		// 按网格计数排序
+		//==============================
+
+		CellStarts.assign(static_cast<std::size_t>(Columns) * Rows + 1, 0);
+		ItemCells.resize(count);
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			const int column = std::min(static_cast<int>((points_x[index] - OriginX) / CellSize), Columns - 1);
+			const int row = std::min(static_cast<int>((points_y[index] - OriginY) / CellSize), Rows - 1);
+			ItemCells[index] = row * Columns + column;
+			++CellStarts[ItemCells[index] + 1];
+		}
+		for (std::size_t cell = 1; cell < CellStarts.size(); ++cell)
+		{
+			CellStarts[cell] += CellStarts[cell - 1];
+		}
+
+		// 按下标顺序放置，使同一网格内的点保持下标顺序
+		Items.resize(count);
+		CellCursors.assign(CellStarts.begin(), CellStarts.end() - 1);
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			Items[CellCursors[ItemCells[index]]++] = static_cast<int>(index);
+		}
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace RoboPioneers::Modules
+{
+	/**
+	 * @brief 均匀网格空间索引
+	 * @author Vincent
+	 * @details
+	 *  ~ 将平面上的点按所在网格分桶，查询时只访问与查询圆相交的网格，用于快速找出距离较近的点。
+	 *  ~ 构建时按网格计数排序，所有点的下标存储在同一块连续内存中，容器在多次构建之间复用。
+	 *  ~ 网格数不超过点数的常数倍，点过于分散时自动增大网格边长。
+	 */
+	class SpatialGrid
+	{
+	private:
+		/// 网格左上角横坐标
+		float OriginX {0.0f};
+		/// 网格左上角纵坐标
+		float OriginY {0.0f};
+		/// 网格边长
+		float CellSize {1.0f};
+		/// 网格列数
+		int Columns {0};
+		/// 网格行数
+		int Rows {0};
+
+		/// 点的横坐标
+		const float* PointsX {nullptr};
+		/// 点的纵坐标
+		const float* PointsY {nullptr};
+
+		/// 各网格第一个点在点下标表中的位置，最后一项为点数
+		std::vector<int> CellStarts;
+		/// 按网格排列的点下标
+		std::vector<int> Items;
+		/// 各点所在的网格
+		std::vector<int> ItemCells;
+		/// 构建时各网格的下一个写入位置
+		std::vector<int> CellCursors;
+
+	public:
+		/**
+		 * @brief 构建索引
+		 * @param points_x 点的横坐标，查询期间需要保持有效
+		 * @param points_y 点的纵坐标，查询期间需要保持有效
+		 * @param count 点数
+		 * @param cell_size 期望的网格边长，应当与常用的查询半径相当
+		 */
+		void Build(const float* points_x, const float* points_y, std::size_t count, float cell_size);
+
+		/**
+		 * @brief 查询圆内的点
+		 * @param x 圆心横坐标
+		 * @param y 圆心纵坐标
+		 * @param radius 半径
+		 * @param callback 以点下标为参数的回调，对每个距离不超过半径的点调用一次，同一网格内按下标顺序调用
+		 */
+		template<typename CallbackType>
+		void Query(float x, float y, float radius, CallbackType&& callback) const
+		{
+			if (Columns == 0 || Rows == 0) return;
+
+			const int column_begin = std::max(static_cast<int>(std::floor((x - radius - OriginX) / CellSize)), 0);
+			const int column_end = std::min(static_cast<int>(std::floor((x + radius - OriginX) / CellSize)), Columns - 1);
+			const int row_begin = std::max(static_cast<int>(std::floor((y - radius - OriginY) / CellSize)), 0);
+			const int row_end = std::min(static_cast<int>(std::floor((y + radius - OriginY) / CellSize)), Rows - 1);
+
+			const float square_radius = radius * radius;
+			for (int row = row_begin; row <= row_end; ++row)
+			{
+				for (int column = column_begin; column <= column_end; ++column)
+				{
+					const int cell = row * Columns + column;
+					for (int position = CellStarts[cell]; position < CellStarts[cell + 1]; ++position)
+					{
+						const int index = Items[position];
+						const float delta_x = PointsX[index] - x;
+						const float delta_y = PointsY[index] - y;
+						if (delta_x * delta_x + delta_y * delta_y <= square_radius)
+						{
+							callback(static_cast<std::size_t>(index));
+						}
+					}
+				}
+			}
+		}
+	};
+}
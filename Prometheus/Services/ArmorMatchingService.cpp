@@ -1,13 +1,18 @@
 #include "ArmorMatchingService.hpp"
 
+#ifndef NO_CUDA
 #include <opencv4/opencv2/cudaimgproc.hpp>
 #include <opencv4/opencv2/cudaarithm.hpp>
 #include <opencv4/opencv2/cudafilters.hpp>
+#endif
+
+#include <opencv4/opencv2/core/hal/intrin.hpp>
 
 #include <tbb/tbb.h>
 #include <shared_mutex>
 #include <cmath>
-#include <unordered_map>
+#include <limits>
+#include <algorithm>
 #include <vector>
 
 #include "../Modules/CUDAUtility.hpp"
@@ -16,6 +21,46 @@
 
 namespace RoboPioneers::Prometheus
 {
+	namespace
+	{
+		/**
+		 * @brief 压缩存活的项
+		 * @param count 项数
+		 * @param keep 存活标志，非零表示存活
+		 * @param columns 需要压缩的列
+		 * @return 存活的项数
+		 * @details
+		 *  ~ 将各列中存活的项按原顺序移动到列的前部，原地进行。
+		 */
+		template<typename... ColumnTypes>
+		std::size_t CompactSurvivors(std::size_t count, const float* keep, ColumnTypes*... columns)
+		{
+			std::size_t survivors = 0;
+			for (std::size_t index = 0; index < count; ++index)
+			{
+				if (keep[index] == 0.0f) continue;
+				((columns[survivors] = columns[index]), ...);
+				++survivors;
+			}
+			return survivors;
+		}
+
+		/**
+		 * @brief 将比值阈值转换为单精度
+		 * @param threshold 双精度阈值
+		 * @return 不小于阈值的最小单精度数
+		 * @details
+		 *  ~ 对任意单精度比值x，x小于返回值当且仅当x小于原阈值，
+		 *    因此单精度比值与之比较的结果与原先与双精度阈值比较的结果一致。
+		 */
+		float RoundUpThreshold(double threshold)
+		{
+			auto result = static_cast<float>(threshold);
+			if (result < threshold) result = std::nextafter(result, std::numeric_limits<float>::infinity());
+			return result;
+		}
+	}
+
 	//==============================
 	// 控制方法
 	//==============================
@@ -32,15 +77,7 @@ namespace RoboPioneers::Prometheus
 		DebugPictureForArmor = frame.CutPicture.clone();
 		#endif
 
-		Output.PossibleArmors.clear();
-
-		std::list<std::list<GeometryFeature> const *> pairs_groups {Input.PossibleRectangles, Input.PossibleEllipses};
-
-		for (auto const * pairs : pairs_groups)
-		{
-			auto group_result = SearchPossiblePairs(*pairs);
-			Output.PossibleArmors.insert(group_result.begin(), group_result.end());
-		}
+		SearchPossiblePairs(*Input.LightBars, Output.PossibleArmors);
 
 		#ifdef DEBUG
 //			cv::Mat debug_picture = frame.CutPicture.clone();
@@ -55,202 +92,398 @@ namespace RoboPioneers::Prometheus
 	}
 
 	/// 搜索可能的灯条对
-	auto ArmorMatchingService::SearchPossiblePairs(
-			const std::list<GeometryFeature> &elements) -> ElementPairSet
+	void ArmorMatchingService::SearchPossiblePairs(const Modules::LightBarTable &light_bars,
+												std::vector<IndexPair>& pairs)
 	{
-		ElementPairSet result;
-		std::shared_mutex result_mutex;
-
-		ElementPairSet checked_paris;
-		std::shared_mutex checked_pairs_mutex;
-
-		tbb::parallel_for_each(elements.begin(), elements.end(), [
-				this, &elements,
-				&result, &result_mutex, &checked_paris, &checked_pairs_mutex
-				](const GeometryFeature& target){
-			auto&& [success_pairs, failed_pairs] = this->MatchPairs(target, elements,
-														   checked_paris, checked_pairs_mutex);
-
-			std::unique_lock result_lock(result_mutex);
-			result.insert(success_pairs.begin(), success_pairs.end());
-			result_lock.unlock();
-
-			std::unique_lock checked_pairs_lock(checked_pairs_mutex);
-			checked_paris.insert(success_pairs.begin(), success_pairs.end());
-			checked_paris.insert(failed_pairs.begin(), failed_pairs.end());
-			checked_pairs_lock.unlock();
-		});
+		pairs.clear();
 
-		return result;
-	}
+		const std::size_t count = light_bars.Size();
+		const auto* shapes = light_bars.Shapes();
+		const auto* lengths = light_bars.Lengths();
+		const auto* stable_angles = light_bars.StableAngles();
+		const auto& neighborhood = Settings.Neighborhood;
 
-	/// 进行匹配
-	auto ArmorMatchingService::MatchPairs(const ArmorMatchingService::GeometryFeature &target,
-	                                      const std::list<GeometryFeature> &elements,
-	                                      const ArmorMatchingService::ElementPairSet &ignored_pairs,
-	                                      std::shared_mutex &ignored_pairs_mutex) -> MatchingResult
-	{
-		MatchingResult result;
-		std::shared_mutex result_mutex;
-
-		tbb::parallel_for_each(elements.begin(), elements.end(), [
-				this, &target, &ignored_pairs, &ignored_pairs_mutex,
-				&result, &result_mutex](const GeometryFeature& candidate){
-			//==============================
-			// 检查是否需要进行匹配判断
-			//==============================
-
-			if (&candidate == &target) return;
-			std::shared_lock ignored_pairs_lock(ignored_pairs_mutex);
-			if (ignored_pairs.find(ElementPair{target, candidate}) != ignored_pairs.end()) return;
-			ignored_pairs_lock.unlock();
-
-			//==============================
-			// 调用函数进行判断
-			//==============================
-
-			std::unique_lock result_lock(result_mutex);
-			if (this->CheckGeometryConditions(target, candidate))
+		//==============================
+		// 建立灯条中心的网格索引
+		//==============================
+
+		if (neighborhood.Enable && count > 0)
+		{
+			// 网格边长取灯条长度中位数对应的搜索半径，使多数查询只涉及相邻的网格
+			Properties.LengthBuffer.assign(lengths, lengths + count);
+			auto median = Properties.LengthBuffer.begin() + count / 2;
+			std::nth_element(Properties.LengthBuffer.begin(), median, Properties.LengthBuffer.end());
+
+			Properties.Grid.Build(light_bars.CentersX(), light_bars.CentersY(), count,
+						 static_cast<float>(neighborhood.LengthMultiple * *median));
+		}
+
+		/// 将元素对加入对应形状的批次，批次攒满时核验
+		auto push_pair = [this, &light_bars, shapes](PairBatches& batches, std::size_t a, std::size_t b,
+				std::vector<IndexPair>& result){
+			auto& batch = batches[static_cast<std::size_t>(shapes[a])];
+			batch.First.push_back(a);
+			batch.Second.push_back(b);
+			if (batch.First.size() >= Settings.BatchSize)
 			{
-				result.PassedPairs.emplace(ElementPair{target, candidate});
+				this->CheckGeometryConditions(light_bars, batch, result);
 			}
-			else
+		};
+
+		/// 核验各批次中剩余的元素对
+		auto flush_batches = [this, &light_bars](PairBatches& batches, std::vector<IndexPair>& result){
+			for (auto& batch : batches)
 			{
-				result.FailedPairs.emplace(ElementPair{target, candidate});
+				this->CheckGeometryConditions(light_bars, batch, result);
 			}
-		});
+		};
 
-		return result;
-	}
+		/// 收集以第i个灯条为所有者的元素对
+		auto match_row = [this, &light_bars, count, shapes, lengths, stable_angles, &neighborhood, &push_pair]
+				(std::size_t i, PairBatches& batches, std::vector<IndexPair>& result){
+			if (!neighborhood.Enable)
+			{
+				// 以第i个灯条为较小下标，收集其与之后所有灯条组成的元素对
+				for (std::size_t j = i + 1; j < count; ++j)
+				{
+					// 只在匹配形状相同的灯条之间匹配
+					if (shapes[i] != shapes[j]) continue;
+
+					push_pair(batches, i, j, result);
+				}
+				return;
+			}
 
-	/// 核验几何学条件
-	bool ArmorMatchingService::CheckGeometryConditions(const ArmorMatchingService::GeometryFeature &a,
-	                                                   const ArmorMatchingService::GeometryFeature &b) const
-	{
-		/// 根据形状绑定需要使用的设定信息
-		const SettingsType::ShapeSettings& settings = a.MatchingShape == GeometryFeature::Shape::Rectangle ?
-				Settings.RectangleSettings : Settings.EllipseSettings;
+			// 以较长的灯条为所有者，在其长度的倍数内搜索较短的灯条，每一对只由所有者收集一次
+			const auto radius = static_cast<float>(neighborhood.LengthMultiple * lengths[i]);
+			Properties.Grid.Query(light_bars.CentersX()[i], light_bars.CentersY()[i], radius,
+					[i, shapes, lengths, stable_angles, &neighborhood, &push_pair, &batches, &result](std::size_t j){
+				if (j == i) return;
+				if (lengths[j] > lengths[i] || (lengths[j] == lengths[i] && j < i)) return;
+				if (shapes[i] != shapes[j]) return;
+				if (std::fabs(stable_angles[i] - stable_angles[j]) > neighborhood.AngleBand) return;
+
+				const auto [a, b] = std::minmax(i, j);
+				push_pair(batches, a, b, result);
+			});
+		};
+
+		if (count < Settings.SerialThreshold)
+		{
+			auto& batches = Properties.LocalBatches.local();
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				match_row(i, batches, pairs);
+			}
+			flush_batches(batches, pairs);
+			std::sort(pairs.begin(), pairs.end());
+			return;
+		}
 
 		//==============================
-		// 内八和外八剔除
+		// 按行并行，结果写入线程局部容器
 		//==============================
-		if (Modules::MathUtility::ResembleCoefficient(a.Angle, 90.0f) < settings.IgnorantDifferentDirectionRatio &&
-			Modules::MathUtility::ResembleCoefficient(b.Angle, 90.0f) < settings.IgnorantDifferentDirectionRatio)
+
+		for (auto& local_pairs : Properties.LocalPairs)
 		{
-			if ((a.Angle - 90.0f) * (b.Angle - 90.0f) < 0)
+			local_pairs.clear();
+		}
+
+		// 各行的工作量不均匀，以单行为粒度便于负载均衡
+		tbb::parallel_for(tbb::blocked_range<std::size_t>(0, count, 1),
+				[this, &match_row, &flush_batches](const tbb::blocked_range<std::size_t>& range){
+			auto& local_pairs = Properties.LocalPairs.local();
+			auto& local_batches = Properties.LocalBatches.local();
+			for (std::size_t i = range.begin(); i < range.end(); ++i)
 			{
-				return false;
+				match_row(i, local_batches, local_pairs);
 			}
+			flush_batches(local_batches, local_pairs);
+		});
+
+		for (const auto& local_pairs : Properties.LocalPairs)
+		{
+			pairs.insert(pairs.end(), local_pairs.begin(), local_pairs.end());
 		}
+		std::sort(pairs.begin(), pairs.end());
+	}
 
-		//==============================
-		// 高度比检测
-		//==============================
-		double height_ratio = std::fmin(a.Length, b.Length) / std::fmax(a.Length, b.Length);
-		if (height_ratio < settings.MinHeightRatio)
+	/// 批量核验几何学条件
+	void ArmorMatchingService::CheckGeometryConditions(const Modules::LightBarTable& light_bars, PairBatch& batch,
+													   std::vector<IndexPair>& pairs) const
+	{
+		std::size_t count = batch.First.size();
+		if (count == 0) return;
+
+		const auto shape = light_bars.Shapes()[batch.First.front()];
+		/// 根据形状绑定需要使用的设定信息
+		const SettingsType::ShapeSettings& settings = shape == GeometryFeature::Shape::Rectangle ?
+				Settings.RectangleSettings : Settings.EllipseSettings;
+
+		for (auto& slot : batch.Slots)
 		{
-			return false;
+			slot.resize(count);
 		}
+		std::size_t* first = batch.First.data();
+		std::size_t* second = batch.Second.data();
+		float* keep = batch[PairBatch::Keep];
+
+		#if (CV_SIMD || CV_SIMD_SCALABLE)
+		const cv::v_float32 zero = cv::vx_setzero_f32();
+		const cv::v_float32 one = cv::vx_setall_f32(1.0f);
+		const auto lanes = static_cast<std::size_t>(cv::VTraits<cv::v_float32>::vlanes());
+		#endif
 
 		//==============================
-		// 角度比检测
+		// 内八外八、高度比与角度比
 		//==============================
 
-		double a_stable_angle = a.Raw.Contour.size() > 5 ? Modules::GeometryFeatureModule::GetEllipseGeometryFeature(a.Raw.Contour).Angle : a.Angle;
-		double b_stable_angle = b.Raw.Contour.size() > 5 ? Modules::GeometryFeatureModule::GetEllipseGeometryFeature(b.Raw.Contour).Angle : b.Angle;
+		float* angle_a = batch[PairBatch::AngleA];
+		float* angle_b = batch[PairBatch::AngleB];
+		float* length_a = batch[PairBatch::LengthA];
+		float* length_b = batch[PairBatch::LengthB];
+		float* stable_angle_a = batch[PairBatch::StableAngleA];
+		float* stable_angle_b = batch[PairBatch::StableAngleB];
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			angle_a[index] = light_bars.Angles()[first[index]];
+			angle_b[index] = light_bars.Angles()[second[index]];
+			length_a[index] = light_bars.Lengths()[first[index]];
+			length_b[index] = light_bars.Lengths()[second[index]];
+			stable_angle_a[index] = light_bars.StableAngles()[first[index]];
+			stable_angle_b[index] = light_bars.StableAngles()[second[index]];
+		}
 
-		double angle_ratio = std::fmin(a_stable_angle, b_stable_angle) / std::fmax(a_stable_angle, b_stable_angle);
-		if (angle_ratio < settings.MinAngleRatio)
 		{
-			return false;
+			const auto ignorant_ratio = static_cast<float>(settings.IgnorantDifferentDirectionRatio);
+			// 高度比与原实现一样以单精度相除，恰好等于阈值的比值（例如28/40）舍入后小于0.7，仍被剔除
+			const auto min_height_ratio = RoundUpThreshold(settings.MinHeightRatio);
+			// 角度比原先以双精度相除，恰好等于阈值的比值被保留；以乘法比较时同样被保留
+			const auto min_angle_ratio = static_cast<float>(settings.MinAngleRatio);
+
+			std::size_t index = 0;
+
+			#if (CV_SIMD || CV_SIMD_SCALABLE)
+			const cv::v_float32 ninety = cv::vx_setall_f32(90.0f);
+			const cv::v_float32 ignorant = cv::vx_setall_f32(ignorant_ratio);
+			const cv::v_float32 height_ratio = cv::vx_setall_f32(min_height_ratio);
+			const cv::v_float32 angle_ratio = cv::vx_setall_f32(min_angle_ratio);
+			for (; index + lanes <= count; index += lanes)
+			{
+				const cv::v_float32 a = cv::vx_load(angle_a + index);
+				const cv::v_float32 b = cv::vx_load(angle_b + index);
+
+				// 转角与90度的相似系数，标准化转角非负
+				const cv::v_float32 a_resemble = cv::v_div(cv::v_min(a, ninety), cv::v_max(a, ninety));
+				const cv::v_float32 b_resemble = cv::v_div(cv::v_min(b, ninety), cv::v_max(b, ninety));
+				const cv::v_float32 different_direction = cv::v_and(
+						cv::v_and(cv::v_lt(a_resemble, ignorant), cv::v_lt(b_resemble, ignorant)),
+						cv::v_lt(cv::v_mul(cv::v_sub(a, ninety), cv::v_sub(b, ninety)), zero));
+
+				const cv::v_float32 la = cv::vx_load(length_a + index);
+				const cv::v_float32 lb = cv::vx_load(length_b + index);
+				const cv::v_float32 short_pair = cv::v_lt(cv::v_div(cv::v_min(la, lb), cv::v_max(la, lb)), height_ratio);
+
+				const cv::v_float32 sa = cv::vx_load(stable_angle_a + index);
+				const cv::v_float32 sb = cv::vx_load(stable_angle_b + index);
+				const cv::v_float32 skew_pair = cv::v_lt(cv::v_min(sa, sb), cv::v_mul(cv::v_max(sa, sb), angle_ratio));
+
+				cv::v_store(keep + index, cv::v_select(
+						cv::v_or(cv::v_or(different_direction, short_pair), skew_pair), zero, one));
+			}
+			#endif
+
+			for (; index < count; ++index)
+			{
+				const float a_resemble = std::fmin(angle_a[index], 90.0f) / std::fmax(angle_a[index], 90.0f);
+				const float b_resemble = std::fmin(angle_b[index], 90.0f) / std::fmax(angle_b[index], 90.0f);
+				const bool different_direction = a_resemble < ignorant_ratio && b_resemble < ignorant_ratio &&
+						(angle_a[index] - 90.0f) * (angle_b[index] - 90.0f) < 0.0f;
+				const bool short_pair = std::fmin(length_a[index], length_b[index]) /
+						std::fmax(length_a[index], length_b[index]) < min_height_ratio;
+				const bool skew_pair = std::fmin(stable_angle_a[index], stable_angle_b[index]) <
+						std::fmax(stable_angle_a[index], stable_angle_b[index]) * min_angle_ratio;
+
+				keep[index] = different_direction || short_pair || skew_pair ? 0.0f : 1.0f;
+			}
 		}
 
+		count = CompactSurvivors(count, keep, first, second);
+
 		//==============================
 		// 连线垂直于其中一边
 		//==============================
 
-		constexpr double pi = 3.14159265;
-		constexpr double half_pi = pi / 2;
+		float* center_a_x = batch[PairBatch::CenterAX];
+		float* center_a_y = batch[PairBatch::CenterAY];
+		float* center_b_x = batch[PairBatch::CenterBX];
+		float* center_b_y = batch[PairBatch::CenterBY];
+		float* direction_a_x = batch[PairBatch::DirectionAX];
+		float* direction_a_y = batch[PairBatch::DirectionAY];
+		float* direction_b_x = batch[PairBatch::DirectionBX];
+		float* direction_b_y = batch[PairBatch::DirectionBY];
+		float* link_x = batch[PairBatch::LinkX];
+		float* link_y = batch[PairBatch::LinkY];
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			center_a_x[index] = light_bars.CentersX()[first[index]];
+			center_a_y[index] = light_bars.CentersY()[first[index]];
+			center_b_x[index] = light_bars.CentersX()[second[index]];
+			center_b_y[index] = light_bars.CentersY()[second[index]];
+			direction_a_x[index] = light_bars.UnitDirectionsX()[first[index]];
+			direction_a_y[index] = light_bars.UnitDirectionsY()[first[index]];
+			direction_b_x[index] = light_bars.UnitDirectionsX()[second[index]];
+			direction_b_y[index] = light_bars.UnitDirectionsY()[second[index]];
+			link_x[index] = center_a_x[index] - center_b_x[index];
+			link_y[index] = center_a_y[index] - center_b_y[index];
+		}
 
-		auto raw_link_direction = a.Center - b.Center;
-		auto link_direction = cv::Vec2f(raw_link_direction.x, raw_link_direction.y);
+		float* cos_a = batch[PairBatch::CosA];
+		float* cos_b = batch[PairBatch::CosB];
+		Modules::MathUtility::CosIncludedAngles(count, direction_a_x, direction_a_y, link_x, link_y, cos_a);
+		Modules::MathUtility::CosIncludedAngles(count, direction_b_x, direction_b_y, link_x, link_y, cos_b);
 
-		// a垂直于连线的程度
-		double a_perpendicular_ratio = std::acos(
-				Modules::MathUtility::CosIncludedAngle(a.Vectors.Direction, link_direction)
-		) / half_pi;
+		{
+			// 垂直程度为夹角除以90度，夹角随余弦单调递减，因此垂直程度小于阈值等价于余弦大于阈值对应的余弦
+			constexpr double half_pi = 3.14159265 / 2;
+			const auto max_cos = static_cast<float>(std::cos(settings.MinLinkPerpendicularRatio * half_pi));
+
+			std::size_t index = 0;
+
+			#if (CV_SIMD || CV_SIMD_SCALABLE)
+			const cv::v_float32 threshold = cv::vx_setall_f32(max_cos);
+			for (; index + lanes <= count; index += lanes)
+			{
+				const cv::v_float32 not_perpendicular = cv::v_and(cv::v_gt(cv::vx_load(cos_a + index), threshold),
+						cv::v_gt(cv::vx_load(cos_b + index), threshold));
+				cv::v_store(keep + index, cv::v_select(not_perpendicular, zero, one));
+			}
+			#endif
+
+			for (; index < count; ++index)
+			{
+				keep[index] = cos_a[index] > max_cos && cos_b[index] > max_cos ? 0.0f : 1.0f;
+			}
+		}
 
-		// b垂直于连线的程度
-		double b_perpendicular_ratio =  std::acos(
-				Modules::MathUtility::CosIncludedAngle(b.Vectors.Direction, link_direction)
-		) / half_pi;
+		count = CompactSurvivors(count, keep, first, second,
+						   center_a_x, center_a_y, center_b_x, center_b_y,
+						   direction_a_x, direction_a_y, direction_b_x, direction_b_y);
+
+		//==============================
+		// 两个元素的正交线均与另一个元素的中心线相交
+		//==============================
 
-		if (a_perpendicular_ratio < settings.MinLinkPerpendicularRatio &&
-		b_perpendicular_ratio < settings.MinLinkPerpendicularRatio)
+		float* orthogonal_a_x = batch[PairBatch::OrthogonalAX];
+		float* orthogonal_a_y = batch[PairBatch::OrthogonalAY];
+		float* orthogonal_b_x = batch[PairBatch::OrthogonalBX];
+		float* orthogonal_b_y = batch[PairBatch::OrthogonalBY];
+		Modules::MathUtility::OrthogonalVectors(count, direction_a_x, direction_a_y, orthogonal_a_x, orthogonal_a_y);
+		Modules::MathUtility::OrthogonalVectors(count, direction_b_x, direction_b_y, orthogonal_b_x, orthogonal_b_y);
+
+		// 从a引出的正交线与b中心线的交点，以及从b引出的正交线与a中心线的交点
+		float* cross_a_x = batch[PairBatch::CrossAX];
+		float* cross_a_y = batch[PairBatch::CrossAY];
+		float* cross_b_x = batch[PairBatch::CrossBX];
+		float* cross_b_y = batch[PairBatch::CrossBY];
+		float* valid_a = batch[PairBatch::ValidA];
+		float* valid_b = batch[PairBatch::ValidB];
+		Modules::MathUtility::LineCrossPoints(count,
+				{center_a_x, center_a_y, orthogonal_a_x, orthogonal_a_y},
+				{center_b_x, center_b_y, direction_b_x, direction_b_y},
+				cross_a_x, cross_a_y, valid_a);
+		Modules::MathUtility::LineCrossPoints(count,
+				{center_b_x, center_b_y, orthogonal_b_x, orthogonal_b_y},
+				{center_a_x, center_a_y, direction_a_x, direction_a_y},
+				cross_b_x, cross_b_y, valid_b);
+
+		for (std::size_t index = 0; index < count; ++index)
 		{
-			return false;
+			keep[index] = valid_a[index] * valid_b[index];
 		}
 
+		count = CompactSurvivors(count, keep, first, second,
+						   center_a_x, center_a_y, center_b_x, center_b_y,
+						   direction_a_x, direction_a_y, direction_b_x, direction_b_y,
+						   cross_a_x, cross_a_y, cross_b_x, cross_b_y);
+
 		//==============================
-		// 至少其中一个元素的垂直线能与另一个元素相交
+		// 交点到另一个元素的距离
 		//==============================
 
-		// a方向的正交向量
-		auto a_orthogonal = Modules::MathUtility::OrthogonalVector(a.Vectors.Direction);
-		// 从a引出的正交线与b中心线的交点
-		auto a_cross_point = Modules::MathUtility::LineCrossPoint(a.Center, a_orthogonal,
-															b.Center, b.Vectors.Direction);
-		if (!a_cross_point)
+		float* width_a = batch[PairBatch::WidthA];
+		float* width_b = batch[PairBatch::WidthB];
+		for (std::size_t index = 0; index < count; ++index)
 		{
-			return false;
+			length_a[index] = light_bars.Lengths()[first[index]];
+			length_b[index] = light_bars.Lengths()[second[index]];
+			width_a[index] = light_bars.Widths()[first[index]];
+			width_b[index] = light_bars.Widths()[second[index]];
 		}
 
-		std::vector<cv::Point2f> b_vertices;
-		b_vertices.resize(4);
-		b.Raw.CircumscribedRectangle.points(b_vertices.data());
-		auto a_intersected_distance = - cv::pointPolygonTest(b.Raw.Contour, *a_cross_point, true);
-		bool a_intersected = a_intersected_distance <= b.Length * settings.CrossPointMaxDistanceRatio;
-
-		// b方向的正交向量
-		auto b_orthogonal = Modules::MathUtility::OrthogonalVector(b.Vectors.Direction);
-		// 从b引出的正交线与b中心线的交点
-		auto b_cross_point = Modules::MathUtility::LineCrossPoint(b.Center, b_orthogonal,
-		                                                          a.Center, a.Vectors.Direction);
-		if (!b_cross_point)
+		float* distance_a = batch[PairBatch::DistanceA];
+		float* distance_b = batch[PairBatch::DistanceB];
+		const auto cross_ratio = static_cast<float>(settings.CrossPointMaxDistanceRatio);
+		if (Settings.PreciseIntersectionTest)
 		{
-			return false;
+			for (std::size_t index = 0; index < count; ++index)
+			{
+				distance_a[index] = static_cast<float>(light_bars.GetOutsideDistance(
+						second[index], cv::Point2f(cross_a_x[index], cross_a_y[index]), length_b[index] * cross_ratio));
+				distance_b[index] = static_cast<float>(light_bars.GetOutsideDistance(
+						first[index], cv::Point2f(cross_b_x[index], cross_b_y[index]), length_a[index] * cross_ratio));
+			}
 		}
-		std::vector<cv::Point2f> a_vertices;
-		a_vertices.resize(4);
-		a.Raw.CircumscribedRectangle.points(a_vertices.data());
-		double b_intersected_distance = - cv::pointPolygonTest(a.Raw.Contour, *b_cross_point, true);
-		bool b_intersected = b_intersected_distance <= a.Length * settings.CrossPointMaxDistanceRatio;
+		else
+		{
+			// 交点a落在b上，交点b落在a上
+			const Modules::GeometryFeatureModule::ShapeArrays shape_b {
+				center_b_x, center_b_y, direction_b_x, direction_b_y, length_b, width_b};
+			const Modules::GeometryFeatureModule::ShapeArrays shape_a {
+				center_a_x, center_a_y, direction_a_x, direction_a_y, length_a, width_a};
 
-		#ifdef DEBUG
-//			std::shared_lock lock(DebugPictureForArmorMutex);
-////		    cv::putText(DebugPictureForArmor, std::to_string(a_intersected_distance).substr(0, 4),
-////		                *a_cross_point + cv::Point2f(5,-5), cv::FONT_HERSHEY_COMPLEX, 0.3,
-////		                cv::Scalar(255, 255, 255));
-////		    cv::putText(DebugPictureForArmor, std::to_string(b_intersected_distance).substr(0, 4),
-////		                *b_cross_point + cv::Point2f(5,-5), cv::FONT_HERSHEY_COMPLEX, 0.3,
-////		                cv::Scalar(255, 255, 255));
-////		    cv::putText(DebugPictureForArmor, std::to_string(b.Length).substr(0, 4),
-////		                b.Center + cv::Point2i(5,-5), cv::FONT_HERSHEY_COMPLEX, 0.3,
-////		                cv::Scalar(255, 0, 255));
-////		    cv::putText(DebugPictureForArmor, std::to_string(b.Length).substr(0, 4),
-////		                a.Center + cv::Point2i(5,-5), cv::FONT_HERSHEY_COMPLEX, 0.3,
-////		                cv::Scalar(255, 0, 255));
-//			cv::circle(DebugPictureForArmor, *a_cross_point, 3, cv::Scalar(205, 90, 106), 2);
-//			cv::circle(DebugPictureForArmor, *b_cross_point, 3, cv::Scalar(205, 90, 106), 2);
-//			lock.unlock();
-		#endif
+			if (shape == GeometryFeature::Shape::Ellipse)
+			{
+				Modules::GeometryFeatureModule::GetEllipseSignedDistances(count, cross_a_x, cross_a_y, shape_b, distance_a);
+				Modules::GeometryFeatureModule::GetEllipseSignedDistances(count, cross_b_x, cross_b_y, shape_a, distance_b);
+			}
+			else
+			{
+				Modules::GeometryFeatureModule::GetRectangleSignedDistances(count, cross_a_x, cross_a_y, shape_b, distance_a);
+				Modules::GeometryFeatureModule::GetRectangleSignedDistances(count, cross_b_x, cross_b_y, shape_a, distance_b);
+			}
+		}
 
-		if (!(b_intersected && a_intersected))
 		{
-			return false;
+			std::size_t index = 0;
+
+			#if (CV_SIMD || CV_SIMD_SCALABLE)
+			const cv::v_float32 ratio = cv::vx_setall_f32(cross_ratio);
+			for (; index + lanes <= count; index += lanes)
+			{
+				const cv::v_float32 intersected = cv::v_and(
+						cv::v_le(cv::vx_load(distance_a + index), cv::v_mul(cv::vx_load(length_b + index), ratio)),
+						cv::v_le(cv::vx_load(distance_b + index), cv::v_mul(cv::vx_load(length_a + index), ratio)));
+				cv::v_store(keep + index, cv::v_select(intersected, one, zero));
+			}
+			#endif
+
+			for (; index < count; ++index)
+			{
+				keep[index] = distance_a[index] <= length_b[index] * cross_ratio &&
+						distance_b[index] <= length_a[index] * cross_ratio ? 1.0f : 0.0f;
+			}
 		}
 
-		return true;
-	}
+		for (std::size_t index = 0; index < count; ++index)
+		{
+			if (keep[index] != 0.0f)
+			{
+				pairs.emplace_back(first[index], second[index]);
+			}
+		}
 
-}
\ No newline at end of file
+		batch.First.clear();
+		batch.Second.clear();
+	}
+}
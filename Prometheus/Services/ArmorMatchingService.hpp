@@ -2,13 +2,18 @@
 
 #include <SparrowEngine/SparrowEngine.hpp>
 #include <opencv4/opencv2/opencv.hpp>
+#ifndef NO_CUDA
 #include <opencv4/opencv2/cudaimgproc.hpp>
 #include <opencv4/opencv2/cudaarithm.hpp>
 #include <opencv4/opencv2/cudafilters.hpp>
-#include <unordered_set>
-#include <tuple>
+#endif
+#include <array>
+#include <vector>
+#include <tbb/enumerable_thread_specific.h>
 
 #include "../Modules/GeometryFeatureModule.hpp"
+#include "../Modules/LightBarTable.hpp"
+#include "../Modules/SpatialGrid.hpp"
 
 namespace RoboPioneers::Prometheus
 {
@@ -27,10 +32,49 @@ namespace RoboPioneers::Prometheus
 
 		/// 几何特征结构体
 		using GeometryFeature = Modules::GeometryFeatureModule::GeometryFeature;
-		/// 元素对
-		using ElementPair = Modules::GeometryFeatureModule::ElementPair;
-		/// 元素对集合
-		using ElementPairSet = Modules::GeometryFeatureModule::ElementPairSet;
+		/// 灯条表中的下标对，较小的下标在前
+		using IndexPair = Modules::LightBarTable::IndexPair;
+
+		/**
+		 * @brief 元素对批次
+		 * @details
+		 *  ~ 收集匹配形状相同的待检验元素对，攒满后分阶段批量检验。
+		 *  ~ 每个阶段先从灯条表中取出需要的量，以SIMD指令计算存活标志，再将存活的元素对压缩到批次前部，
+		 *    后续阶段只处理存活的元素对。
+		 *  ~ 中间量按列存储，在帧间复用。
+		 */
+		struct PairBatch
+		{
+			/// 中间量的列
+			enum Slot : std::size_t
+			{
+				AngleA, AngleB, LengthA, LengthB, StableAngleA, StableAngleB,
+				CenterAX, CenterAY, CenterBX, CenterBY,
+				DirectionAX, DirectionAY, DirectionBX, DirectionBY,
+				LinkX, LinkY, CosA, CosB,
+				OrthogonalAX, OrthogonalAY, OrthogonalBX, OrthogonalBY,
+				CrossAX, CrossAY, CrossBX, CrossBY, ValidA, ValidB,
+				WidthA, WidthB, DistanceA, DistanceB,
+				Keep,
+				SlotCount
+			};
+
+			/// 各元素对较小的下标
+			std::vector<std::size_t> First;
+			/// 各元素对较大的下标
+			std::vector<std::size_t> Second;
+			/// 中间量
+			std::array<Modules::LightBarTable::Column<float>, SlotCount> Slots;
+
+			/// 获取中间量的列
+			float* operator[](Slot slot)
+			{
+				return Slots[slot].data();
+			}
+		};
+
+		/// 按匹配形状分开的元素对批次，以形状的枚举值为下标
+		using PairBatches = std::array<PairBatch, GeometryFeature::ShapeCount>;
 
 
 		//==============================
@@ -39,18 +83,20 @@ namespace RoboPioneers::Prometheus
 
 		/// 输入结构体
 		struct {
-			/// 可能的矩形
-			std::list<GeometryFeature> const * PossibleRectangles;
-			/// 可能的椭圆
-			std::list<GeometryFeature> const * PossibleEllipses;
+			/// 可能的灯条，只在匹配形状相同的灯条之间匹配
+			Modules::LightBarTable const * LightBars {nullptr};
 
 			cv::Point* CuttingAreaPositionOffset;
 		}Input;
 
 		/// 输出结构体
 		struct {
-			/// 结果
-			ElementPairSet PossibleArmors;
+			/**
+			 * @brief 可能的装甲板
+			 * @details
+			 *  ~ 为输入灯条表中的下标对，按下标的字典序排列，只在灯条表不变时有效。
+			 */
+			std::vector<IndexPair> PossibleArmors;
 		}Output;
 
 		//==============================
@@ -111,48 +157,74 @@ namespace RoboPioneers::Prometheus
 				.MinAngleRatio = 0.7f,
 				.MinLinkPerpendicularRatio = 0.3f
 			};
-		}Settings;
 
-		/// 元素对
-//		struct ElementPair {
-//			GeometryFeature A;
-//			GeometryFeature B;
-//		};
+			/// 串行匹配的灯条数上限，灯条数小于该值时不启用并行
+			std::size_t SerialThreshold {16};
+
+			/// 每批检验的元素对数，中间量的总大小应当能放入一级缓存
+			std::size_t BatchSize {128};
+
+			/**
+			 * @brief 是否使用轮廓进行相交检测
+			 * @details
+			 *  ~ 默认以灯条的拟合形状解析地计算交点到灯条的距离，耗时与轮廓点数无关。
+			 *  ~ 启用时改为对轮廓进行点多边形检测，结果更贴合不规则的轮廓，但耗时与轮廓点数成正比。
+			 */
+			bool PreciseIntersectionTest {false};
+
+			/**
+			 * @brief 邻域设定
+			 * @details
+			 *  ~ 同一块装甲板的两个灯条相距不超过灯条长度的数倍，且朝向接近。
+			 *  ~ 启用时以网格索引只检验距离与转角差都在范围内的元素对，繁忙画面中的耗时约与灯条数成正比。
+			 */
+			struct {
+				/// 是否启用邻域筛选，不启用时检验所有元素对
+				bool Enable {true};
+				/// 中心距离上限，为两个灯条中较长者长度的倍数，大装甲板约为4倍
+				double LengthMultiple {5.0};
+				/// 稳定转角之差的上限，单位为度
+				double AngleBand {45.0};
+			}Neighborhood;
+		}Settings;
 
 		/**
-		 * @brief 搜索可能的元素对
-		 * @param element 元素列表
-		 * @return 可能的元素对列表
+		 * @brief 资产结构体
+		 * @details
+		 *  ~ 该结构体存储可以复用的、一般贯穿服务生命周期的对象。
 		 */
-		[[nodiscard]] auto SearchPossiblePairs(const std::list<GeometryFeature>& elements) -> ElementPairSet;
-
-		/// 匹配结果
-		struct MatchingResult
-		{
-			/// 通过检测的元素对
-			ElementPairSet PassedPairs;
-			/// 未通过检测的元素对
-			ElementPairSet FailedPairs;
-		};
+		struct {
+			/// 各线程匹配成功的下标对，在帧间复用以避免重复分配
+			tbb::enumerable_thread_specific<std::vector<IndexPair>> LocalPairs;
+			/// 各线程的元素对批次
+			tbb::enumerable_thread_specific<PairBatches> LocalBatches;
+			/// 灯条中心的网格索引
+			Modules::SpatialGrid Grid;
+			/// 求长度中位数使用的缓冲区
+			std::vector<float> LengthBuffer;
+		}Properties;
 
 		/**
-		 * @brief 为目标元素匹配可能的元素对
-		 * @param target 目标
-		 * @param ignored_pairs 忽略的目标
-		 * @return 匹配的元素结果，第一个元素为成功匹配的元素对，第二个元素为失败的元素对
+		 * @brief 搜索可能的元素对
+		 * @param light_bars 灯条表
+		 * @param pairs 输出的下标对，将被清空后填充，按下标的字典序排列
+		 * @details
+		 *  ~ 每一对只检验一次，不需要去重；启用邻域筛选时只检验邻域内的元素对。
+		 *  ~ 各线程将结果写入线程局部容器，最后合并排序，结果与线程调度无关。
 		 */
-		[[nodiscard]] auto MatchPairs(const GeometryFeature& target, const std::list<GeometryFeature>& elements,
-								const ElementPairSet &ignored_pairs, std::shared_mutex &ignored_pairs_mutex)
-			-> MatchingResult;
+		void SearchPossiblePairs(const Modules::LightBarTable& light_bars, std::vector<IndexPair>& pairs);
 
 		/**
-		 * @brief 核验元素对
-		 * @param a 一个元素
-		 * @param b 另一个元素
-		 * @retval true 当元素对满足条件
-		 * @retval false 当元素对不满足条件
+		 * @brief 批量核验元素对
+		 * @param light_bars 灯条表
+		 * @param batch 元素对批次，其中的元素对应当具有相同的匹配形状，核验后被清空
+		 * @param pairs 通过核验的元素对将被追加到其中
+		 * @details
+		 *  ~ 依次核验内八外八、高度比与角度比，连线垂直程度，正交线交点是否存在，交点到灯条的距离。
+		 *  ~ 垂直程度的阈值预先换算为夹角余弦，不需要计算反余弦。
 		 */
-		[[nodiscard]] bool CheckGeometryConditions(const GeometryFeature& a, const GeometryFeature& b) const;
+		void CheckGeometryConditions(const Modules::LightBarTable& light_bars, PairBatch& batch,
+							   std::vector<IndexPair>& pairs) const;
 
 	protected:
 		/// 更新方法
@@ -3,6 +3,8 @@
 #include "../Modules/ImageDebugUtility.hpp"
 #include "../Modules/MathUtility.hpp"
 #include "../Modules/GeometryFeatureModule.hpp"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace RoboPioneers::Prometheus
@@ -17,158 +19,196 @@ namespace RoboPioneers::Prometheus
 		DebugPictureIntelligence = frame.CutPicture.clone();
 		#endif
 
-		bool found = false;
-		cv::RotatedRect best_one;
+		//==============================
+		// 将可能的装甲板转换为全图坐标的观测
+		//==============================
 
-		double best_one_score = 0;
-		ElementPair best_pair;
-		if (!Input.PossibleArmors->empty())
-		{
-			for (const auto& candidate : *Input.PossibleArmors)
-			{
-				auto current_rectangle = CastPairToRotatedRectangle(candidate);
-
-				auto geometry_parameters = Modules::GeometryFeatureModule::StandardizeRotatedRectangle(current_rectangle);
+		BuildDetections(*Input.LightBars, *Input.PossibleArmors, frame.PointOffset, Settings.PreciseArmorRectangle,
+				  frame.Arena.GetResource(), Detections);
 
-				constexpr double standard_big_armor_aspect_ratio = 23.5f / 6.0f;
-				constexpr double standard_small_armor_aspect_ratio = 14.0f / 6.0f;
+		//==============================
+		// 更新轨迹并选择射击目标
+		//==============================
 
-				double small_armor_ratio = Modules::MathUtility::ResembleCoefficient(
-						geometry_parameters.Length / geometry_parameters.Width, standard_small_armor_aspect_ratio);
+		Tracker.Settings.Filter = Settings.Filter;
+		Tracker.Settings.HistoryFrames = Settings.HistoryFrames;
+		Tracker.Settings.MinHits = Settings.MinHits;
+		Tracker.Settings.MaxMisses = Settings.MaxMisses;
+		if (Input.SearchUpdated && *Input.SearchUpdated && Input.SearchDetections && Input.SearchCaptureTime)
+		{
+			Tracker.Seed(*Input.SearchDetections, *Input.SearchCaptureTime);
+		}
+		Tracker.Update(Detections, frame.CaptureTime);
 
-				double big_armor_ratio = Modules::MathUtility::ResembleCoefficient(
-						geometry_parameters.Length / geometry_parameters.Width, standard_big_armor_aspect_ratio
-				);
-				if (big_armor_ratio < 0.4 && small_armor_ratio < 0.4)
+		// 原目标仍然存在时保持不变，避免在多个目标之间来回切换
+		const auto* target = Tracker.FindTrack(Output.TargetId);
+		if (!target)
+		{
+			for (const auto& track : Tracker.GetTracks())
+			{
+				if (!Tracker.IsConfirmed(track) || !track.Matched) continue;
+				if (!target || track.Score * track.Confidence > target->Score * target->Confidence)
 				{
-					continue;
+					target = &track;
 				}
+			}
+		}
 
-				double score = (small_armor_ratio > big_armor_ratio ? small_armor_ratio : big_armor_ratio) *
-				               Modules::MathUtility::ResembleCoefficient(geometry_parameters.Angle, 90) *
-				               geometry_parameters.Length * geometry_parameters.Width;
+		Output.Tracked = target != nullptr;
+		Output.TargetId = target ? target->Id : 0;
+
+		if (target)
+		{
+			//==============================
+			// 预测瞄准点
+			//==============================
 
-				if (score >= best_one_score)
+			Output.AimTime = frame.CaptureTime;
+			if (Settings.Prediction.Enable)
+			{
+				// 处理延迟以输出时刻计，串口单程延迟取往返时间的一半
+				auto aim_time = std::chrono::steady_clock::now() + Settings.Prediction.ActuationDelay;
+				if (Input.RoundTripTime)
 				{
-					best_pair = candidate;
-					best_one = current_rectangle;
-					found = true;
+					aim_time += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+							std::chrono::duration<double, std::micro>(*Input.RoundTripTime / 2.0));
 				}
+				Output.AimTime = std::clamp(aim_time, frame.CaptureTime,
+								   frame.CaptureTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+										   Settings.Prediction.MaxLeadTime));
 			}
-		}
 
-		auto best_geometry = Modules::GeometryFeatureModule::StandardizeRotatedRectangle(best_one);
-		auto best_one_global = GetGlobalRectangle(best_geometry, frame.PointOffset);
+			const auto aim_state = target->Filter.Extrapolate(Output.AimTime);
+			Output.X = static_cast<int>(std::lround(aim_state.Center.x));
+			Output.Y = static_cast<int>(std::lround(aim_state.Center.y));
 
-		if (found)
-		{
-			if ((Output.Tracked && IsSameArmor(best_one, LastTarget) || !Output.Tracked))
+			if (target->Matched)
 			{
-				constexpr double width_expand = 2.0f;
-				constexpr double height_expand = 2.0f;
-				auto length = best_one_global.Length;
-				auto width = best_one_global.Width;
-				if (length < 80) length = 120;
-				if (width < 80) width = 80;
-				Output.InterestedArea = cv::Rect(cv::Point(
-						best_one_global.Center.x - 0.5 * (width_expand) * length,
-						best_one_global.Center.y - 0.5 * (height_expand) * width),
-					    cv::Size(length * width_expand, width * height_expand));
-
-				if (Output.InterestedArea.x < 0) Output.InterestedArea.x = 0;
-				if (Output.InterestedArea.x > 1280) Output.InterestedArea.x = 1280;
-				if (Output.InterestedArea.y < 0) Output.InterestedArea.y = 0;
-				if (Output.InterestedArea.y > 1024) Output.InterestedArea.y = 1024;
-				if (Output.InterestedArea.x + Output.InterestedArea.width > 1280) Output.InterestedArea.width = 1280 - Output.InterestedArea.x;
-				if (Output.InterestedArea.y + Output.InterestedArea.height > 1024) Output.InterestedArea.height = 1024 - Output.InterestedArea.y;
-
-//				Output.InterestedArea = best_one.boundingRect();
-//				Output.InterestedArea = Modules::MathUtility::ScaleRectangle(Output.InterestedArea, {1.0f, 1.0f},
-//				                                                            cv::Size(1280, 1024));
-//				Output.InterestedArea = Modules::MathUtility::ScaleRectangle(Output.InterestedArea, {1.5f, 2.0f});
-				Output.Tracked = true;
-				Output.X = best_one_global.Center.x;
-				Output.Y = best_one_global.Center.y;
-				LastTarget = best_one;
-				TrackingRemainTimes = Settings.TrackingFrames;
-
 				std::cout << "Found X:" << Output.X  << " Y:" << Output.Y << std::endl;
 			}
-			else
-			{
-				found = false;
-			}
+		}
+		else
+		{
+			Output.AimTime = frame.CaptureTime;
 		}
 
-		if (!found)
+		//==============================
+		// 以下一帧的预测位置放置兴趣区域
+		//==============================
+
+		AreaController.Settings = Settings.InterestedArea;
+		Output.InterestedAreas.clear();
+		if (target)
+		{
+			Output.InterestedAreas.push_back(GetInterestedArea(*target, frame));
+		}
+		// 射击目标的区域在图像外时处理整幅图像，不为其他轨迹裁剪
+		if (!Output.InterestedAreas.empty() && !Output.InterestedAreas.front().empty() &&
+			Output.InterestedAreas.size() < Settings.MaxInterestedAreas)
 		{
-			if (Output.Tracked && TrackingRemainTimes >= 0)
+			std::pmr::vector<const Modules::MultiTargetTracker::Track*> others(frame.Arena.GetResource());
+			for (const auto& track : Tracker.GetTracks())
 			{
-				--TrackingRemainTimes;
-//				Output.InterestedArea = Modules::MathUtility::ScaleRectangle(Output.InterestedArea, {1.2f, 1.2f},
-//				                                                             cv::Size(1280, 1024));
+				// 未确认的轨迹也需要兴趣区域，否则兴趣区域以外出现的目标永远无法被确认
+				if (&track == target) continue;
+				others.push_back(&track);
 			}
-			else
+			std::sort(others.begin(), others.end(), [](const auto* a, const auto* b){
+				return a->Score * a->Confidence > b->Score * b->Confidence;
+			});
+			for (const auto* track : others)
 			{
-				Output.Tracked = false;
+				if (Output.InterestedAreas.size() >= Settings.MaxInterestedAreas) break;
+				Output.InterestedAreas.push_back(GetInterestedArea(*track, frame));
 			}
 		}
+		AreaController.MergeAreas(Output.InterestedAreas, frame.PictureSize);
+		Output.Tracked = Output.Tracked && !Output.InterestedAreas.empty();
 
 		#ifdef DEBUG
-		if (found)
+		for (const auto& track : Tracker.GetTracks())
 		{
-			best_one.center = best_one.center + Modules::MathUtility::ChangePointType<float>(frame.PointOffset);
-			Modules::ImageDebugUtility::DrawRotatedRectangle(DebugPictureIntelligence, best_one,
-			                                                 cv::Scalar(0, 255, 255));
+			if (!track.Matched) continue;
+			Modules::ImageDebugUtility::DrawRotatedRectangle(DebugPictureIntelligence, track.LastRectangle,
+			                                                 &track == target ? cv::Scalar(0, 255, 255) :
+			                                                 cv::Scalar(127, 127, 127));
 		}
 		cv::imshow("Final Decision", DebugPictureIntelligence);
 
 		#endif
 	}
 
-	/// 从灯条对匹配旋转矩形
-	cv::RotatedRect BattleIntelligenceService::CastPairToRotatedRectangle(
-			const BattleIntelligenceService::ElementPair &pair)
+	/// 将可能的装甲板转换为全图坐标的观测
+	void BattleIntelligenceService::BuildDetections(const Modules::LightBarTable &light_bars,
+											  const std::vector<IndexPair> &pairs, cv::Point offset, bool precise,
+											  std::pmr::memory_resource *resource,
+											  std::vector<Detection> &detections)
 	{
-		std::vector<cv::Point> mixed_contour;
-		mixed_contour.reserve(std::get<0>(pair).Raw.Contour.size() + std::get<1>(pair).Raw.Contour.size());
-		mixed_contour.insert(mixed_contour.end(), std::get<0>(pair).Raw.Contour.begin(), std::get<0>(pair).Raw.Contour.end());
-		mixed_contour.insert(mixed_contour.end(), std::get<1>(pair).Raw.Contour.begin(), std::get<1>(pair).Raw.Contour.end());
-		return cv::minAreaRect(mixed_contour);
+		detections.clear();
+		for (const auto& candidate : pairs)
+		{
+			auto current_rectangle = precise ?
+					CastPairToRotatedRectangle(light_bars, candidate, resource) :
+					Modules::GeometryFeatureModule::GetPairRotatedRectangle(
+							light_bars.GetBarParameters(candidate.first),
+							light_bars.GetBarParameters(candidate.second));
+
+			auto geometry_parameters = Modules::GeometryFeatureModule::StandardizeRotatedRectangle(current_rectangle);
+
+			constexpr double standard_big_armor_aspect_ratio = 23.5f / 6.0f;
+			constexpr double standard_small_armor_aspect_ratio = 14.0f / 6.0f;
+
+			double small_armor_ratio = Modules::MathUtility::ResembleCoefficient(
+					geometry_parameters.Length / geometry_parameters.Width, standard_small_armor_aspect_ratio);
+
+			double big_armor_ratio = Modules::MathUtility::ResembleCoefficient(
+					geometry_parameters.Length / geometry_parameters.Width, standard_big_armor_aspect_ratio
+			);
+			if (big_armor_ratio < 0.4 && small_armor_ratio < 0.4)
+			{
+				continue;
+			}
+
+			double score = (small_armor_ratio > big_armor_ratio ? small_armor_ratio : big_armor_ratio) *
+			               Modules::MathUtility::ResembleCoefficient(geometry_parameters.Angle, 90) *
+			               geometry_parameters.Length * geometry_parameters.Width;
+
+			auto global_rectangle = current_rectangle;
+			global_rectangle.center += Modules::MathUtility::ChangePointType<float>(offset);
+
+			// 几何特征的中心已取整，观测中心使用旋转矩形的亚像素中心
+			detections.push_back({global_rectangle,
+						 cv::Point2d(global_rectangle.center.x, global_rectangle.center.y),
+						 cv::Size2d(geometry_parameters.Length, geometry_parameters.Width),
+						 score});
+		}
 	}
 
-	/// 判断是否是同一块装甲板
-	bool BattleIntelligenceService::IsSameArmor(const cv::RotatedRect& current_target, const cv::RotatedRect& previous_target) const
+	/// 获取轨迹在下一帧的兴趣区域
+	cv::Rect BattleIntelligenceService::GetInterestedArea(const Modules::MultiTargetTracker::Track &track,
+													   const Sparrow::Frame &frame) const
 	{
-		if (Modules::MathUtility::ResembleCoefficient(current_target.size.area(), previous_target.size.area()) < 0.5)
-		{
-			return false;
-		}
-		std::vector<cv::Point> intersection_region {};
-		auto intersection_type = cv::rotatedRectangleIntersection(current_target, previous_target, intersection_region);
-		switch (intersection_type)
-		{
-			default:
-			case cv::RectanglesIntersectTypes::INTERSECT_NONE:
-				return false;
-				break;
-			case cv::RectanglesIntersectTypes::INTERSECT_FULL:
-				return true;
-			case cv::RectanglesIntersectTypes::INTERSECT_PARTIAL:
-				auto intersection_area = cv::contourArea(intersection_region);
-				// 要求重叠面积占比达标
-				if (intersection_area / previous_target.size.area() < Settings.IntersectionAreaRatioThreshold)
-					return false;
-//				// 要求角度近乎平行
-//				auto geometry_current_target =
-//						Modules::GeometryFeatureModule::StandardizeRotatedRectangle(current_target);
-//				auto geometry_previous_target =
-//						Modules::GeometryFeatureModule::StandardizeRotatedRectangle(previous_target);
-//				if (Modules::MathUtility::ResembleCoefficient(geometry_current_target.Angle, geometry_previous_target.Angle)
-//				< Settings.AngleRatioThreshold)
-//					return false;
-
-				return true;;
-		}
+		// 轨迹在连续丢失超过MaxMisses帧后被删除，兴趣区域在此之前扩大到InterestedAreaLostScale
+		const double lost_ratio = Settings.MaxMisses > 0 ?
+				std::min(static_cast<double>(track.Misses) / Settings.MaxMisses, 1.0) : 1.0;
+		const double scale = Settings.InterestedAreaFirstScale +
+				(Settings.InterestedAreaLostScale - Settings.InterestedAreaFirstScale) * lost_ratio;
+
+		return AreaController.GetArea(track.Filter.Extrapolate(frame.CaptureTime + frame.DeltaTime), scale,
+								frame.PictureSize);
+	}
+
+	/// 从灯条对匹配旋转矩形
+	cv::RotatedRect BattleIntelligenceService::CastPairToRotatedRectangle(const Modules::LightBarTable& light_bars,
+			const BattleIntelligenceService::IndexPair &pair, std::pmr::memory_resource* resource)
+	{
+		const auto first = light_bars.GetContour(pair.first);
+		const auto second = light_bars.GetContour(pair.second);
+
+		std::pmr::vector<cv::Point> mixed_contour(resource);
+		mixed_contour.reserve(first.total() + second.total());
+		mixed_contour.insert(mixed_contour.end(), first.ptr<cv::Point>(), first.ptr<cv::Point>() + first.total());
+		mixed_contour.insert(mixed_contour.end(), second.ptr<cv::Point>(), second.ptr<cv::Point>() + second.total());
+		return cv::minAreaRect(cv::Mat(static_cast<int>(mixed_contour.size()), 1, CV_32SC2, mixed_contour.data()));
 	}
 }
\ No newline at end of file
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <SparrowEngine/SparrowEngine.hpp>
-#include <unordered_set>
-#include <shared_mutex>
-#include <list>
-#include <tuple>
+#include <chrono>
+#include <memory_resource>
+#include <vector>
 #include "../Modules/GeometryFeatureModule.hpp"
+#include "../Modules/InterestedAreaController.hpp"
+#include "../Modules/KalmanTracker.hpp"
+#include "../Modules/LightBarTable.hpp"
+#include "../Modules/MultiTargetTracker.hpp"
 
 namespace RoboPioneers::Prometheus
 {
@@ -14,50 +17,35 @@ namespace RoboPioneers::Prometheus
 	 * @author Vincent
 	 * @details
 	 *  ~ 该服务用于从可能的装甲板中选择一个并推荐。
+	 *  ~ 所有可能的装甲板都交给多目标跟踪器关联成轨迹，射击目标从已确认的轨迹中选择，选定后保持到其轨迹被删除。
+	 *  ~ 目标的坐标预测到指令预计被执行的时刻，兴趣区域预测到下一帧的采集时刻。
+	 *  ~ 兴趣区域的大小随预测的不确定度与目标丢失的帧数增长，可同时为其他轨迹给出兴趣区域。
+	 *  ~ 后台全图搜索的结果在更新轨迹前并入跟踪器，为兴趣区域以外出现的目标建立轨迹。
 	 */
 	class BattleIntelligenceService : public Sparrow::Service
 	{
 	public:
 		using GeometryFeature = Modules::GeometryFeatureModule::GeometryFeature;
-		using ElementPair = Modules::GeometryFeatureModule::ElementPair;
-		using ElementPairSet = Modules::GeometryFeatureModule::ElementPairSet;
-
-		/// 元素对哈希函数
-		struct ElementPairHash
-		{
-			std::size_t operator()(const ElementPair& elementPair) const
-			{
-				auto center = std::get<0>(elementPair).Center + std::get<1>(elementPair).Center;
-				/// 零点到中心点的距离平方
-				auto square_distance = center.dot(center);
-
-				return std::hash<decltype(square_distance)>()(square_distance);
-			}
-		};
-
-		/// 元素对相等判断函数
-		struct ElementPairEqual
-		{
-			bool operator()(const ElementPair& a, const ElementPair& b) const
-			{
-				if (Modules::GeometryFeatureModule::IsGeometryFeatureIdentical(std::get<0>(a), std::get<0>(b)) &&
-				    Modules::GeometryFeatureModule::IsGeometryFeatureIdentical(std::get<1>(a), std::get<1>(b)))
-				{
-					return true;
-				}
-				if (Modules::GeometryFeatureModule::IsGeometryFeatureIdentical(std::get<0>(a), std::get<1>(b)) &&
-				    Modules::GeometryFeatureModule::IsGeometryFeatureIdentical(std::get<1>(a), std::get<0>(b)))
-				{
-					return true;
-				}
-
-				return false;
-			}
-		};
+		/// 灯条表中的下标对
+		using IndexPair = Modules::LightBarTable::IndexPair;
+		/// 观测
+		using Detection = Modules::MultiTargetTracker::Detection;
 
 		/// 输入
 		struct {
-			ElementPairSet* PossibleArmors;
+			/// 灯条表
+			const Modules::LightBarTable* LightBars {nullptr};
+			/// 可能的装甲板，为灯条表中的下标对
+			const std::vector<IndexPair>* PossibleArmors {nullptr};
+			/// 串口往返时间，单位为微秒，为空时不计入预测时长
+			const double* RoundTripTime {nullptr};
+
+			/// 后台全图搜索的观测，为全图坐标，为空时不使用
+			const std::vector<Detection>* SearchDetections {nullptr};
+			/// 后台全图搜索的采集时刻
+			const std::chrono::steady_clock::time_point* SearchCaptureTime {nullptr};
+			/// 后台全图搜索的观测是否在本帧更新，只有更新时才并入跟踪器
+			const bool* SearchUpdated {nullptr};
 		}Input;
 
 		/// 输出
@@ -70,9 +58,13 @@ namespace RoboPioneers::Prometheus
 			int Y;
 			/// 识别的数字
 			char Number;
+			/// 射击目标的轨迹编号，没有目标时为0
+			unsigned int TargetId {0};
+			/// 坐标对应的时刻，启用预测时为预计的执行时刻，否则为采集时间
+			std::chrono::steady_clock::time_point AimTime {};
 
-			/// 兴趣区域列表
-			cv::Rect InterestedArea {cv::Rect(0,0,0,0)};
+			/// 兴趣区域列表，为全图坐标，相互之间不相交，为空时处理整幅图像
+			std::vector<cv::Rect> InterestedAreas;
 			/// 是否需要裁剪
 			bool Tracked {false};
 		}Output;
@@ -89,30 +81,84 @@ namespace RoboPioneers::Prometheus
 		};
 
 		struct {
-			/// 追踪帧
-			unsigned int TrackingFrames {5};
-
-			/// 要求5帧内出现3帧
-			unsigned int AppearanceThreshold {3};
-
+			/// 统计出现次数的近期帧数
+			unsigned int HistoryFrames {5};
+			/// 近期帧内至少出现的次数，默认要求5帧内出现3帧，出现次数达标的轨迹才能被选为射击目标
+			unsigned int MinHits {3};
+			/// 轨迹连续丢失超过该帧数后被删除
+			unsigned int MaxMisses {5};
+
+			/// 目标刚关联成功时兴趣区域相对装甲板长宽的缩放比例
 			double InterestedAreaFirstScale {2.0};
+			/// 目标连续丢失达到MaxMisses帧时的缩放比例，期间按丢失帧数线性增长
 			double InterestedAreaLostScale {3.0};
+			/// 兴趣区域设定
+			Modules::InterestedAreaController::SettingsType InterestedArea;
+			/**
+			 * @brief 最多给出的兴趣区域数，合并前计数
+			 * @details
+			 *  ~ 1表示只跟踪射击目标；大于1时按评分与置信度之积依次为其他轨迹（包括未确认的轨迹）给出兴趣区域，
+			 *    后台全图搜索发现的目标需要由此进入兴趣区域才能被确认。
+			 *  ~ 所有区域的外接矩形过大时，靠后的区域将被舍弃，见InterestedAreaController::MergeAreas。
+			 */
+			std::size_t MaxInterestedAreas {2};
+
+			/// 轨迹滤波设定
+			Modules::KalmanTracker::SettingsType Filter;
 
 			/**
-			 * @brief 重合面积阈值
+			 * @brief 预测设定
 			 * @details
-			 *  ~ 当重合面积达到该比例后，将认为新旧装甲板是同一块装甲板。
+			 *  ~ 预测时长为采集到输出的处理延迟、串口单程延迟与执行延迟之和。
 			 */
-			double IntersectionAreaRatioThreshold {0.5};
-			/// 同装甲板角度近似系数
-			double AngleRatioThreshold {0.5};
+			struct {
+				/// 是否输出预测的坐标，不启用时输出滤波后采集时刻的坐标
+				bool Enable {true};
+				/// 下位机收到指令到云台执行的延迟，需要在实际平台上测量
+				std::chrono::microseconds ActuationDelay {5000};
+				/// 从采集时刻起的最长预测时长，避免时钟异常时外推过远
+				std::chrono::milliseconds MaxLeadTime {100};
+			}Prediction;
+
+			/**
+			 * @brief 是否由轮廓构造装甲板矩形
+			 * @details
+			 *  ~ 默认由两个灯条的拟合矩形直接构造，耗时与轮廓点数无关。
+			 *  ~ 启用时改为合并两个灯条的轮廓求最小外接矩形，耗时与轮廓点数成正比。
+			 */
+			bool PreciseArmorRectangle {false};
 		}Settings;
 
+		/**
+		 * @brief 将可能的装甲板转换为全图坐标的观测
+		 * @param light_bars 灯条表
+		 * @param pairs 可能的装甲板，为灯条表中的下标对
+		 * @param offset 灯条表坐标相对全图的偏移量
+		 * @param precise 是否由轮廓构造装甲板矩形
+		 * @param resource 合并轮廓使用的内存资源
+		 * @param detections 观测列表，将被清空后写入
+		 * @details
+		 *  ~ 不访问服务的状态，后台全图搜索在其他线程中使用同样的方法生成观测。
+		 */
+		static void BuildDetections(const Modules::LightBarTable& light_bars, const std::vector<IndexPair>& pairs,
+							  cv::Point offset, bool precise, std::pmr::memory_resource* resource,
+							  std::vector<Detection>& detections);
+
 	protected:
-		/// 跟踪区域
-		cv::RotatedRect LastTarget{};
-		/// 跟踪剩余帧
-		int TrackingRemainTimes {5};
+		/// 多目标跟踪器，为全图坐标
+		Modules::MultiTargetTracker Tracker;
+		/// 本帧的观测，在帧间复用
+		std::vector<Detection> Detections;
+		/// 兴趣区域控制器
+		Modules::InterestedAreaController AreaController;
+
+		/**
+		 * @brief 获取轨迹在下一帧的兴趣区域
+		 * @param track 轨迹
+		 * @param frame 当前帧
+		 * @return 兴趣区域，为全图坐标
+		 */
+		cv::Rect GetInterestedArea(const Modules::MultiTargetTracker::Track& track, const Sparrow::Frame& frame) const;
 
 		/// 更新方法
 		void OnUpdate(Sparrow::Frame &frame) override;
@@ -123,23 +169,17 @@ namespace RoboPioneers::Prometheus
 			Track
 		}CurrentStatus {StatusType::Search};
 
-		static cv::RotatedRect CastPairToRotatedRectangle(const ElementPair& pair);
-
-		static GeometryFeature GetGlobalRectangle(const GeometryFeature& local, cv::Point offset)
-		{
-			auto global_one = local;
-			global_one.Center += offset;
-			return global_one;
-		}
-
 		/**
-		 * @brief 判断是否是同一块装甲板
-		 * @param current_target 当前等待判断的目标旋转矩形
-		 * @param previous_target 可能是原来的旋转矩形
-		 * @retval true 当认为两个矩形是同一块装甲板
-		 * @retval false 当认为两个矩形不是同一块装甲板
+		 * @brief 将元素对转换为旋转矩形
+		 * @param light_bars 灯条表
+		 * @param pair 元素对在灯条表中的下标
+		 * @param resource 合并轮廓使用的内存资源，一般为帧内存池
+		 * @return 两个元素轮廓的最小外接旋转矩形
+		 * @details
+		 *  ~ 仅在启用PreciseArmorRectangle时使用，默认由GeometryFeatureModule::GetPairRotatedRectangle构造。
 		 */
-		[[nodiscard]] bool IsSameArmor(const cv::RotatedRect& current_target, const cv::RotatedRect& previous_target) const;
+		static cv::RotatedRect CastPairToRotatedRectangle(const Modules::LightBarTable& light_bars, const IndexPair& pair,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
 	};
 }
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "ClockSynchronizationService.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "../Modules/CRCModule.hpp"
+
+namespace RoboPioneers::Prometheus
+{
+	/// 32位计数器的周期
+	constexpr double CounterPeriod = 4294967296.0;
+
+	/// 析构函数
+	ClockSynchronizationService::~ClockSynchronizationService()
+	{
+		Stop();
+	}
+
+	/// 开始接收应答
+	void ClockSynchronizationService::Start()
+	{
+		if (!Input.Port)
+		{
+			throw std::logic_error("ClockSynchronizationService::Start Serial Port Is Not Given.");
+		}
+		if (Receiving.exchange(true))
+		{
+			return;
+		}
+		ReceivingThread = std::thread(&ClockSynchronizationService::ReceiveLoop, this);
+	}
+
+	/// 停止接收应答
+	void ClockSynchronizationService::Stop()
+	{
+		Receiving = false;
+		if (ReceivingThread.joinable())
+		{
+			ReceivingThread.join();
+		}
+	}
+
+	/// 更新方法
+	void ClockSynchronizationService::OnUpdate(Sparrow::Frame &frame)
+	{
+		//==============================
+		// 按周期发送同步请求
+		//==============================
+
+		auto current_time = std::chrono::steady_clock::now();
+		if (Receiving && Input.Port && current_time - LastRequestTime >= Settings.RequestPeriod)
+		{
+			std::vector<unsigned char> packet(PacketLength, 0);
+			auto send_time = static_cast<std::uint32_t>(GetHostMicroseconds(std::chrono::steady_clock::now()));
+			auto sequence = RequestSequence++;
+
+			packet[0] = SynchronizeCommand;
+			std::memcpy(&packet[1], &send_time, sizeof(send_time));
+			std::memcpy(&packet[5], &sequence, sizeof(sequence));
+			packet[PacketLength - 1] = Modules::CRCModule::GetCRC8CheckSum(packet.data(), PacketLength - 1);
+
+			Input.Port->Write(packet);
+			LastRequestTime = current_time;
+		}
+
+		//==============================
+		// 发布估计结果
+		//==============================
+
+		std::shared_lock lock(EstimationMutex);
+		Output.Synchronized = Estimation.ValidSamples >= Settings.MinValidSamples;
+		Output.ClockOffset = Estimation.ClockOffset;
+		Output.RoundTripTime = Estimation.RoundTripTime;
+		lock.unlock();
+
+		Output.CaptureTime = ToMCUTime(frame.CaptureTime);
+		Output.AimTime = Input.AimTime ? ToMCUTime(*Input.AimTime) : Output.CaptureTime;
+	}
+
+	/// 将上位机时间换算为下位机时钟计数
+	std::uint32_t ClockSynchronizationService::ToMCUTime(std::chrono::steady_clock::time_point time) const
+	{
+		double offset = Output.Synchronized ? Output.ClockOffset : 0.0;
+		double ticks = (static_cast<double>(GetHostMicroseconds(time)) + offset) * Settings.MCUTicksPerSecond / 1e6;
+
+		ticks = std::fmod(ticks, CounterPeriod);
+		if (ticks < 0)
+		{
+			ticks += CounterPeriod;
+		}
+		return static_cast<std::uint32_t>(ticks);
+	}
+
+	/// 接收线程主循环
+	void ClockSynchronizationService::ReceiveLoop()
+	{
+		std::vector<unsigned char> buffer;
+
+		while (Receiving)
+		{
+			std::vector<unsigned char> data;
+			try
+			{
+				if (!Input.Port->WaitForData(std::chrono::milliseconds(10)))
+				{
+					continue;
+				}
+				data = Input.Port->Read();
+			}
+			catch (std::exception& error)
+			{
+				// 串口被关闭或出错时结束接收，不影响主循环
+				std::clog << "ClockSynchronizationService::ReceiveLoop " << error.what() << std::endl;
+				break;
+			}
+			// 应答到达时间需要在读取后立即记录
+			auto receive_time = std::chrono::steady_clock::now();
+
+			buffer.insert(buffer.end(), data.begin(), data.end());
+
+			// 按包头和校验码重新对齐数据流，丢弃无法识别的字节
+			std::size_t position = 0;
+			while (buffer.size() - position >= PacketLength)
+			{
+				const unsigned char* packet = buffer.data() + position;
+				if (packet[0] == SynchronizeCommand &&
+					packet[PacketLength - 1] == Modules::CRCModule::GetCRC8CheckSum(
+							const_cast<unsigned char*>(packet), PacketLength - 1))
+				{
+					HandleResponse(packet, receive_time);
+					position += PacketLength;
+				}
+				else
+				{
+					++position;
+				}
+			}
+			buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(position));
+		}
+	}
+
+	/// 处理一个应答包
+	void ClockSynchronizationService::HandleResponse(const unsigned char *packet,
+												  std::chrono::steady_clock::time_point receive_time)
+	{
+		std::uint32_t echoed_send_time, mcu_receive_ticks, mcu_send_ticks;
+		std::memcpy(&echoed_send_time, packet + 1, sizeof(echoed_send_time));
+		std::memcpy(&mcu_receive_ticks, packet + 5, sizeof(mcu_receive_ticks));
+		std::memcpy(&mcu_send_ticks, packet + 9, sizeof(mcu_send_ticks));
+
+		//==============================
+		// 计算样本
+		//==============================
+
+		const double microseconds_per_tick = 1e6 / Settings.MCUTicksPerSecond;
+
+		// 上位机时间只发送了低32位，利用无符号减法还原完整的发送时间
+		auto host_receive_time = GetHostMicroseconds(receive_time);
+		auto elapsed = static_cast<std::uint32_t>(host_receive_time) - echoed_send_time;
+		auto host_send_time = host_receive_time - static_cast<std::int64_t>(elapsed);
+
+		// 下位机处理耗时
+		double mcu_hold_time = static_cast<std::uint32_t>(mcu_send_ticks - mcu_receive_ticks) * microseconds_per_tick;
+
+		double round_trip_time = static_cast<double>(elapsed) - mcu_hold_time;
+		if (round_trip_time < 0)
+		{
+			return;
+		}
+
+		double clock_offset = ((mcu_receive_ticks * microseconds_per_tick - static_cast<double>(host_send_time)) +
+				(mcu_send_ticks * microseconds_per_tick - static_cast<double>(host_receive_time))) / 2.0;
+
+		//==============================
+		// 滤波
+		//==============================
+
+		std::unique_lock lock(EstimationMutex);
+
+		Estimation.RecentRoundTripTimes.push_back(round_trip_time);
+		while (Estimation.RecentRoundTripTimes.size() > Settings.SampleWindowSize)
+		{
+			Estimation.RecentRoundTripTimes.pop_front();
+		}
+		double min_round_trip_time = *std::min_element(Estimation.RecentRoundTripTimes.begin(),
+												   Estimation.RecentRoundTripTimes.end());
+
+		// 往返时间过长的样本延迟不对称的可能性较大，不参与偏移估计
+		if (round_trip_time > min_round_trip_time * Settings.RoundTripTimeToleranceRatio)
+		{
+			return;
+		}
+
+		if (Estimation.ValidSamples == 0)
+		{
+			Estimation.ClockOffset = clock_offset;
+			Estimation.RoundTripTime = round_trip_time;
+		}
+		else
+		{
+			// 下位机计数器溢出时偏移会跳变一个计数周期，将样本折算到最接近当前估计的周期
+			const double period = CounterPeriod * microseconds_per_tick;
+			double difference = clock_offset - Estimation.ClockOffset;
+			difference -= std::round(difference / period) * period;
+
+			Estimation.ClockOffset += Settings.OffsetFilterGain * difference;
+			Estimation.RoundTripTime += Settings.RoundTripTimeFilterGain * (round_trip_time - Estimation.RoundTripTime);
+		}
+		++Estimation.ValidSamples;
+	}
+
+	/// 获取上位机时间
+	std::int64_t ClockSynchronizationService::GetHostMicroseconds(std::chrono::steady_clock::time_point time)
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+	}
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <SparrowEngine/SparrowEngine.hpp>
+#include <SerialPortDriver/SerialPortDriver.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <shared_mutex>
+#include <vector>
+
+namespace RoboPioneers::Prometheus
+{
+	/**
+	 * @brief 时钟同步服务
+	 * @author Vincent
+	 * @details
+	 *  ~ 该服务通过串口与下位机进行类似NTP的请求/应答交换，持续估计上下位机的时钟偏移和往返时间。
+	 *  ~ 请求包在每帧更新时按周期发送，应答包由独立的接收线程读取，以便准确记录应答到达时间。
+	 *  ~ 估计结果经过滤波后，每帧更新至输出，同时将当前帧的采集时间换算为下位机时钟。
+	 *  ~ 请求包格式（15字节）：0为同步指令，1~4为上位机发送时间（微秒），5~8为序号，9~13保留，14为CRC8校验码。
+	 *  ~ 应答包格式（15字节）：0为同步指令，1~4为原样返回的上位机发送时间，
+	 *    5~8为下位机接收时间，9~12为下位机发送时间（下位机时钟计数），13保留，14为CRC8校验码。
+	 */
+	class ClockSynchronizationService : public Sparrow::Service
+	{
+	public:
+		/// 同步指令，需要与目标数据包的指令集区分
+		static constexpr unsigned char SynchronizeCommand = 0x03;
+		/// 同步数据包长度
+		static constexpr std::size_t PacketLength = 15;
+
+		//==============================
+		// 输入输出部分
+		//==============================
+
+		/// 输入
+		struct {
+			/// 串口对象，为空时不进行同步
+			Modules::SerialPortDriver::SerialPort* Port {nullptr};
+			/// 目标坐标对应的时刻，为空时与采集时间相同
+			const std::chrono::steady_clock::time_point* AimTime {nullptr};
+		}Input;
+
+		/// 输出
+		struct {
+			/// 是否已经取得可信的同步结果
+			bool Synchronized {false};
+			/**
+			 * @brief 时钟偏移，单位为微秒
+			 * @details
+			 *  ~ 下位机时间减去上位机时间。
+			 */
+			double ClockOffset {0.0};
+			/// 往返时间，单位为微秒
+			double RoundTripTime {0.0};
+			/// 当前帧采集时间，单位为下位机时钟计数
+			std::uint32_t CaptureTime {0};
+			/// 目标坐标对应的时刻，单位为下位机时钟计数
+			std::uint32_t AimTime {0};
+		}Output;
+
+		//==============================
+		// 设定部分
+		//==============================
+
+		struct {
+			/// 同步请求发送周期
+			std::chrono::milliseconds RequestPeriod {100};
+			/// 下位机时钟频率，即每秒的时钟计数
+			double MCUTicksPerSecond {1000000.0};
+			/// 时钟偏移一阶低通滤波系数，0.0f~1.0f，越大则越信任新样本
+			double OffsetFilterGain {0.1};
+			/// 往返时间一阶低通滤波系数，0.0f~1.0f
+			double RoundTripTimeFilterGain {0.1};
+			/**
+			 * @brief 往返时间容许倍率
+			 * @details
+			 *  ~ 往返时间超过近期最小往返时间该倍数的样本将被丢弃。
+			 *  ~ 往返时间越长，对称延迟的假设越不可靠，故只采信较快的交换。
+			 */
+			double RoundTripTimeToleranceRatio {1.5};
+			/// 统计最小往返时间所使用的近期样本数
+			std::size_t SampleWindowSize {16};
+			/// 判定为已同步所需要的有效样本数
+			std::size_t MinValidSamples {3};
+		}Settings;
+
+	private:
+		/// 接收线程
+		std::thread ReceivingThread;
+		/// 接收线程运行旗标
+		std::atomic_bool Receiving {false};
+
+		/// 估计结果互斥量
+		mutable std::shared_mutex EstimationMutex;
+		/// 估计结果，由接收线程更新
+		struct {
+			/// 有效样本数
+			std::size_t ValidSamples {0};
+			/// 时钟偏移估计，单位为微秒
+			double ClockOffset {0.0};
+			/// 往返时间估计，单位为微秒
+			double RoundTripTime {0.0};
+			/// 近期往返时间样本
+			std::deque<double> RecentRoundTripTimes;
+		}Estimation;
+
+		/// 上次发送请求的时间
+		std::chrono::steady_clock::time_point LastRequestTime {};
+		/// 请求序号
+		std::uint32_t RequestSequence {0};
+
+	public:
+		/// 析构函数，将停止接收线程
+		~ClockSynchronizationService();
+
+		/**
+		 * @brief 开始接收应答
+		 * @throw std::logic_error 当未给定串口对象
+		 * @details
+		 *  ~ 将启动接收线程。应当在串口配置完成后调用。
+		 */
+		void Start();
+
+		/**
+		 * @brief 停止接收应答
+		 * @details
+		 *  ~ 将等待接收线程退出，最长等待一个轮询周期。
+		 */
+		void Stop();
+
+		/**
+		 * @brief 将上位机时间换算为下位机时钟计数
+		 * @param time 上位机steady_clock时间
+		 * @return 下位机时钟计数，未同步时偏移按0计算
+		 */
+		[[nodiscard]] std::uint32_t ToMCUTime(std::chrono::steady_clock::time_point time) const;
+
+	protected:
+		/// 更新方法
+		void OnUpdate(Sparrow::Frame &frame) override;
+
+		/// 接收线程主循环
+		void ReceiveLoop();
+
+		/**
+		 * @brief 处理一个应答包
+		 * @param packet 应答包起始地址，长度为PacketLength
+		 * @param receive_time 应答到达时间
+		 */
+		void HandleResponse(const unsigned char* packet, std::chrono::steady_clock::time_point receive_time);
+
+		/// 获取上位机时间，单位为微秒
+		static std::int64_t GetHostMicroseconds(std::chrono::steady_clock::time_point time);
+	};
+}
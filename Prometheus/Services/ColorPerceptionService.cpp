@@ -1,96 +1,392 @@
 #include "ColorPerceptionService.hpp"
 
-#include "../Modules/CUDAUtility.hpp"
 #include "../Modules/ImageDebugUtility.hpp"
 
 namespace RoboPioneers::Prometheus
 {
-	//==============================
-	// 处理过程
-	//==============================
+	namespace
+	{
+		#ifdef NO_CUDA
+		/// 内存版本的图像运算没有流，以空类型占位
+		struct PictureStream {};
+		#else
+		/// 显存版本的图像运算所在的流
+		using PictureStream = cv::cuda::Stream;
+		#endif
+
+		/// 原处理链所用的图像运算，内存与显存版本接口一致，内存版本忽略流
+		namespace PictureOperations
+		{
+			/// 分离通道
+			void Split(const Sparrow::PictureType& picture, std::vector<Sparrow::PictureType>& channels,
+			  [[maybe_unused]] PictureStream& stream)
+			{
+				#ifdef NO_CUDA
+				cv::split(picture, channels);
+				#else
+				cv::cuda::split(picture, channels, stream);
+				#endif
+			}
+
+			/// 阈值
+			void Threshold(const Sparrow::PictureType& picture, Sparrow::PictureType& result, double threshold,
+				  int type, [[maybe_unused]] PictureStream& stream)
+			{
+				#ifdef NO_CUDA
+				cv::threshold(picture, result, threshold, 255, type);
+				#else
+				cv::cuda::threshold(picture, result, threshold, 255, type, stream);
+				#endif
+			}
+
+			/**
+			 * @brief 以全零图像初始化结果
+			 * @details
+			 *  ~ 带蒙版的显存位运算不写入蒙版为0的像素，新建的结果需要先清零，否则这些像素为未初始化的显存。
+			 *    内存版本新建结果时已经清零，这里一并清零以保持一致。
+			 */
+			void Zeros(const Sparrow::PictureType& like, Sparrow::PictureType& result,
+			  [[maybe_unused]] PictureStream& stream)
+			{
+				#ifdef NO_CUDA
+				result = cv::Mat::zeros(like.size(), like.type());
+				#else
+				result.create(like.size(), like.type());
+				result.setTo(cv::Scalar::all(0), stream);
+				#endif
+			}
+
+			/// 按位或
+			void BitwiseOr(const Sparrow::PictureType& left, const Sparrow::PictureType& right,
+				  Sparrow::PictureType& result, const Sparrow::PictureType& mask,
+				  [[maybe_unused]] PictureStream& stream)
+			{
+				#ifdef NO_CUDA
+				cv::bitwise_or(left, right, result, mask);
+				#else
+				cv::cuda::bitwise_or(left, right, result, mask, stream);
+				#endif
+			}
+
+			/// 按位与，蒙版为空时不使用蒙版
+			void BitwiseAnd(const Sparrow::PictureType& left, const Sparrow::PictureType& right,
+				   Sparrow::PictureType& result, const Sparrow::PictureType& mask,
+				   [[maybe_unused]] PictureStream& stream)
+			{
+				#ifdef NO_CUDA
+				cv::bitwise_and(left, right, result, mask);
+				#else
+				cv::cuda::bitwise_and(left, right, result, mask, stream);
+				#endif
+			}
+		}
+	}
+
+	/// 构造函数
+	ColorPerceptionService::ColorPerceptionService()
+	{
+		// 只有量化为8/8/8位且由阈值绘制的查找表与阈值判定逐位一致，其余情况下查表分类只与其自身一致。
+		// 参与测量的后端必须与设定中的分类方式输出一致，测量期间及锁定后蒙版才不会改变。
+		// 原处理链每帧分配显存，仅用于对照，不作为候选后端。
+		auto lookup_table_exact = [this]{
+			const auto& quantization = Settings.LookupTable.Quantization;
+			return Settings.LookupTable.Path.empty() && quantization.HueBits == 8 &&
+				quantization.SaturationBits == 8 && quantization.ValueBits == 8;
+		};
+		auto lookup_table_available = [this, lookup_table_exact]{
+			return Settings.Classifier == ClassifierEnum::LookupTable || lookup_table_exact();
+		};
+		auto threshold_available = [this, lookup_table_exact]{
+			return Settings.Classifier != ClassifierEnum::LookupTable || lookup_table_exact();
+		};
+
+		Backends.Register("FusedThreshold", [this]{ Settings.Classifier = ClassifierEnum::FusedThreshold; },
+					threshold_available);
+		Backends.Register("LookupTable", [this]{ Settings.Classifier = ClassifierEnum::LookupTable; },
+					lookup_table_available);
+	}
 
 	/// 筛选红色
-	cv::cuda::GpuMat ColorPerceptionService::FilterRedArea(const cv::cuda::GpuMat& hsv_picture) const
+	Sparrow::PictureType ColorPerceptionService::FilterRedArea(const Sparrow::PictureType& hsv_picture)
 	{
-		std::vector<cv::cuda::GpuMat> channels;
-		cv::cuda::split(hsv_picture, channels);
+		#ifdef NO_CUDA
+		PictureStream stream;
+		#else
+		auto& stream = Properties.Stream;
+		#endif
+
+		std::vector<Sparrow::PictureType> channels;
+		PictureOperations::Split(hsv_picture, channels, stream);
 
 		// 第一区段色调蒙版
-		cv::cuda::GpuMat hue1;
-		cv::cuda::threshold(channels[0], hue1, Settings.RedThresholds.Hue1UpperBound, 255,
-					  cv::THRESH_BINARY_INV);
+		Sparrow::PictureType hue1;
+		PictureOperations::Threshold(channels[0], hue1, Settings.RedThresholds.Hue1UpperBound,
+					  cv::THRESH_BINARY_INV, stream);
 
 		// 第二区段色调蒙版
-		cv::cuda::GpuMat hue2;
-		cv::cuda::threshold(channels[0], hue2, Settings.RedThresholds.Hue2LowerBound, 255,
-					  cv::THRESH_BINARY);
+		Sparrow::PictureType hue2;
+		PictureOperations::Threshold(channels[0], hue2, Settings.RedThresholds.Hue2LowerBound,
+					  cv::THRESH_BINARY, stream);
 
 		// 饱和度蒙版
-		cv::cuda::GpuMat saturation;
-		cv::cuda::threshold(channels[1], saturation, Settings.RedThresholds.SaturationLowerBound, 255,
-					  cv::THRESH_BINARY);
+		Sparrow::PictureType saturation;
+		PictureOperations::Threshold(channels[1], saturation, Settings.RedThresholds.SaturationLowerBound,
+					  cv::THRESH_BINARY, stream);
 
 		// 值蒙版
-		cv::cuda::GpuMat value;
-		cv::cuda::threshold(channels[2], value, Settings.RedThresholds.ValueLowerBound, 255,
-					  cv::THRESH_BINARY);
+		Sparrow::PictureType value;
+		PictureOperations::Threshold(channels[2], value, Settings.RedThresholds.ValueLowerBound,
+					  cv::THRESH_BINARY, stream);
 
 		// 制作蒙版
-		cv::cuda::GpuMat mask;
-		cv::cuda::bitwise_or(hue1, hue2, mask, saturation);
-		cv::cuda::bitwise_and(mask, value, mask);
+		Sparrow::PictureType mask;
+		PictureOperations::Zeros(hue1, mask, stream);
+		PictureOperations::BitwiseOr(hue1, hue2, mask, saturation, stream);
+		PictureOperations::BitwiseAnd(mask, value, mask, Sparrow::PictureType(), stream);
 
 		return mask;
 	}
 
 	/// 筛选蓝色区域
-	cv::cuda::GpuMat ColorPerceptionService::FilterBlueArea(const cv::cuda::GpuMat& hsv_picture) const
+	Sparrow::PictureType ColorPerceptionService::FilterBlueArea(const Sparrow::PictureType& hsv_picture)
 	{
-		std::vector<cv::cuda::GpuMat> channels;
-		cv::cuda::split(hsv_picture, channels);
+		#ifdef NO_CUDA
+		PictureStream stream;
+		#else
+		auto& stream = Properties.Stream;
+		#endif
+
+		std::vector<Sparrow::PictureType> channels;
+		PictureOperations::Split(hsv_picture, channels, stream);
 
 		// 色调蒙版
-		cv::cuda::GpuMat hue;
-		cv::cuda::threshold(channels[0], hue, Settings.BlueThresholds.HueLowerBound,
-					  255, cv::THRESH_BINARY);
-		cv::cuda::threshold(hue, hue, Settings.BlueThresholds.HueUpperBound,
-					  255, cv::THRESH_BINARY_INV);
+		Sparrow::PictureType hue;
+		PictureOperations::Threshold(channels[0], hue, Settings.BlueThresholds.HueLowerBound,
+					  cv::THRESH_BINARY, stream);
+		PictureOperations::Threshold(hue, hue, Settings.BlueThresholds.HueUpperBound,
+					  cv::THRESH_BINARY_INV, stream);
 
 		// 饱和度蒙版
-		cv::cuda::GpuMat saturation;
-		cv::cuda::threshold(channels[1], saturation, Settings.BlueThresholds.SaturationLowerBound,
-					  255, cv::THRESH_BINARY);
+		Sparrow::PictureType saturation;
+		PictureOperations::Threshold(channels[1], saturation, Settings.BlueThresholds.SaturationLowerBound,
+					  cv::THRESH_BINARY, stream);
 
 		// 亮度蒙版
-		cv::cuda::GpuMat value;
-		cv::cuda::threshold(channels[2], value, Settings.BlueThresholds.ValueLowerBound,
-					  255, cv::THRESH_BINARY);
+		Sparrow::PictureType value;
+		PictureOperations::Threshold(channels[2], value, Settings.BlueThresholds.ValueLowerBound,
+					  cv::THRESH_BINARY, stream);
 
-		cv::cuda::GpuMat mask;
-		cv::cuda::bitwise_and(hue, value, mask, saturation);
+		Sparrow::PictureType mask;
+		PictureOperations::Zeros(hue, mask, stream);
+		PictureOperations::BitwiseAnd(hue, value, mask, saturation, stream);
 
 		return mask;
 	}
 
+	/// 获取红色范围
+	auto ColorPerceptionService::GetRedRange() const -> Modules::ColorThresholdModule::ColorRange
+	{
+		using Modules::ColorThresholdModule;
+
+		ColorThresholdModule::ColorRange range;
+		range.HueIntervals[0] = ColorThresholdModule::NotGreaterThan(Settings.RedThresholds.Hue1UpperBound);
+		range.HueIntervals[1] = ColorThresholdModule::GreaterThan(Settings.RedThresholds.Hue2LowerBound);
+		range.SaturationInterval = ColorThresholdModule::GreaterThan(Settings.RedThresholds.SaturationLowerBound);
+		range.ValueInterval = ColorThresholdModule::GreaterThan(Settings.RedThresholds.ValueLowerBound);
+		return range;
+	}
+
+	/// 获取蓝色范围
+	auto ColorPerceptionService::GetBlueRange() const -> Modules::ColorThresholdModule::ColorRange
+	{
+		using Modules::ColorThresholdModule;
+
+		ColorThresholdModule::ColorRange range;
+
+		// 原处理链的第二次阈值作用于第一次的二值结果而非色调本身，
+		// 其实际判定为：上界小于0时为空，上界不小于255时为全范围，否则为色调不大于下界。
+		const auto hue_lower = Settings.BlueThresholds.HueLowerBound;
+		const auto hue_upper = Settings.BlueThresholds.HueUpperBound;
+		if (hue_upper < 0)
+		{
+			range.HueIntervals[0] = ColorThresholdModule::Interval{1, 0};
+		}
+		else if (hue_upper >= 255)
+		{
+			range.HueIntervals[0] = ColorThresholdModule::Interval{0, 255};
+		}
+		else
+		{
+			range.HueIntervals[0] = ColorThresholdModule::NotGreaterThan(hue_lower);
+		}
+
+		range.SaturationInterval = ColorThresholdModule::GreaterThan(Settings.BlueThresholds.SaturationLowerBound);
+		range.ValueInterval = ColorThresholdModule::GreaterThan(Settings.BlueThresholds.ValueLowerBound);
+		return range;
+	}
+
+	/// 更新颜色查找表
+	void ColorPerceptionService::UpdateLookupTable()
+	{
+		if (!Settings.LookupTable.Path.empty())
+		{
+			if (Properties.LookupTablePath != Settings.LookupTable.Path)
+			{
+				Properties.LookupTable.Load(Settings.LookupTable.Path);
+				Properties.LookupTablePath = Settings.LookupTable.Path;
+				Properties.LookupTableKey.clear();
+			}
+			return;
+		}
+
+		std::vector<int> key {
+			Settings.LookupTable.Quantization.HueBits,
+			Settings.LookupTable.Quantization.SaturationBits,
+			Settings.LookupTable.Quantization.ValueBits,
+			Settings.RedThresholds.Hue1UpperBound,
+			Settings.RedThresholds.Hue2LowerBound,
+			Settings.RedThresholds.SaturationLowerBound,
+			Settings.RedThresholds.ValueLowerBound,
+			Settings.BlueThresholds.HueLowerBound,
+			Settings.BlueThresholds.HueUpperBound,
+			Settings.BlueThresholds.SaturationLowerBound,
+			Settings.BlueThresholds.ValueLowerBound
+		};
+		if (key == Properties.LookupTableKey && Properties.LookupTablePath.empty())
+		{
+			return;
+		}
+
+		Properties.LookupTable.Reset(Settings.LookupTable.Quantization);
+		Properties.LookupTable.Paint(GetRedRange(), Modules::ColorLookupTable::ClassBit::Red);
+		Properties.LookupTable.Paint(GetBlueRange(), Modules::ColorLookupTable::ClassBit::Blue);
+		Properties.LookupTableKey = std::move(key);
+		Properties.LookupTablePath.clear();
+	}
+
+	/// 获取缓冲区视图
+	Sparrow::PictureType ColorPerceptionService::GetBufferView(Sparrow::PictureType &buffer, const cv::Size &size)
+	{
+		if (buffer.cols < size.width || buffer.rows < size.height)
+		{
+			buffer.create(std::max(buffer.rows, size.height), std::max(buffer.cols, size.width), CV_8UC1);
+		}
+		return buffer(cv::Rect(0, 0, size.width, size.height));
+	}
+
 	/// 更新方法
 	void ColorPerceptionService::OnUpdate(Sparrow::Frame &frame)
 	{
-		if (Settings.TargetColor == TargetColorEnum::Red)
+		auto threshold_view = GetBufferView(Properties.ThresholdBuffer, frame.GpuPicture.size());
+		const auto target_class = Settings.TargetColor == TargetColorEnum::Red ?
+				Modules::ColorLookupTable::ClassBit::Red : Modules::ColorLookupTable::ClassBit::Blue;
+
+		if (Settings.OutputClassMap || Settings.Classifier == ClassifierEnum::LookupTable)
 		{
-			/// 筛选红色区域
-			Output.MaskPicture = FilterRedArea(frame.GpuPicture);
+			UpdateLookupTable();
 		}
-		else if (Settings.TargetColor == TargetColorEnum::Blue)
+
+		if (Settings.OutputClassMap)
 		{
-			/// 筛选蓝色区域
-			Output.MaskPicture = FilterBlueArea(frame.GpuPicture);
+			Output.ClassMap = GetBufferView(Properties.ClassMapBuffer, frame.GpuPicture.size());
+		}
+		else
+		{
+			Output.ClassMap.release();
 		}
 
-		/// 应用开运算过滤器
-		Properties.CloseFilter->apply(Output.MaskPicture, Output.MaskPicture);
+		#ifndef NO_CUDA
+		auto& stream = Properties.Stream;
+		#endif
 
-		/// 等待设备运算结束
-		Modules::CUDAUtility::SynchronizeDevice();
+		if (Settings.Classifier == ClassifierEnum::LookupTable)
+		{
+			/// 查表筛选目标颜色区域
+			if (Settings.OutputClassMap)
+			{
+				/// 一次读取画面同时得到类别图与目标蒙版
+				#ifdef NO_CUDA
+				Properties.LookupTable.ClassifyAndThreshold(frame.GpuPicture, Output.ClassMap, threshold_view,
+												target_class);
+				#else
+				Properties.LookupTable.ClassifyAndThreshold(frame.GpuPicture, Output.ClassMap, threshold_view,
+												target_class, stream);
+				#endif
+			}
+			else
+			{
+				#ifdef NO_CUDA
+				Properties.LookupTable.Threshold(frame.GpuPicture, threshold_view, target_class);
+				#else
+				Properties.LookupTable.Threshold(frame.GpuPicture, threshold_view, target_class, stream);
+				#endif
+			}
+		}
+		else if (Settings.Classifier == ClassifierEnum::FusedThreshold)
+		{
+			/// 单趟筛选目标颜色区域
+			const auto range = Settings.TargetColor == TargetColorEnum::Red ? GetRedRange() : GetBlueRange();
+			#ifdef NO_CUDA
+			Modules::ColorThresholdModule::Threshold(frame.GpuPicture, threshold_view, range);
+			#else
+			Modules::ColorThresholdModule::Threshold(frame.GpuPicture, threshold_view, range, stream);
+			#endif
+		}
+		else
+		{
+			/// 筛选红色或蓝色区域
+			const auto mask = Settings.TargetColor == TargetColorEnum::Red ?
+					FilterRedArea(frame.GpuPicture) : FilterBlueArea(frame.GpuPicture);
+			#ifdef NO_CUDA
+			mask.copyTo(threshold_view);
+			#else
+			mask.copyTo(threshold_view, stream);
+			#endif
+		}
+
+		if (Settings.OutputClassMap && Settings.Classifier != ClassifierEnum::LookupTable)
+		{
+			/// 其他分类方式下单独生成类别图
+			#ifdef NO_CUDA
+			Properties.LookupTable.Classify(frame.GpuPicture, Output.ClassMap);
+			#else
+			Properties.LookupTable.Classify(frame.GpuPicture, Output.ClassMap, stream);
+			#endif
+		}
+
+		Output.ThresholdPicture = threshold_view;
+
+		if (Settings.OutputPackedMask)
+		{
+			#ifdef NO_CUDA
+			/// 在内存中压缩，再按位并行应用闭运算
+			Output.PackedMask.Pack(threshold_view);
+			#else
+			/// 在显存中压缩并下载，再按位并行应用闭运算
+			Output.PackedMask.Download(threshold_view, Properties.PackedMaskDeviceBuffer, stream);
+			#endif
+			Output.PackedMask.CloseCross(Properties.PackedMaskTemporary, CloseCrossRadius);
+			Output.MaskPicture = Sparrow::PictureType();
+		}
+		else
+		{
+			/// 清空压缩蒙版，使下游服务回退到颜色蒙版
+			Output.PackedMask.Create(0, 0);
+
+			/// 应用闭运算过滤器
+			Output.MaskPicture = GetBufferView(Properties.MaskBuffer, frame.GpuPicture.size());
+			#ifdef NO_CUDA
+			cv::morphologyEx(threshold_view, Output.MaskPicture, cv::MORPH_CLOSE, Properties.CloseKernel,
+					cv::Point(-1, -1), 1, cv::BORDER_REFLECT_101);
+			#else
+			Properties.CloseFilter->apply(threshold_view, Output.MaskPicture, stream);
+			#endif
+		}
+
+		#ifndef NO_CUDA
+		/// 只等待本服务的流，不等待其他服务实例在各自流上的运算
+		stream.waitForCompletion();
+		#endif
 
 		#ifdef DEBUG
 //		Modules::ImageDebugUtility::ShowGPUPicture("Color Perception", Output.MaskPicture);
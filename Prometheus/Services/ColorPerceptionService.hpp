@@ -2,12 +2,17 @@
 
 #include <SparrowEngine/SparrowEngine.hpp>
 #include <opencv4/opencv2/opencv.hpp>
+#ifndef NO_CUDA
 #include <opencv4/opencv2/cudaimgproc.hpp>
 #include <opencv4/opencv2/cudaarithm.hpp>
 #include <opencv4/opencv2/cudafilters.hpp>
+#endif
 #include <list>
 
 #include "../Modules/GeometryFeatureModule.hpp"
+#include "../Modules/ColorThresholdModule.hpp"
+#include "../Modules/ColorLookupTable.hpp"
+#include "../Modules/PackedBinaryMask.hpp"
 
 namespace RoboPioneers::Prometheus
 {
@@ -16,6 +21,12 @@ namespace RoboPioneers::Prometheus
 	 * @author Vincent
 	 * @details
 	 *  ~ 该服务用于从画面中检测出在敌人颜色范围内的区域。
+	 *  ~ 定义NO_CUDA宏时所有处理在内存中进行，分类使用各模块的SIMD版本，输出与显存版本一致，
+	 *    只是输出图像位于内存中。
+	 *  ~ 单趟阈值与查找表两种分类方式注册为候选后端，由运行时在启动时测量并选择较快的一种。
+	 *    查找表只在量化为8/8/8位且由阈值绘制时与单趟阈值一致，否则只有与设定中的分类方式一致的后端参与测量，
+	 *    通常即不进行测量。
+	 *  ~ 原处理链与单趟阈值逐位一致，但每帧分配显存，仅用于对照，不注册为候选后端。
 	 */
 	class ColorPerceptionService : public Sparrow::Service
 	{
@@ -26,8 +37,32 @@ namespace RoboPioneers::Prometheus
 
 		/// 输出
 		struct {
-			/// 感知蒙版图片，在范围内的像素点的位置被设置为255，否则为0
-			cv::cuda::GpuMat MaskPicture;
+			/**
+			 * @brief 感知蒙版图片，经过闭运算，在范围内的像素点的位置被设置为255，否则为0
+			 * @details
+			 *  ~ 开启位压缩蒙版输出时闭运算在压缩蒙版上进行，该图片为空，闭运算结果见位压缩的感知蒙版。
+			 */
+			Sparrow::PictureType MaskPicture;
+			/**
+			 * @brief 阈值蒙版图片，为闭运算前的分类结果，格式同感知蒙版图片
+			 * @details
+			 *  ~ 无论是否开启位压缩蒙版输出都有效。
+			 */
+			Sparrow::PictureType ThresholdPicture;
+			/**
+			 * @brief 位压缩的感知蒙版
+			 * @details
+			 *  ~ 仅在开启位压缩蒙版输出时有效，为经过闭运算的蒙版，已位于内存中。
+			 */
+			Modules::PackedBinaryMask PackedMask;
+			/**
+			 * @brief 类别图
+			 * @details
+			 *  ~ 仅在开启类别图输出时有效，否则为空。
+			 *  ~ 每个像素的第0位表示红色，第1位表示蓝色，两位均为0表示不属于任何颜色，均为1表示同时属于两种颜色。
+			 *  ~ 下游服务可以由类别图直接取得任意一种颜色的区域，而不需要重新处理画面。
+			 */
+			Sparrow::PictureType ClassMap;
 		}Output;
 
 		//==============================
@@ -42,11 +77,59 @@ namespace RoboPioneers::Prometheus
 			Blue
 		};
 
+		/// 分类方式
+		enum class ClassifierEnum {
+			/// 分通道阈值与位运算组合的原处理链，仅用于对照
+			ThresholdChain,
+			/// 单趟阈值核函数，与原处理链逐位一致
+			FusedThreshold,
+			/**
+			 * @brief 颜色查找表，每个像素一次查表
+			 * @details
+			 *  ~ 量化为8/8/8位时与阈值判定逐位一致；量化更粗时每个单元按其中心颜色判定，
+			 *    阈值附近的像素可能与阈值判定不同，因此需要显式选择。
+			 */
+			LookupTable
+		};
+
 		/// 颜色感知设定
 		struct {
 			/// 目标颜色
 			TargetColorEnum TargetColor {TargetColorEnum::Red};
 
+			/// 分类方式，默认为与原处理链逐位一致的单趟阈值
+			ClassifierEnum Classifier {ClassifierEnum::FusedThreshold};
+
+			/**
+			 * @brief 是否输出类别图
+			 * @details
+			 *  ~ 分类方式为查找表时，类别图与目标蒙版由同一次读取画面得到；
+			 *    其他分类方式下类别图由查找表额外处理一次画面得到。
+			 */
+			bool OutputClassMap {false};
+
+			/**
+			 * @brief 是否输出位压缩蒙版
+			 * @details
+			 *  ~ 开启时阈值蒙版在显存中被压缩为每像素一位后下载，闭运算在内存中按位并行进行，
+			 *    蒙版路径上的传输量为原来的1/8。
+			 *  ~ 定义NO_CUDA宏时在内存中压缩。
+			 */
+			bool OutputPackedMask {true};
+
+			/// 颜色查找表设定
+			struct {
+				/// 量化设定，改变后查找表将被重建
+				Modules::ColorLookupTable::Quantization Quantization {};
+				/**
+				 * @brief 查找表文件路径
+				 * @details
+				 *  ~ 为空时由红蓝两色的阈值设定绘制查找表，阈值设定改变后自动重建；
+				 *  ~ 不为空时加载该文件，通常为由标注像素训练得到的查找表，此时忽略阈值设定与量化设定。
+				 */
+				std::string Path;
+			}LookupTable;
+
 			/// 红色系处理设定
 			struct {
 				/// 色调第一段最大值 0~Hue1UpperBound
@@ -78,6 +161,14 @@ namespace RoboPioneers::Prometheus
 		 *  ~ 该结构体存储可以复用的、一般贯穿服务生命周期的对象。
 		 */
 		struct {
+			#ifdef NO_CUDA
+			/**
+			 * @brief 闭运算结构元素，与显存版本的滤波器一致
+			 * @details
+			 *  ~ 显存版本的滤波器以BORDER_REFLECT_101填充边界，内存版本显式使用相同的边界规则。
+			 */
+			cv::Mat CloseKernel {cv::getStructuringElement(cv::MORPH_CROSS, cv::Size(5,5))};
+			#else
 			/**
 			 * @brief 单通道闭运算滤波器
 			 * @details
@@ -88,9 +179,53 @@ namespace RoboPioneers::Prometheus
 							cv::MORPH_CLOSE, CV_8UC1,
 							cv::getStructuringElement(cv::MORPH_CROSS, cv::Size(5,5)))
 			};
+			#endif
+
+			/**
+			 * @brief 阈值蒙版缓冲区
+			 * @details
+			 *  ~ 按出现过的最大画面尺寸分配，每帧取左上角与画面同尺寸的视图，避免裁剪画面尺寸变化时重复分配。
+			 */
+			Sparrow::PictureType ThresholdBuffer;
+
+			/// 闭运算结果缓冲区，分配方式同阈值蒙版缓冲区，输出蒙版为其视图
+			Sparrow::PictureType MaskBuffer;
+
+			#ifndef NO_CUDA
+			/// 显存中的位压缩蒙版缓冲区
+			cv::cuda::GpuMat PackedMaskDeviceBuffer;
+
+			/**
+			 * @brief CUDA流
+			 * @details
+			 *  ~ 所有核函数与显存操作都在该流上进行，更新结束前只等待该流，不同步整个设备，
+			 *    因此不会等待其他服务实例在各自流上的运算。
+			 *  ~ 默认构造的流与默认流相互同步，此前在默认流上写入画面的操作（上传、裁剪）无需额外同步。
+			 *  ~ 在后台运行的实例应当使用不与默认流同步的流，见CUDAUtility::CreateNonBlockingStream，
+			 *    此时输入画面需要在开始更新前就绪。
+			 */
+			cv::cuda::Stream Stream;
+			#endif
+			/// 位压缩闭运算的临时蒙版
+			Modules::PackedBinaryMask PackedMaskTemporary;
+
+			/// 类别图缓冲区，分配方式同阈值蒙版缓冲区，类别图为其视图
+			Sparrow::PictureType ClassMapBuffer;
+
+			/// 颜色查找表，同时绘制有红色与蓝色两个类别
+			Modules::ColorLookupTable LookupTable;
+			/// 构建当前查找表所用的设定，用于检测设定变化
+			std::vector<int> LookupTableKey;
+			/// 当前查找表加载自的文件路径，由设定绘制时为空
+			std::string LookupTablePath;
 		}Properties;
 
+		/// 构造函数，将注册各分类方式为候选后端
+		ColorPerceptionService();
+
 	protected:
+		/// 闭运算十字的臂长，与闭运算滤波器的5x5十字一致
+		static constexpr int CloseCrossRadius = 2;
 
 		//==============================
 		// 处理过程
@@ -101,14 +236,41 @@ namespace RoboPioneers::Prometheus
 		 * @param hsv_picture HSV色域上的彩色图片
 		 * @return 目标区域蒙版
 		 */
-		[[nodiscard]] cv::cuda::GpuMat FilterRedArea(const cv::cuda::GpuMat& hsv_picture) const;
+		[[nodiscard]] Sparrow::PictureType FilterRedArea(const Sparrow::PictureType& hsv_picture);
 
 		/**
 		 * @brief 筛选蓝色色系区域
 		 * @param hsv_picture HSV色域上的彩色图片
 		 * @return 目标区域蒙版
 		 */
-		[[nodiscard]] cv::cuda::GpuMat FilterBlueArea(const cv::cuda::GpuMat& hsv_picture) const;
+		[[nodiscard]] Sparrow::PictureType FilterBlueArea(const Sparrow::PictureType& hsv_picture);
+
+		/**
+		 * @brief 获取红色色系的颜色范围
+		 * @return 与FilterRedArea判定一致的颜色范围
+		 */
+		[[nodiscard]] Modules::ColorThresholdModule::ColorRange GetRedRange() const;
+
+		/**
+		 * @brief 获取蓝色色系的颜色范围
+		 * @return 与FilterBlueArea判定一致的颜色范围
+		 */
+		[[nodiscard]] Modules::ColorThresholdModule::ColorRange GetBlueRange() const;
+
+		/**
+		 * @brief 更新颜色查找表
+		 * @details
+		 *  ~ 查找表文件路径或构建查找表所用的设定改变时，重新加载或重新绘制查找表。
+		 */
+		void UpdateLookupTable();
+
+		/**
+		 * @brief 获取缓冲区视图
+		 * @param buffer 缓冲区，尺寸不足时将被重新分配
+		 * @param size 视图尺寸
+		 * @return 缓冲区左上角指定尺寸的视图
+		 */
+		static Sparrow::PictureType GetBufferView(Sparrow::PictureType& buffer, const cv::Size& size);
 
 		/// 更新方法
 		void OnUpdate(Sparrow::Frame &frame) override;
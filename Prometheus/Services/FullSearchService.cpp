@@ -0,0 +1,84 @@
+#include "FullSearchService.hpp"
+
+#include <utility>
+#include "../Modules/CUDAUtility.hpp"
+
+namespace RoboPioneers::Prometheus
+{
+	/// 构造函数
+	FullSearchService::FullSearchService()
+	{
+		Units.LightBarSearchingUnit.Input.BinaryPicture = &Units.ColorPerceptionUnit.Output.MaskPicture;
+		Units.LightBarSearchingUnit.Input.PackedBinaryPicture = &Units.ColorPerceptionUnit.Output.PackedMask;
+
+		Units.ArmorMatchingUnit.Input.LightBars = &Units.LightBarSearchingUnit.Output.LightBars;
+
+		#ifndef NO_CUDA
+		// 后台的运算不与默认流同步，主循环在默认流上的操作不会等待后台的核函数
+		Units.ColorPerceptionUnit.Properties.Stream = Modules::CUDAUtility::CreateNonBlockingStream();
+		#endif
+	}
+
+	/// 停止后台搜索
+	void FullSearchService::Stop()
+	{
+		Worker.Stop();
+	}
+
+	/// 更新方法
+	void FullSearchService::OnUpdate(Sparrow::Frame &frame)
+	{
+		//==============================
+		// 取回已完成的搜索结果
+		//==============================
+
+		Output.Updated = false;
+		// 后台空闲时，此前任务写入的结果对主循环可见
+		if (!Worker.IsBusy() && ResultPending)
+		{
+			std::swap(Output.Detections, SearchResults);
+			Output.CaptureTime = SearchCaptureTime;
+			Output.Updated = true;
+			ResultPending = false;
+		}
+
+		//==============================
+		// 开始新一次搜索
+		//==============================
+
+		++FramesSinceSearch;
+		if (!Input.Tracking || !*Input.Tracking) return;
+		if (FramesSinceSearch < Settings.Interval || Worker.IsBusy()) return;
+
+		// 帧中的画面在下一次取图后会被采集器改写，而搜索可能跨越多帧，需要在主循环中复制，复制只在显存内进行；
+		// 后台的流不与默认流同步，提交前等待复制完成
+		#ifdef NO_CUDA
+		frame.GpuPicture.copyTo(SearchPicture);
+		#else
+		frame.GpuPicture.copyTo(SearchPicture, CopyStream);
+		CopyStream.waitForCompletion();
+		#endif
+		SearchCaptureTime = frame.CaptureTime;
+
+		if (Worker.Submit([this]{ Search(); }))
+		{
+			FramesSinceSearch = 0;
+		}
+	}
+
+	/// 在后台进行一次搜索
+	void FullSearchService::Search()
+	{
+		SearchFrame.Reset(cv::Mat(), SearchPicture, SearchCaptureTime);
+
+		Units.ColorPerceptionUnit.Update(SearchFrame);
+		Units.LightBarSearchingUnit.Update(SearchFrame);
+		Units.ArmorMatchingUnit.Update(SearchFrame);
+
+		BattleIntelligenceService::BuildDetections(Units.LightBarSearchingUnit.Output.LightBars,
+											 Units.ArmorMatchingUnit.Output.PossibleArmors,
+											 SearchFrame.PointOffset, Settings.PreciseArmorRectangle,
+											 SearchFrame.Arena.GetResource(), SearchResults);
+		ResultPending = true;
+	}
+}
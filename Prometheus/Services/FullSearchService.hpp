@@ -0,0 +1,123 @@
+#pragma once
+
+#include <SparrowEngine/SparrowEngine.hpp>
+#include <opencv4/opencv2/opencv.hpp>
+#include <chrono>
+#include <vector>
+
+#include "ColorPerceptionService.hpp"
+#include "LightBarSearchingService.hpp"
+#include "ArmorMatchingService.hpp"
+#include "BattleIntelligenceService.hpp"
+
+namespace RoboPioneers::Prometheus
+{
+	/**
+	 * @brief 全图搜索服务
+	 * @author Vincent
+	 * @details
+	 *  ~ 跟踪时主循环只处理兴趣区域，该服务在后台以低优先级对整幅图像进行搜索，
+	 *    使兴趣区域以外新出现的目标也能被发现。
+	 *  ~ 每帧更新时只做两件事：取回已完成的搜索结果，以及在后台空闲且间隔足够时复制当前画面并开始新一次搜索。
+	 *    颜色感知、灯条搜索与装甲板匹配都在后台工作器中进行，使用独立的服务实例与帧对象。
+	 *  ~ 搜索结果为全图坐标的观测及其采集时刻，由战斗智能服务并入跟踪器。
+	 *  ~ 后台的颜色感知单元在不与默认流同步的CUDA流上运算，主循环与后台只等待各自的流，互不等待对方的核函数。
+	 *    搜索所用画面在主循环中复制完成后才提交搜索，后台不需要等待默认流。
+	 *  ~ 释放显存会同步整个设备，原处理链每帧分配并释放临时显存，
+	 *    因此与后台搜索并行时主循环与后台都应当使用单趟阈值或查找表分类。
+	 */
+	class FullSearchService : public Sparrow::Service
+	{
+	public:
+		/// 观测
+		using Detection = BattleIntelligenceService::Detection;
+
+		/// 输入
+		struct {
+			/// 主循环是否正在裁剪画面，为空或为false时不进行后台搜索，此时主循环本身即在处理整幅画面
+			const bool* Tracking {nullptr};
+		}Input;
+
+		/// 输出
+		struct {
+			/// 最近一次完成的搜索得到的观测，为全图坐标
+			std::vector<Detection> Detections;
+			/// 最近一次完成的搜索所用画面的采集时刻
+			std::chrono::steady_clock::time_point CaptureTime {};
+			/// 观测是否在本帧更新
+			bool Updated {false};
+		}Output;
+
+		/// 全图搜索设定
+		struct {
+			/**
+			 * @brief 两次搜索开始之间的最少帧数
+			 * @details
+			 *  ~ 为0时后台一旦空闲即开始新一次搜索，即利用全部空闲的CPU时间。
+			 */
+			unsigned int Interval {10};
+			/// 是否由轮廓构造装甲板矩形，与战斗智能服务的同名设定含义相同
+			bool PreciseArmorRectangle {false};
+		}Settings;
+
+		/**
+		 * @brief 搜索单元
+		 * @details
+		 *  ~ 只在后台工作器中更新，设定应当与主循环中对应的服务一致，并在开始搜索前设置。
+		 */
+		struct {
+			/// 颜色感知单元
+			ColorPerceptionService ColorPerceptionUnit;
+			/// 灯条搜索单元
+			LightBarSearchingService LightBarSearchingUnit;
+			/// 装甲板匹配单元
+			ArmorMatchingService ArmorMatchingUnit;
+		}Units;
+
+	private:
+		/// 搜索所用的帧对象，只在后台工作器中使用
+		Sparrow::Frame SearchFrame;
+		/// 搜索所用画面，在主循环中复制，后台空闲时才会被改写
+		Sparrow::PictureType SearchPicture;
+		/// 搜索所用画面的采集时刻
+		std::chrono::steady_clock::time_point SearchCaptureTime {};
+		#ifndef NO_CUDA
+		/// 复制搜索所用画面的CUDA流，与默认流同步，保证复制在采集器写入画面之后进行
+		cv::cuda::Stream CopyStream;
+		#endif
+
+		/// 后台写入的搜索结果
+		std::vector<Detection> SearchResults;
+		/// 是否有尚未取回的搜索结果，后台写入，后台空闲时由主循环读取
+		bool ResultPending {false};
+
+		/// 自上次开始搜索以来的帧数
+		unsigned int FramesSinceSearch {0};
+
+		/**
+		 * @brief 后台工作器
+		 * @details
+		 *  ~ 任务区域并发数为1，搜索中的并行算法只在后台线程中串行执行，不占用主循环的工作线程。
+		 *  ~ 最后声明，保证析构时先等待后台任务结束。
+		 */
+		Sparrow::BackgroundWorker Worker {1, 10};
+
+	public:
+		/// 构造函数，将连接各搜索单元的输入输出
+		FullSearchService();
+
+		/**
+		 * @brief 停止后台搜索
+		 * @details
+		 *  ~ 将等待正在进行的搜索结束，此后不再开始新的搜索。
+		 */
+		void Stop();
+
+	protected:
+		/// 更新方法
+		void OnUpdate(Sparrow::Frame &frame) override;
+
+		/// 在后台进行一次搜索
+		void Search();
+	};
+}
@@ -1,8 +1,11 @@
 #include "LightBarSearchingService.hpp"
 
 #include <tbb/tbb.h>
+#include <algorithm>
 #include <shared_mutex>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "../Modules/GeometryFeatureModule.hpp"
 #include "../Modules/MathUtility.hpp"
@@ -22,12 +25,21 @@ namespace RoboPioneers::Prometheus
 //		DebugPictureForLightBar = frame.CutPicture.clone();
 //		#endif
 
-		cv::Mat binary_picture;
-		Input.BinaryPicture->download(binary_picture);
-		auto&& [rectangles, ellipses] = SearchPossibleElements(binary_picture);
-
-		Output.PossibleRectangles = std::move(rectangles);
-		Output.PossibleEllipses = std::move(ellipses);
+		if (Input.PackedBinaryPicture && !Input.PackedBinaryPicture->Empty())
+		{
+			/// 直接在压缩蒙版上标记连通域
+			Properties.Labeler.Label(*Input.PackedBinaryPicture, Properties.Components);
+			Output.Statistics = SearchPossibleElements(Properties.Components, Output.LightBars);
+		}
+		else
+		{
+			#ifdef NO_CUDA
+			Properties.BinaryPicture = *Input.BinaryPicture;
+			#else
+			Input.BinaryPicture->download(Properties.BinaryPicture);
+			#endif
+			Output.Statistics = SearchPossibleElements(Properties.BinaryPicture, Output.LightBars);
+		}
 
 //		#ifdef DEBUG
 //		cv::imshow("Possible Light Bars", DebugPictureForLightBar);
@@ -36,7 +48,9 @@ namespace RoboPioneers::Prometheus
 
 
 	/// 搜索全部的矩形元素
-	auto LightBarSearchingService::SearchPossibleElements(const cv::Mat& binary_picture) const -> SearchingResult
+	auto LightBarSearchingService::SearchPossibleElements(const cv::Mat& binary_picture,
+														   Modules::LightBarTable& light_bars) const
+		-> CascadeStatistics
 	{
 		//==============================
 		// 感知轮廓
@@ -45,60 +59,147 @@ namespace RoboPioneers::Prometheus
 		std::vector<std::vector<cv::Point>> contours;
 		cv::findContours(binary_picture, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE);
 
+		return SearchPossibleElements(contours.size(), [&contours](std::size_t index){
+			return cv::Mat(contours[index], false);
+		}, light_bars);
+	}
+
+	/// 在连通域中搜索
+	auto LightBarSearchingService::SearchPossibleElements(const Modules::RunLengthLabeler::Result &components,
+														   Modules::LightBarTable& light_bars) const
+		-> CascadeStatistics
+	{
 		//==============================
-		// 遍历轮廓进行几何特征检测
+		// 廉价级联，快速排除不可能是灯条的连通域
 		//==============================
 
-		std::list<GeometryFeature> rectangle_result;
-		std::shared_mutex rectangle_result_mutex;
+		CascadeStatistics statistics;
+		statistics.Candidates = components.Blobs.size();
+
+		std::vector<std::size_t> candidates;
+		candidates.reserve(components.Blobs.size());
+		for (std::size_t index = 0; index < components.Blobs.size(); ++index)
+		{
+			const int passed_stages = PassCheapStages(components.Blobs[index]);
+
+			if (passed_stages >= 1) ++statistics.AreaPassed;
+			if (passed_stages >= 2) ++statistics.AspectPassed;
+			if (passed_stages >= 3) ++statistics.OrientationPassed;
+			if (passed_stages >= 4)
+			{
+				++statistics.FillingRatePassed;
+				candidates.push_back(index);
+			}
+		}
+
+		//==============================
+		// 精确拟合
+		//==============================
+
+		// 轮廓为边界点集的视图，只有拟合得到的几何特征会复制一份轮廓
+		auto fitting_statistics = SearchPossibleElements(candidates.size(), [&components, &candidates](std::size_t index){
+			return components.GetBoundary(candidates[index]);
+		}, light_bars);
+
+		statistics.FittingPassed = fitting_statistics.FittingPassed;
+		return statistics;
+	}
 
-		std::list<GeometryFeature> ellipse_result;
-		std::shared_mutex ellipse_result_mutex;
+	/// 在轮廓集合中搜索
+	auto LightBarSearchingService::SearchPossibleElements(std::size_t count,
+		const std::function<cv::Mat(std::size_t)>& get_contour,
+		Modules::LightBarTable& light_bars) const -> CascadeStatistics
+	{
+		light_bars.Clear();
 
-		tbb::parallel_for_each(contours.begin(), contours.end(),[
-				this, settings = &this->Settings,
-				&rectangle_result, &rectangle_result_mutex,
-				&ellipse_result, &ellipse_result_mutex]
-				(const std::vector<cv::Point>& contour){
-			auto&& element = this->CheckGeometryConditions(contour);
+		//==============================
+		// 候选较少时串行检验，避免任务调度的开销超过检验本身
+		//==============================
 
-			if (element)
+		if (count < Settings.Parallel.SerialThreshold)
+		{
+			for (std::size_t index = 0; index < count; ++index)
 			{
-				std::shared_mutex* mutex_pointer {nullptr};
-				std::list<GeometryFeature>* result_pointer {nullptr};
+				auto light_bar = CheckLightBar(get_contour(index));
+				if (light_bar) light_bars.Append(*light_bar);
+			}
+		}
+		else
+		{
+			//==============================
+			// 并行检验，结果先存入线程局部容器，不需要加锁
+			//==============================
 
-				switch (element->MatchingShape)
-				{
-					case Shape::Ellipse:
-						mutex_pointer = &ellipse_result_mutex;
-						result_pointer = &ellipse_result;
-						break;
-					case Shape::Rectangle:
-						mutex_pointer = &rectangle_result_mutex;
-						result_pointer = &rectangle_result;
-						break;
-				}
+			using IndexedFeature = std::pair<std::size_t, GeometryFeature>;
+			tbb::enumerable_thread_specific<std::vector<IndexedFeature>> local_results;
 
-				if (element->GeometryParameters.Angle < 60 || element->GeometryParameters.Angle > 120)
+			// 每个线程约分到4个任务，任务不小于最小粒度
+			const auto concurrency = static_cast<std::size_t>(std::max(tbb::this_task_arena::max_concurrency(), 1));
+			const auto grain_size = std::max(Settings.Parallel.MinimumGrainSize, count / (4 * concurrency));
+
+			tbb::parallel_for(tbb::blocked_range<std::size_t>(0, count, std::max<std::size_t>(grain_size, 1)),
+				[this, &get_contour, &local_results](const tbb::blocked_range<std::size_t>& range){
+				auto& local_result = local_results.local();
+				for (std::size_t index = range.begin(); index < range.end(); ++index)
 				{
-					return;
+					auto light_bar = this->CheckLightBar(get_contour(index));
+					if (light_bar) local_result.emplace_back(index, std::move(*light_bar));
 				}
+			});
 
-//				if (element->GeometryParameters.Length / element->GeometryParameters.Width < 3)
-//				{
-//					return;
-//				}
+			//==============================
+			// 按轮廓下标合并，使结果与线程调度无关
+			//==============================
 
-				std::unique_lock lock(*mutex_pointer);
-				result_pointer->push_back(element->GeometryParameters);
+			std::vector<IndexedFeature*> merged;
+			for (auto& local_result : local_results)
+			{
+				for (auto& item : local_result) merged.push_back(&item);
 			}
+			std::sort(merged.begin(), merged.end(), [](const IndexedFeature* a, const IndexedFeature* b){
+				return a->first < b->first;
+			});
+
+			light_bars.Reserve(merged.size());
+			for (const auto* item : merged)
+			{
+				light_bars.Append(item->second);
+			}
+		}
+
+		// 轮廓没有预先计算的统计量，廉价级联视为全部通过
+		CascadeStatistics statistics;
+		statistics.Candidates = statistics.AreaPassed = statistics.AspectPassed = count;
+		statistics.OrientationPassed = statistics.FillingRatePassed = count;
+		statistics.FittingPassed = light_bars.Size();
+
+		return statistics;
+	}
+
+	/// 检验单个灯条
+	auto LightBarSearchingService::CheckLightBar(const cv::Mat &contour) const
+		-> std::optional<GeometryFeature>
+	{
+		auto&& element = this->CheckGeometryConditions(contour);
+		if (!element) return std::nullopt;
+
+		if (element->GeometryParameters.Angle < Settings.MinimumAngle ||
+			element->GeometryParameters.Angle > Settings.MaximumAngle)
+		{
+			return std::nullopt;
+		}
+
+//		if (element->GeometryParameters.Length / element->GeometryParameters.Width < 3)
+//		{
+//			return std::nullopt;
+//		}
 
-			#ifdef DEBUG
-				std::unique_lock lock(DebugPictureForLightBarMutex);
+		#ifdef DEBUG
+			std::unique_lock lock(DebugPictureForLightBarMutex);
 
-				Modules::ImageDebugUtility::DrawRotatedRectangle(
-						DebugPictureForLightBar, element->GeometryParameters.Raw.CircumscribedRectangle,
-						cv::Scalar(47,255,173), 1);
+			Modules::ImageDebugUtility::DrawRotatedRectangle(
+					DebugPictureForLightBar, element->GeometryParameters.Raw.CircumscribedRectangle,
+					cv::Scalar(47,255,173), 1);
 //				cv::line(DebugPictureForLightBar, element->GeometryParameters.Center,
 //				         Modules::MathUtility::PointAddVector(element->GeometryParameters.Center,
 //											   -element->GeometryParameters.Vectors.AnticlockwiseDiagonal),
@@ -119,23 +220,73 @@ namespace RoboPioneers::Prometheus
 //				cv::circle(DebugPictureForLightBar, vertices[0], 2, cv::Scalar(255,0,0),4);
 //				cv::circle(DebugPictureForLightBar, vertices[1], 2, cv::Scalar(0,255,0),4);
 //				cv::circle(DebugPictureForLightBar, vertices[2], 2, cv::Scalar(0,0,255),4);
-				if (element->GeometryParameters.MatchingShape == GeometryFeature::Shape::Rectangle)
-				{
-					cv::circle(DebugPictureForLightBar, element->GeometryParameters.Center, 3, cv::Scalar(0, 0, 255), 3);
-				}
-				else
-				{
-					cv::circle(DebugPictureForLightBar, element->GeometryParameters.Center,3, cv::Scalar(255, 0, 0), 3);
-				}
-				lock.unlock();
-			#endif
-		});
+			if (element->GeometryParameters.MatchingShape == GeometryFeature::Shape::Rectangle)
+			{
+				cv::circle(DebugPictureForLightBar, element->GeometryParameters.Center, 3, cv::Scalar(0, 0, 255), 3);
+			}
+			else
+			{
+				cv::circle(DebugPictureForLightBar, element->GeometryParameters.Center,3, cv::Scalar(255, 0, 0), 3);
+			}
+			lock.unlock();
+		#endif
+
+		return std::move(element->GeometryParameters);
+	}
+
+	/// 廉价级联检验
+	int LightBarSearchingService::PassCheapStages(const Modules::RunLengthLabeler::Blob &blob) const
+	{
+		const auto& cascade = Settings.Cascade;
+
+		//==============================
+		// 第一级：面积
+		//==============================
+
+		if (cascade.EnableArea && (blob.Area < cascade.MinimumArea || blob.Area > cascade.MaximumArea))
+		{
+			return 0;
+		}
+
+		//==============================
+		// 第二级：外接矩形长宽比
+		//==============================
+
+		if (cascade.EnableAspect &&
+			blob.BoundingBox.height < cascade.MinimumAspect * blob.BoundingBox.width)
+		{
+			return 1;
+		}
+
+		if (!cascade.EnableOrientation && !cascade.EnableFillingRate) return 4;
+
+		auto feature = Modules::GeometryFeatureModule::GetMomentGeometryFeature(blob.Moments);
+
+		//==============================
+		// 第三级：朝向
+		//==============================
+
+		if (cascade.EnableOrientation &&
+			(feature.Angle < Settings.MinimumAngle - cascade.AngleTolerance ||
+			 feature.Angle > Settings.MaximumAngle + cascade.AngleTolerance))
+		{
+			return 2;
+		}
+
+		//==============================
+		// 第四级：填充率
+		//==============================
+
+		if (cascade.EnableFillingRate && feature.FillingRate < cascade.FillingRateThreshold)
+		{
+			return 3;
+		}
 
-		return SearchingResult{.Rectangles = rectangle_result, .Ellipses= ellipse_result};
+		return 4;
 	}
 
 	/// 检验几何学特征
-	auto LightBarSearchingService::CheckGeometryConditions(const std::vector<cv::Point> &contour)
+	auto LightBarSearchingService::CheckGeometryConditions(const cv::Mat &contour)
 		const -> std::optional<PossibleElement>
 	{
 		/// 矩形面积
@@ -145,7 +296,7 @@ namespace RoboPioneers::Prometheus
 		// 尝试匹配椭圆（旋转矩形面积填充率）
 		//==============================
 
-		if (contour.size() >= 5)
+		if (contour.total() >= 5)
 		{
 			// 内接椭圆面积比，S=pi*a*b，a=0.5*width，b=0.5*height
 			constexpr double InscribedEllipseAreaRatio = 3.1415926535f / 4.0f;
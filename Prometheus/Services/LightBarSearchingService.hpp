@@ -2,9 +2,12 @@
 
 #include <SparrowEngine/SparrowEngine.hpp>
 #include <opencv4/opencv2/opencv.hpp>
-#include <list>
+#include <functional>
 
 #include "../Modules/GeometryFeatureModule.hpp"
+#include "../Modules/LightBarTable.hpp"
+#include "../Modules/PackedBinaryMask.hpp"
+#include "../Modules/RunLengthLabeler.hpp"
 
 namespace RoboPioneers::Prometheus
 {
@@ -24,15 +27,47 @@ namespace RoboPioneers::Prometheus
 		/// 输入
 		struct {
 			/// 颜色蒙版
-			cv::cuda::GpuMat* BinaryPicture{nullptr};
+			Sparrow::PictureType* BinaryPicture{nullptr};
+			/**
+			 * @brief 位压缩的颜色蒙版
+			 * @details
+			 *  ~ 给定且不为空时优先使用，不再下载颜色蒙版。
+			 */
+			const Modules::PackedBinaryMask* PackedBinaryPicture{nullptr};
 		}Input;
 
+		/**
+		 * @brief 筛选级联统计
+		 * @details
+		 *  ~ 记录每一级筛选后剩余的候选数量，各级依次为面积、外接矩形长宽比、朝向、填充率与精确拟合。
+		 *  ~ 未启用的级别视为全部通过。
+		 */
+		struct CascadeStatistics
+		{
+			/// 参与筛选的候选数
+			std::size_t Candidates {0};
+			/// 通过面积检验的数量
+			std::size_t AreaPassed {0};
+			/// 通过外接矩形长宽比检验的数量
+			std::size_t AspectPassed {0};
+			/// 通过朝向检验的数量
+			std::size_t OrientationPassed {0};
+			/// 通过填充率检验的数量
+			std::size_t FillingRatePassed {0};
+			/// 通过精确拟合的数量
+			std::size_t FittingPassed {0};
+		};
+
 		/// 输出
 		struct {
-			/// 可能的矩形
-			std::list<GeometryFeature> PossibleRectangles;
-			/// 可能的椭圆
-			std::list<GeometryFeature> PossibleEllipses;
+			/**
+			 * @brief 可能的灯条
+			 * @details
+			 *  ~ 矩形与椭圆匹配的灯条存储在同一张表中，以匹配形状区分。
+			 */
+			Modules::LightBarTable LightBars;
+			/// 本帧的筛选级联统计
+			CascadeStatistics Statistics;
 		}Output;
 
 		struct {
@@ -40,8 +75,70 @@ namespace RoboPioneers::Prometheus
 			double EllipseFillingRateThreshold {0.6};
 			/// 矩形填充率阈值
 			double RectangleFillingRateThreshold {0.6};
+
+			/// 灯条转角下限
+			double MinimumAngle {60.0};
+			/// 灯条转角上限
+			double MaximumAngle {120.0};
+
+			/**
+			 * @brief 筛选级联设定
+			 * @details
+			 *  ~ 连通域依次经过面积、外接矩形长宽比、图像矩朝向、图像矩填充率的检验，
+			 *    只有全部通过的连通域才进行椭圆与矩形拟合。
+			 *  ~ 前四级只使用连通域标记时已经得到的统计量，每级只需常数次运算。
+			 */
+			struct {
+				/// 是否启用面积检验
+				bool EnableArea {true};
+				/// 最小像素数
+				int MinimumArea {5};
+				/// 最大像素数
+				int MaximumArea {100000};
+
+				/// 是否启用外接矩形长宽比检验
+				bool EnableAspect {true};
+				/// 外接矩形高与宽之比的下限，灯条接近竖直，过扁的连通域不可能是灯条
+				double MinimumAspect {0.8};
+
+				/// 是否启用朝向检验
+				bool EnableOrientation {true};
+				/// 朝向容差，矩估计的转角在灯条转角范围外扩该角度内即可通过
+				double AngleTolerance {15.0};
+
+				/// 是否启用填充率检验
+				bool EnableFillingRate {true};
+				/// 填充率阈值，像素数与等效矩形面积之比
+				double FillingRateThreshold {0.5};
+			}Cascade;
+
+			/**
+			 * @brief 并行设定
+			 * @details
+			 *  ~ 拟合单个轮廓约需数微秒，与TBB任务调度的开销相当，候选较少时串行检验更快。
+			 */
+			struct {
+				/// 串行检验的候选数上限，候选数小于该值时不启用并行；应取目标平台上串行与并行耗时相当时的候选数
+				std::size_t SerialThreshold {32};
+				/// 并行检验时每个任务的最小候选数
+				std::size_t MinimumGrainSize {4};
+			}Parallel;
 		}Settings;
 
+		/**
+		 * @brief 资产结构体
+		 * @details
+		 *  ~ 该结构体存储可以复用的、一般贯穿服务生命周期的对象。
+		 */
+		struct {
+			/// 内存中的二值图，仅在没有位压缩蒙版时使用
+			cv::Mat BinaryPicture;
+			/// 连通域标记器
+			Modules::RunLengthLabeler Labeler;
+			/// 连通域标记结果，在帧间复用以避免重复分配
+			Modules::RunLengthLabeler::Result Components;
+		}Properties;
+
 	protected:
 		/// 更新事件
 		void OnUpdate(Sparrow::Frame &frame) override;
@@ -67,21 +164,53 @@ namespace RoboPioneers::Prometheus
 			double Confidence {0.0f};
 		};
 
-		/// 搜索结果
-		struct SearchingResult {
-			/// 矩形匹配形状的几何特征列表
-			std::list<GeometryFeature> Rectangles;
-			/// 椭圆匹配形状的几何特征列表
-			std::list<GeometryFeature> Ellipses;
-		};
-
 		/**
 		 * @brief 搜索可能的图形元素
 		 * @param binary_picture 目标二值图
-		 * @return 搜索结果，第一个成员为匹配矩形的列表，第二个成员为匹配椭圆的列表
+		 * @param light_bars 输出的灯条表，将被清空后填充
+		 * @return 筛选级联统计
+		 */
+		auto SearchPossibleElements(const cv::Mat& binary_picture, Modules::LightBarTable& light_bars) const
+			-> CascadeStatistics;
+
+		/**
+		 * @brief 搜索可能的图形元素
+		 * @param components 连通域标记结果，以各连通域的紧凑边界作为轮廓
+		 * @param light_bars 输出的灯条表，将被清空后填充
+		 * @return 筛选级联统计
+		 */
+		auto SearchPossibleElements(const Modules::RunLengthLabeler::Result& components,
+							  Modules::LightBarTable& light_bars) const -> CascadeStatistics;
+
+		/**
+		 * @brief 在轮廓集合中搜索可能的图形元素
+		 * @param count 轮廓数量
+		 * @param get_contour 获取指定下标的轮廓，将在工作线程中被调用，返回CV_32SC2格式的点集，可以是不复制数据的视图
+		 * @param light_bars 输出的灯条表，将被清空后填充
+		 * @return 筛选级联统计
+		 * @details
+		 *  ~ 灯条在表中按轮廓下标排列，与是否并行及线程调度无关。
+		 */
+		auto SearchPossibleElements(std::size_t count,
+			const std::function<cv::Mat(std::size_t)>& get_contour,
+			Modules::LightBarTable& light_bars) const -> CascadeStatistics;
+
+		/**
+		 * @brief 以廉价的级联检验连通域
+		 * @param blob 连通域
+		 * @return 依次通过的级数，0~4，为4时需要进一步拟合
+		 */
+		[[nodiscard]] int PassCheapStages(const Modules::RunLengthLabeler::Blob& blob) const;
+
+		/**
+		 * @brief 检验单个灯条
+		 * @param contour 目标轮廓，CV_32SC2格式的点集
+		 * @return 通过几何学特征与转角检验时返回几何特征，否则返回空
+		 * @details
+		 *  ~ 可以在工作线程中并发调用。
 		 */
-		[[nodiscard]] auto SearchPossibleElements(const cv::Mat& binary_picture) const
-			-> SearchingResult;
+		[[nodiscard]] auto CheckLightBar(const cv::Mat& contour) const
+			-> std::optional<GeometryFeature>;
 
 		/**
 		 * @brief 检验几何学特征
@@ -89,7 +218,7 @@ namespace RoboPioneers::Prometheus
 		 * @retval true 当目标几何参数满足条件
 		 * @retval false 当目标几何参数不满足条件
 		 */
-		[[nodiscard]] auto CheckGeometryConditions(const std::vector<cv::Point> &contour) const
+		[[nodiscard]] auto CheckGeometryConditions(const cv::Mat &contour) const
 			-> std::optional<PossibleElement>;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "PictureCuttingService.hpp"
 
+#include <algorithm>
 #include <utility>
 #include "../Modules/CUDAUtility.hpp"
 #include "../Modules/ImageDebugUtility.hpp"
@@ -9,12 +10,26 @@ namespace RoboPioneers::Prometheus
 	/// 更新方法
 	void PictureCuttingService::OnUpdate(Sparrow::Frame &frame)
 	{
-		if (*Input.NeedToCut && !Settings.ForceNotCut)
+		if (*Input.NeedToCut && !Settings.ForceNotCut && Input.CuttingAreas->size() == 1)
 		{
-			frame.GpuPicture = CutPictureByInterestedRegion(&frame.GpuPicture,*Input.CuttingArea);
-//			frame.GpuPicture = CutPictureByMask(&frame.GpuPicture, *Input.CuttingArea);
-			frame.PointOffset = cv::Point{(Input.CuttingArea->x, Input.CuttingArea->y)};
-//			frame.PointOffset = cv::Point{0,0};
+			const auto* cutting_area = &Input.CuttingAreas->front();
+			frame.GpuPicture = CutPictureByInterestedRegion(&frame.GpuPicture, *cutting_area);
+			if (Settings.ContiguousPicture)
+			{
+				frame.GpuPicture = CopyToContiguousBuffer(frame.GpuPicture, Properties.ContiguousBuffer);
+			}
+			frame.PointOffset = cutting_area->tl();
+		}
+		else if (*Input.NeedToCut && !Settings.ForceNotCut && Input.CuttingAreas->size() > 1)
+		{
+			cv::Rect bounding_area = Input.CuttingAreas->front();
+			for (const auto& area : *Input.CuttingAreas)
+			{
+				bounding_area |= area;
+			}
+			frame.GpuPicture = CutPictureByMask(&frame.GpuPicture, *Input.CuttingAreas, bounding_area,
+									   Properties.MaskBuffer);
+			frame.PointOffset = bounding_area.tl();
 		}
 		else
 		{
@@ -22,8 +37,12 @@ namespace RoboPioneers::Prometheus
 		}
 
 		#ifdef DEBUG
+		#ifdef NO_CUDA
+		frame.GpuPicture.copyTo(frame.CutPicture);
+		#else
 		frame.GpuPicture.download(frame.CutPicture);
 		Modules::CUDAUtility::SynchronizeDevice();
+		#endif
 //		if (*Input.NeedToCut)
 //		{
 //			frame.CutPicture = frame.CutPicture(*Input.CuttingArea);
@@ -33,21 +52,47 @@ namespace RoboPioneers::Prometheus
 	}
 
 	/// 使用兴趣区方式裁剪图像
-	cv::cuda::GpuMat PictureCuttingService::CutPictureByInterestedRegion(cv::cuda::GpuMat const *picture, cv::Rect area)
+	Sparrow::PictureType PictureCuttingService::CutPictureByInterestedRegion(Sparrow::PictureType const *picture, cv::Rect area)
 	{
-//		cv::cuda::GpuMat target(area.height, area.width, picture->type());
-//		(*picture)(std::move(area)).copyTo(target);
-//		Modules::CUDAUtility::SynchronizeDevice();
-//		return target;
-
-		return (*picture)(area).clone();
+		return (*picture)(area);
 	}
+
 	/// 使用蒙版的方式裁剪图像
-	cv::cuda::GpuMat PictureCuttingService::CutPictureByMask(const cv::cuda::GpuMat *picture, cv::Rect area)
+	Sparrow::PictureType PictureCuttingService::CutPictureByMask(const Sparrow::PictureType *picture,
+														  const std::vector<cv::Rect>& areas, cv::Rect bounding_area,
+														  Sparrow::PictureType& buffer)
 	{
-		cv::cuda::GpuMat target(picture->rows, picture->cols, picture->type(),cv::Scalar(0,0,0));
-		(*picture)(area).copyTo(target(area));
-		Modules::CUDAUtility::SynchronizeDevice();
+		if (buffer.type() != picture->type() ||
+			buffer.cols < bounding_area.width || buffer.rows < bounding_area.height)
+		{
+			buffer.create(std::max(buffer.rows, bounding_area.height), std::max(buffer.cols, bounding_area.width),
+				 picture->type());
+		}
+		auto target = buffer(cv::Rect(0, 0, bounding_area.width, bounding_area.height));
+
+		// 清零与复制在默认流上进行而不同步设备：颜色感知服务的流与默认流同步，其运算排在这些操作之后。
+		// 若下游改为在不与默认流同步的流上读取，需要在此等待默认流。
+		target.setTo(cv::Scalar::all(0));
+		for (const auto& area : areas)
+		{
+			(*picture)(area).copyTo(target(area - bounding_area.tl()));
+		}
+		return target;
+	}
+
+	/// 复制为连续存储
+	Sparrow::PictureType PictureCuttingService::CopyToContiguousBuffer(const Sparrow::PictureType &picture,
+																Sparrow::PictureType &buffer)
+	{
+		const auto elements = picture.cols * picture.rows;
+		if (buffer.type() != picture.type() || buffer.cols < elements)
+		{
+			buffer.create(1, elements, picture.type());
+		}
+
+		// 单行缓冲区的列区间是连续的，重塑后行距即为行宽；结果持有缓冲区的引用计数，缓冲区重新分配后仍然有效
+		auto target = buffer.colRange(0, elements).reshape(0, picture.rows);
+		picture.copyTo(target);
 		return target;
 	}
 }
@@ -2,7 +2,7 @@
 
 #include <SparrowEngine/SparrowEngine.hpp>
 #include <opencv4/opencv2/opencv.hpp>
-#include <list>
+#include <vector>
 
 namespace RoboPioneers::Prometheus
 {
@@ -11,6 +11,10 @@ namespace RoboPioneers::Prometheus
 	 * @author Vincent
 	 * @details
 	 *  ~ 该服务用于按照要求裁剪图像。
+	 *  ~ 单个区域的裁剪结果为原图的视图，不复制数据，区域左上角记录在帧的坐标偏移量中；
+	 *    下游服务均支持带行距的图像，只有要求连续存储时才复制到缓冲区中。
+	 *  ~ 视图依赖于采集器的保证：取出的画面在下一次取图之前不会被采集线程改写，见HSVDualMatAcquisitor。
+	 *  ~ 多个区域的裁剪结果存放在缓冲区中，缓冲区按出现过的最大尺寸分配，在帧间复用。
 	 */
 	class PictureCuttingService : public Sparrow::Service
 	{
@@ -21,8 +25,9 @@ namespace RoboPioneers::Prometheus
 			 * @details
 			 *  ~ 若只有单项，采取兴趣区裁剪方式
 			 *  ~ 若有多项，采取蒙版裁剪方式
+			 *  ~ 若为空，不裁剪
 			 */
-			cv::Rect* CuttingArea {nullptr};
+			const std::vector<cv::Rect>* CuttingAreas {nullptr};
 			/// 需要裁剪
 			bool* NeedToCut {nullptr};
 		}Input;
@@ -30,8 +35,26 @@ namespace RoboPioneers::Prometheus
 		struct
 		{
 			bool ForceNotCut {false};
+			/**
+			 * @brief 是否要求裁剪结果连续存储
+			 * @details
+			 *  ~ 开启时单个区域的裁剪结果被复制到连续存储的缓冲区中，供要求连续内存的下游使用。
+			 */
+			bool ContiguousPicture {false};
 		}Settings;
 
+		/**
+		 * @brief 资产结构体
+		 * @details
+		 *  ~ 裁剪结果可能指向这些缓冲区，在下一次裁剪前有效。
+		 */
+		struct {
+			/// 连续存储缓冲区，为与画面类型相同的单行缓冲区，容量不足时重新分配
+			Sparrow::PictureType ContiguousBuffer;
+			/// 蒙版裁剪缓冲区，裁剪结果为其左上角的视图
+			Sparrow::PictureType MaskBuffer;
+		}Properties;
+
 	protected:
 		/// 更新方法
 		void OnUpdate(Sparrow::Frame &frame) override;
@@ -40,10 +63,25 @@ namespace RoboPioneers::Prometheus
 		/**
 		 * @brief 裁剪兴趣区域
 		 * @param area 区域
-		 * @return 裁剪结果
+		 * @return 原图中该区域的视图，与原图共用显存，有效期与原图相同
+		 */
+		static Sparrow::PictureType CutPictureByInterestedRegion(Sparrow::PictureType const * picture, cv::Rect area);
+		/**
+		 * @brief 以蒙版方式裁剪多个区域
+		 * @param picture 图像
+		 * @param areas 区域列表
+		 * @param bounding_area 所有区域的外接矩形
+		 * @param buffer 缓冲区，尺寸不足时将被重新分配
+		 * @return 外接矩形大小的图像，为缓冲区的视图，区域以外的像素为0
+		 */
+		static Sparrow::PictureType CutPictureByMask(Sparrow::PictureType const * picture, const std::vector<cv::Rect>& areas,
+										   cv::Rect bounding_area, Sparrow::PictureType& buffer);
+		/**
+		 * @brief 将图像复制为连续存储
+		 * @param picture 图像
+		 * @param buffer 单行缓冲区，类型不符或容量不足时将被重新分配
+		 * @return 连续存储的图像，为缓冲区的视图，持有其引用计数
 		 */
-		static cv::cuda::GpuMat CutPictureByInterestedRegion(cv::cuda::GpuMat const * picture, cv::Rect area);
-		/// 使用兴趣区的方式获取尺寸
-		static cv::cuda::GpuMat CutPictureByMask(cv::cuda::GpuMat const * picture, cv::Rect area);
+		static Sparrow::PictureType CopyToContiguousBuffer(const Sparrow::PictureType& picture, Sparrow::PictureType& buffer);
 	};
 }
\ No newline at end of file
@@ -8,12 +8,13 @@ namespace RoboPioneers::Prometheus
 	void TargetEncodeService::OnUpdate(Sparrow::Frame &frame)
 	{
 		Output.Data.clear();
-		Output.Data.resize(11);
+		Output.Data.resize(15);
 
 		*reinterpret_cast<char*>(&Output.Data[0]) = *Input.Command;
 		*reinterpret_cast<int*>(&Output.Data[1]) = *Input.X;
 		*reinterpret_cast<int*>(&Output.Data[5]) = *Input.Y;
 		*reinterpret_cast<char*>(&Output.Data[9]) = *Input.Number;
-		Output.Data[10] = Modules::CRCModule::GetCRC8CheckSum(Output.Data.data(), 10);
+		*reinterpret_cast<std::uint32_t*>(&Output.Data[10]) = *Input.AimTime;
+		Output.Data[14] = Modules::CRCModule::GetCRC8CheckSum(Output.Data.data(), 14);
 	}
 }
\ No newline at end of file
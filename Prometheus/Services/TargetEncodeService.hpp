@@ -2,6 +2,7 @@
 
 #include <SparrowEngine/SparrowEngine.hpp>
 #include <vector>
+#include <cstdint>
 
 namespace RoboPioneers::Prometheus
 {
@@ -23,6 +24,8 @@ namespace RoboPioneers::Prometheus
 			int const *X;
 			int const *Y;
 			char const *Number;
+			/// 坐标对应的时刻，单位为下位机时钟计数
+			std::uint32_t const *AimTime;
 		}Input;
 
 		//==============================
@@ -34,8 +37,10 @@ namespace RoboPioneers::Prometheus
 		 	 * @brief 编码数据
 		 	 * @details
 		 	 *  ~ 将中心点横纵坐标编码为数据包。
-		 	 *  ~ 包长10个字节。
-		 	 *  ~ 0~3为float横坐标，4~7为float纵坐标，8为bool是否找到，9为CRC8位校验码。
+		 	 *  ~ 包长15个字节。
+		 	 *  ~ 0为指令，1~4为int横坐标，5~8为int纵坐标，9为识别的数字，
+		 	 *    10~13为坐标对应的时刻（下位机时钟计数），14为CRC8位校验码。
+		 	 *  ~ 坐标已经预测到该时刻，一般为预计的执行时刻；下位机可以用该时刻与当前时钟之差补偿剩余的延迟。
 		 	 */
 			std::vector<unsigned char> Data;
 		}Output;
@@ -1,9 +1,12 @@
 #include "HSVDualMatAcquisitor.hpp"
 
 #include <DxImageProc.h>
-#include <opencv4/opencv2/cudaimgproc.hpp>
+#include <thread>
+#include <utility>
 
-extern void CUDADeviceSynchronize();
+#ifndef NO_CUDA
+#include <opencv4/opencv2/cudaimgproc.hpp>
+#endif
 
 namespace RoboPioneers::Sparrow
 {
@@ -11,6 +14,9 @@ namespace RoboPioneers::Sparrow
 	void HSVDualMatAcquisitor::ReceivePictureIncomeEvent(
 			Modules::CameraDriver::Acquisitors::AbstractAcquisitor::RawPicture data)
 	{
+		// 尽早记录采集时间，后续的转换耗时不应计入曝光时刻
+		auto capture_time = std::chrono::steady_clock::now();
+
 		// 更新设备工作状态
 		if (!IsDeviceWorking.load())
 		{
@@ -28,12 +34,71 @@ namespace RoboPioneers::Sparrow
 		          static_cast<VxUint32>(data.Width), static_cast<VxUint32>(data.Height),
 		          RAW2RGB_NEIGHBOUR, BAYERBG, false);
 
+		#ifdef NO_CUDA
+		// 在锁外转换，转换期间不阻塞取图
+		cv::Mat hsv_picture;
+		cv::cvtColor(picture, hsv_picture, cv::COLOR_BGR2HSV);
+
+		std::unique_lock lock(PictureMutex);
+
+		HSVPicture = hsv_picture;
+		Picture = picture;
+		CaptureTime = capture_time;
+		#else
+		// 写入中的缓冲区只由采集线程访问，在锁外上传与转换，转换期间不阻塞取图
+		WritingPicture.upload(picture, ConversionStream);
+		cv::cuda::cvtColor(WritingPicture, WritingPicture, cv::COLOR_BGR2HSV, 0, ConversionStream);
+		ConversionStream.waitForCompletion();
+
 		std::unique_lock lock(PictureMutex);
 
-		GpuPicture.upload(picture);
+		std::swap(WritingPicture, ReadyPicture);
+		ReadyPictureFresh = true;
 		Picture = picture;
-		cv::cuda::cvtColor(GpuPicture, GpuPicture, cv::COLOR_BGR2HSV);
+		CaptureTime = capture_time;
+		#endif
+	}
+
+	/// 获取图片及其采集时间
+	std::tuple<cv::Mat, PictureType, std::chrono::steady_clock::time_point>
+	        HSVDualMatAcquisitor::GetTimedDualPicture(bool wait_for_latest)
+	{
+		if (!IsStarted())
+		{
+			throw std::logic_error("HSVDualMatAcquisitor::GetTimedDualPicture Collection Has Not Been Started.");
+		}
+
+		if (!IsWorking())
+		{
+			throw std::runtime_error("HSVDualMatAcquisitor::GetTimedDualPicture Device Is Offline.");
+		}
+
+		// 如果要求等待，则会不断地核验图片是否为最新
+		while (wait_for_latest && !IsPictureLatest.load())
+		{
+			std::this_thread::yield();
+		}
 
-		CUDADeviceSynchronize();
+		// 取出新图片时需要交换缓冲区，使用独占锁
+		std::unique_lock lock(PictureMutex);
+		// 若图像为空，说明这是第一次获取图像，需要等待第一张图像到达
+		while (Picture.empty())
+		{
+			lock.unlock();
+			std::this_thread::yield();
+			lock.lock();
+		}
+		IsPictureLatest = false;
+		#ifdef NO_CUDA
+		return {Picture, HSVPicture, CaptureTime};
+		#else
+		// 此前取出的缓冲区成为就绪缓冲区，采集线程在下一次交换之后才会写入它
+		if (ReadyPictureFresh)
+		{
+			std::swap(ReadyPicture, GpuPicture);
+			ReadyPictureFresh = false;
+		}
+		return {Picture, GpuPicture, CaptureTime};
+		#endif
 	}
 }
\ No newline at end of file
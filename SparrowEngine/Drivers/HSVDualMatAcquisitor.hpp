@@ -2,6 +2,11 @@
 
 #include <CameraDriver/CameraDriver.hpp>
 
+#include <chrono>
+#include <tuple>
+
+#include "../Framework/Picture.hpp"
+
 namespace RoboPioneers::Sparrow
 {
 	/**
@@ -9,16 +14,61 @@ namespace RoboPioneers::Sparrow
 	 * @author Vincent
 	 * @details
 	 *  ~ 该类其他功能均与普通的采集器一致，只不过其会在采集线程中将图像转化为HSV格式。
+	 *  ~ 定义NO_CUDA宏时，HSV图像在内存中转换，每帧使用新的图像，已经取出的图像不会被后续采集改写。
+	 *  ~ 启用CUDA时显存图像轮换使用三块缓冲区：采集线程写入其中一块，写入完成后与就绪的一块交换；
+	 *    取图时就绪的一块与已取出的一块交换。取出的图像在下一次取图之前不会被采集线程改写，
+	 *    调用者可以直接使用其区域视图而不必复制。
 	 */
+	#ifdef NO_CUDA
+	class HSVDualMatAcquisitor : public Modules::CameraDriver::Acquisitors::MatAcquisitor
+	#else
 	class HSVDualMatAcquisitor : public Modules::CameraDriver::Acquisitors::DualMatAcquisitor
+	#endif
 	{
+	protected:
+		#ifdef NO_CUDA
+		/// 内存中的HSV图片
+		cv::Mat HSVPicture {};
+		#else
+		/// 采集线程正在写入的HSV图片，只在采集线程中访问
+		cv::cuda::GpuMat WritingPicture {};
+		/// 最近一次写入完成的HSV图片
+		cv::cuda::GpuMat ReadyPicture {};
+		/// 最近一次写入完成的图片是否尚未被取出
+		bool ReadyPictureFresh {false};
+		/// 采集线程上传与转换所用的CUDA流，只等待该流而不同步整个设备
+		cv::cuda::Stream ConversionStream {};
+		#endif
+
+		/// 图片采集时间，即相机回调被触发的时间
+		std::chrono::steady_clock::time_point CaptureTime {};
+
 	public:
 		/// 构造函数
+		#ifdef NO_CUDA
+		HSVDualMatAcquisitor(Modules::CameraDriver::CameraDevice* camera) :
+		Modules::CameraDriver::Acquisitors::MatAcquisitor(camera)
+		{}
+		#else
 		HSVDualMatAcquisitor(Modules::CameraDriver::CameraDevice* camera) :
 		Modules::CameraDriver::Acquisitors::DualMatAcquisitor(camera)
 		{}
+		#endif
 
 		/// 接受到原始图片
 		void ReceivePictureIncomeEvent(AbstractAcquisitor::RawPicture data) override;
+
+		/**
+		 * @brief 获取图片及其采集时间
+		 * @param wait_for_latest 是否阻塞当前线程直到采集到新的图片
+		 * @return 元组，依次为内存中的图片、处理所用的HSV图片和图片的采集时间
+		 * @throw std::logic_error 当设备未开始采集时调用该方法将抛出该异常
+		 * @throw std::runtime_error 当设备开始采集但却异常离线时调用方法将抛出该异常
+		 * @details
+		 *  ~ 三者在同一把锁内获取，保证采集时间与图片对应。
+		 *  ~ 返回的HSV图片在下一次调用该方法之前有效，不会被采集线程改写。
+		 */
+		std::tuple<cv::Mat, PictureType, std::chrono::steady_clock::time_point>
+		        GetTimedDualPicture(bool wait_for_latest);
 	};
 }
\ No newline at end of file
@@ -3,6 +3,10 @@
 #include <boost/filesystem.hpp>
 
 #include "../Framework/Application.hpp"
+#include "../Framework/BackendRegistry.hpp"
+
+#include <algorithm>
+#include <iostream>
 
 namespace RoboPioneers::Sparrow
 {
@@ -27,7 +31,9 @@ namespace RoboPioneers::Sparrow
 					("setting,s", boost::program_options::value<std::string>(&SettingFilePathSource),
 					        "Use Settings in a Setting File")
 					("debug,d", boost::program_options::value<bool>(),
-					        "Enable the Debug Mode or Not");
+					        "Enable the Debug Mode or Not")
+					("benchmark-backends,b", boost::program_options::value<bool>(&BackendBenchmarkSettings.Enable),
+					        "Benchmark Backends of Services on Startup and Use the Fastest or Not");
 			// 解析参数
 			boost::program_options::store(
 					boost::program_options::parse_command_line(arguments_count, arguments, options),
@@ -54,13 +60,69 @@ namespace RoboPioneers::Sparrow
 		// 安装设备
 		application->Install();
 
+		// 在最初的画面上测量各服务的候选后端
+		bool benchmarking = false;
+		if (BackendBenchmarkSettings.Enable)
+		{
+			StartBackendBenchmarks();
+			benchmarking = true;
+		}
+
 		// 生命周期循环
 		while(application->InnerSettings.LifeFlag)
 		{
 			application->Update();
+
+			if (benchmarking)
+			{
+				benchmarking = ReportBackendBenchmarks();
+			}
 		}
 
 		// 卸载设备
 		application->Uninstall();
 	}
+
+	/// 登记后端注册表
+	void Runtime::RegisterBackends(BackendRegistry *registry)
+	{
+		std::unique_lock lock(BackendRegistriesMutex);
+		BackendRegistries.push_back(registry);
+	}
+
+	/// 注销后端注册表
+	void Runtime::UnregisterBackends(BackendRegistry *registry)
+	{
+		std::unique_lock lock(BackendRegistriesMutex);
+		BackendRegistries.erase(std::remove(BackendRegistries.begin(), BackendRegistries.end(), registry),
+						  BackendRegistries.end());
+	}
+
+	/// 开始后端基准测试
+	void Runtime::StartBackendBenchmarks()
+	{
+		std::unique_lock lock(BackendRegistriesMutex);
+		for (auto* registry : BackendRegistries)
+		{
+			registry->StartBenchmark(BackendBenchmarkSettings.WarmupRounds, BackendBenchmarkSettings.MeasureRounds);
+		}
+	}
+
+	/// 输出后端基准测试结果
+	bool Runtime::ReportBackendBenchmarks()
+	{
+		std::unique_lock lock(BackendRegistriesMutex);
+		bool benchmarking = false;
+		for (auto* registry : BackendRegistries)
+		{
+			// 只在后台更新的服务可能在启动很久之后才完成测量，届时再输出结果；
+			// 先判断是否仍在测量再取结果，避免两者之间完成的测量结果被遗漏
+			benchmarking = registry->IsBenchmarking() || benchmarking;
+			if (auto report = registry->TakeReport())
+			{
+				std::cout << *report << std::endl;
+			}
+		}
+		return benchmarking;
+	}
 }
\ No newline at end of file
@@ -7,12 +7,16 @@
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/program_options.hpp>
 
+#include <mutex>
 #include <stdexcept>
+#include <vector>
 
 namespace RoboPioneers::Sparrow
 {
 	/// 应用类
 	class Application;
+	/// 后端注册表类
+	class BackendRegistry;
 
 	/**
 	 * @brief 运行时类
@@ -50,6 +54,11 @@ namespace RoboPioneers::Sparrow
 		 */
 		boost::program_options::variables_map ProgramOptions;
 
+		/// 后端注册表互斥量
+		std::mutex BackendRegistriesMutex;
+		/// 已登记的后端注册表
+		std::vector<BackendRegistry*> BackendRegistries;
+
 	public:
 		//==============================
 		// 公开设定与状态
@@ -63,6 +72,21 @@ namespace RoboPioneers::Sparrow
 		 */
 		const decltype(SettingFilePathSource)& SettingFilePath {SettingFilePathSource};
 
+		/**
+		 * @brief 后端基准测试设定
+		 * @details
+		 *  ~ 启动应用后，用最初的真实画面测量各服务的候选后端，为每个服务锁定在本机上最快的后端。
+		 *  ~ 可由命令行选项benchmark-backends关闭，此时各服务保持设定中的后端。
+		 */
+		struct {
+			/// 是否启用
+			bool Enable {true};
+			/// 每个候选后端的预热轮次
+			unsigned int WarmupRounds {2};
+			/// 每个候选后端的测量轮次
+			unsigned int MeasureRounds {8};
+		}BackendBenchmarkSettings;
+
 		//==============================
 		// 静态控制方法
 		//==============================
@@ -88,6 +112,38 @@ namespace RoboPioneers::Sparrow
 		 */
 		void Launch(int arguments_count, char** arguments, Application* application);
 
+		//==============================
+		// 后端注册表管理方法
+		//==============================
+
+		/**
+		 * @brief 登记后端注册表
+		 * @param registry 后端注册表指针
+		 * @details
+		 *  ~ 由后端注册表在构造时调用。
+		 */
+		void RegisterBackends(BackendRegistry* registry);
+
+		/**
+		 * @brief 注销后端注册表
+		 * @param registry 后端注册表指针
+		 * @details
+		 *  ~ 由后端注册表在析构时调用。
+		 */
+		void UnregisterBackends(BackendRegistry* registry);
+
+	protected:
+		/// 开始所有后端注册表的基准测试
+		void StartBackendBenchmarks();
+
+		/**
+		 * @brief 输出已完成的后端基准测试结果
+		 * @return 是否仍有后端注册表在进行基准测试
+		 */
+		bool ReportBackendBenchmarks();
+
+	public:
+
 		//==============================
 		// 基本方法
 		//==============================
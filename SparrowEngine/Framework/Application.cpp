@@ -97,10 +97,10 @@ namespace RoboPioneers::Sparrow
 	void Application::Update()
 	{
 		// 获取图像
-		auto [picture, gpu_picture] = InnerDevices.Acquisitor.GetDualPicture(true);
+		auto [picture, gpu_picture, capture_time] = InnerDevices.Acquisitor.GetTimedDualPicture(true);
 
 		// 重设帧
-		CurrentFrame.Reset(std::move(picture), gpu_picture);
+		CurrentFrame.Reset(std::move(picture), gpu_picture, capture_time);
 
 		// 触发用户服务更新前事件
 		OnBeforeUserServices(CurrentFrame);
@@ -0,0 +1,129 @@
+#include "BackendRegistry.hpp"
+
+#include "../Engine/Runtime.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+namespace RoboPioneers::Sparrow
+{
+	/// 构造函数
+	BackendRegistry::BackendRegistry()
+	{
+		Runtime::GetInstance()->RegisterBackends(this);
+	}
+
+	/// 析构函数
+	BackendRegistry::~BackendRegistry()
+	{
+		Runtime::GetInstance()->UnregisterBackends(this);
+	}
+
+	/// 注册候选后端
+	void BackendRegistry::Register(std::string name, std::function<void()> select, std::function<bool()> available)
+	{
+		std::unique_lock lock(StateMutex);
+		Candidates.push_back({std::move(name), std::move(select), std::move(available), {}});
+	}
+
+	/// 开始基准测试
+	void BackendRegistry::StartBenchmark(unsigned int warmup_rounds, unsigned int measure_rounds)
+	{
+		std::unique_lock lock(StateMutex);
+
+		ActiveCandidates.clear();
+		for (std::size_t index = 0; index < Candidates.size(); ++index)
+		{
+			Candidates[index].Samples.clear();
+			if (!Candidates[index].Available || Candidates[index].Available())
+			{
+				ActiveCandidates.push_back(index);
+			}
+		}
+
+		WarmupRounds = warmup_rounds;
+		MeasureRounds = std::max(measure_rounds, 1u);
+		RunIndex = 0;
+		SelectedName.clear();
+		PendingReport.reset();
+
+		Benchmarking = ActiveCandidates.size() >= 2;
+	}
+
+	/// 开始一次测量
+	void BackendRegistry::BeginSample()
+	{
+		std::unique_lock lock(StateMutex);
+		if (!Benchmarking) return;
+
+		CurrentCandidate = ActiveCandidates[RunIndex % ActiveCandidates.size()];
+		Candidates[CurrentCandidate].Select();
+	}
+
+	/// 结束一次测量
+	void BackendRegistry::EndSample(std::chrono::steady_clock::duration elapsed)
+	{
+		std::unique_lock lock(StateMutex);
+		if (!Benchmarking) return;
+
+		// 先轮流预热每个候选后端，再轮流测量，首次使用时的分配与上传不计入测量
+		if (RunIndex / ActiveCandidates.size() >= WarmupRounds)
+		{
+			Candidates[CurrentCandidate].Samples.push_back(
+					std::chrono::duration<double, std::milli>(elapsed).count());
+		}
+		++RunIndex;
+
+		if (RunIndex >= ActiveCandidates.size() * (WarmupRounds + MeasureRounds))
+		{
+			Finish();
+		}
+	}
+
+	/// 取走基准测试结果
+	std::optional<std::string> BackendRegistry::TakeReport()
+	{
+		std::unique_lock lock(StateMutex);
+		return std::exchange(PendingReport, std::nullopt);
+	}
+
+	/// 获取选定的候选后端名称
+	std::string BackendRegistry::GetSelectedName() const
+	{
+		std::unique_lock lock(StateMutex);
+		return SelectedName;
+	}
+
+	/// 选择并锁定最快的候选后端
+	void BackendRegistry::Finish()
+	{
+		std::vector<std::pair<std::size_t, double>> medians;
+		for (auto index : ActiveCandidates)
+		{
+			auto& samples = Candidates[index].Samples;
+			std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+			medians.emplace_back(index, samples[samples.size() / 2]);
+		}
+		std::sort(medians.begin(), medians.end(), [](const auto& left, const auto& right){
+			return left.second < right.second;
+		});
+
+		const auto& selected = Candidates[medians.front().first];
+		selected.Select();
+		SelectedName = selected.Name;
+		Benchmarking = false;
+
+		std::ostringstream report;
+		report << (Name.empty() ? "Service" : Name) << " Backend: " << SelectedName << " (median of "
+			<< MeasureRounds << " runs:";
+		for (const auto& [index, median] : medians)
+		{
+			report << ' ' << Candidates[index].Name << ' ' << std::fixed << std::setprecision(3) << median << "ms";
+		}
+		report << ')';
+		PendingReport = report.str();
+	}
+}
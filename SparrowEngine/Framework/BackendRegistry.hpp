@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace RoboPioneers::Sparrow
+{
+	/**
+	 * @brief 后端注册表
+	 * @author Vincent
+	 * @details
+	 *  ~ 同一处理阶段存在多种实现时，服务将各实现作为候选后端注册于此，
+	 *    每个候选后端由一个名称、一个选择函数与一个可用性判断函数构成，选择函数负责修改服务的设定以切换到该后端。
+	 *  ~ 测量期间与锁定后的输出由参与测量的后端产生，但注册表不比较各后端的输出，
+	 *    服务需要通过可用性判断函数保证参与测量的后端在当前设定下与设定中的后端输出一致。
+	 *  ~ 基准测试开始后，服务每次更新前轮流选择一个候选后端，并记录更新的耗时；
+	 *    每个候选后端都完成预热轮次与测量轮次后，选择耗时中位数最小的后端并锁定，此后不再切换。
+	 *  ~ 测量使用真实画面，各候选后端轮流执行，裁剪区域等随帧变化的因素对各后端的影响近似相同。
+	 *  ~ 每个注册表在构造时登记到运行时，由运行时统一开始基准测试并输出结果。
+	 *  ~ 基准测试的推进只在服务更新所在的线程中进行，结果的读取可以在其他线程中进行。
+	 */
+	class BackendRegistry
+	{
+	public:
+		/**
+		 * @brief 名称
+		 * @details
+		 *  ~ 用于输出基准测试结果，为空时由服务在首次测量时填写为服务的类型名。
+		 */
+		std::string Name;
+
+	private:
+		/// 候选后端
+		struct Candidate
+		{
+			/// 名称
+			std::string Name;
+			/// 选择函数
+			std::function<void()> Select;
+			/// 可用性判断函数，为空时总是可用
+			std::function<bool()> Available;
+			/// 测量轮次的耗时，单位为毫秒
+			std::vector<double> Samples;
+		};
+
+		/// 状态互斥量
+		mutable std::mutex StateMutex;
+
+		/// 已注册的候选后端
+		std::vector<Candidate> Candidates;
+		/// 参与本次基准测试的候选后端下标
+		std::vector<std::size_t> ActiveCandidates;
+
+		/// 是否正在进行基准测试
+		std::atomic_bool Benchmarking {false};
+		/// 预热轮次，不计入测量
+		unsigned int WarmupRounds {0};
+		/// 测量轮次
+		unsigned int MeasureRounds {0};
+		/// 已执行的测量次数，包括预热
+		std::size_t RunIndex {0};
+		/// 本次测量所用的候选后端下标
+		std::size_t CurrentCandidate {0};
+
+		/// 选定的候选后端名称，未完成基准测试时为空
+		std::string SelectedName;
+		/// 尚未被取走的基准测试结果
+		std::optional<std::string> PendingReport;
+
+	public:
+		/// 构造函数，将登记到运行时
+		BackendRegistry();
+		/// 析构函数，将从运行时注销
+		~BackendRegistry();
+
+		BackendRegistry(const BackendRegistry&) = delete;
+		BackendRegistry& operator=(const BackendRegistry&) = delete;
+
+		/**
+		 * @brief 注册候选后端
+		 * @param name 名称
+		 * @param select 选择函数，在服务更新所在的线程中调用
+		 * @param available 可用性判断函数，为空时总是可用
+		 * @details
+		 *  ~ 可用性在开始基准测试时判断，应当排除在当前设定下输出与设定中的后端不一致的实现。
+		 */
+		void Register(std::string name, std::function<void()> select, std::function<bool()> available = {});
+
+		/**
+		 * @brief 开始基准测试
+		 * @param warmup_rounds 每个候选后端的预热轮次
+		 * @param measure_rounds 每个候选后端的测量轮次，至少为1
+		 * @details
+		 *  ~ 可用的候选后端少于两个时不进行基准测试，服务保持原有设定。
+		 */
+		void StartBenchmark(unsigned int warmup_rounds, unsigned int measure_rounds);
+
+		/// 是否正在进行基准测试
+		[[nodiscard]] bool IsBenchmarking() const noexcept
+		{
+			return Benchmarking;
+		}
+
+		/**
+		 * @brief 开始一次测量
+		 * @details
+		 *  ~ 将选择本次测量所用的候选后端，应当在服务更新前调用。
+		 */
+		void BeginSample();
+
+		/**
+		 * @brief 结束一次测量
+		 * @param elapsed 本次服务更新的耗时
+		 * @details
+		 *  ~ 所有轮次完成后将选择并锁定最快的候选后端。
+		 */
+		void EndSample(std::chrono::steady_clock::duration elapsed);
+
+		/**
+		 * @brief 取走基准测试结果
+		 * @return 基准测试完成后的首次调用返回结果描述，其余情况返回空
+		 */
+		std::optional<std::string> TakeReport();
+
+		/**
+		 * @brief 获取选定的候选后端名称
+		 * @return 未完成基准测试时为空
+		 */
+		[[nodiscard]] std::string GetSelectedName() const;
+
+	protected:
+		/// 选择并锁定最快的候选后端，需要在持有状态互斥量时调用
+		void Finish();
+	};
+}
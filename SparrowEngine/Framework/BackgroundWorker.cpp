@@ -0,0 +1,111 @@
+#include "BackgroundWorker.hpp"
+
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace RoboPioneers::Sparrow
+{
+	/// 构造函数
+	BackgroundWorker::BackgroundWorker(int max_concurrency, int nice_increment) :
+		#if TBB_VERSION_MAJOR >= 2021
+		Arena(max_concurrency, 1, tbb::task_arena::priority::low),
+		#else
+		Arena(max_concurrency, 1),
+		#endif
+		NiceIncrement(nice_increment)
+	{}
+
+	/// 析构函数
+	BackgroundWorker::~BackgroundWorker()
+	{
+		Stop();
+	}
+
+	/// 提交任务
+	bool BackgroundWorker::Submit(std::function<void()> job)
+	{
+		std::unique_lock lock(StateMutex);
+		if (Busy || Stopping) return false;
+
+		if (!WorkingThread.joinable())
+		{
+			WorkingThread = std::thread(&BackgroundWorker::Run, this);
+		}
+
+		PendingJob = std::move(job);
+		Busy = true;
+		lock.unlock();
+		StateCondition.notify_all();
+		return true;
+	}
+
+	/// 是否忙碌
+	bool BackgroundWorker::IsBusy() const
+	{
+		std::unique_lock lock(StateMutex);
+		return Busy;
+	}
+
+	/// 等待当前任务
+	void BackgroundWorker::Wait()
+	{
+		std::unique_lock lock(StateMutex);
+		StateCondition.wait(lock, [this]{ return !Busy; });
+	}
+
+	/// 停止
+	void BackgroundWorker::Stop()
+	{
+		{
+			std::unique_lock lock(StateMutex);
+			Stopping = true;
+		}
+		StateCondition.notify_all();
+
+		if (WorkingThread.joinable())
+		{
+			WorkingThread.join();
+		}
+	}
+
+	/// 后台线程的执行函数
+	void BackgroundWorker::Run()
+	{
+		// Linux下nice值以线程为单位生效，只降低后台线程自身的优先级
+		if (NiceIncrement != 0)
+		{
+			const auto thread_id = static_cast<id_t>(syscall(SYS_gettid));
+			setpriority(PRIO_PROCESS, thread_id, getpriority(PRIO_PROCESS, thread_id) + NiceIncrement);
+		}
+
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock lock(StateMutex);
+				StateCondition.wait(lock, [this]{ return Busy || Stopping; });
+				// 停止前先执行完已接受的任务
+				if (!Busy) return;
+				job = std::move(PendingJob);
+			}
+
+			try
+			{
+				Arena.execute(job);
+			}catch(std::exception& error)
+			{
+				std::cerr << "BackgroundWorker::Run Job Failed: " << error.what() << std::endl;
+			}
+
+			{
+				std::unique_lock lock(StateMutex);
+				Busy = false;
+			}
+			StateCondition.notify_all();
+		}
+	}
+}
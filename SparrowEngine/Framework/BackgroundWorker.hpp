@@ -0,0 +1,84 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <tbb/task_arena.h>
+
+namespace RoboPioneers::Sparrow
+{
+	/**
+	 * @brief 后台工作器
+	 * @author Vincent
+	 * @details
+	 *  ~ 在独立的低优先级线程中执行任务，同一时刻最多执行一个任务，忙碌时拒绝新的任务。
+	 *  ~ 任务在独立的TBB任务区域中执行，其中的并行算法不会占用主循环所在任务区域的工作线程。
+	 *  ~ 任务区域的并发数默认为1，此时只有后台线程本身执行任务，
+	 *    后台线程的调度优先级被降低，CPU被主循环占满时后台任务让出CPU，不会增加主循环的延迟。
+	 *  ~ 任务与主循环之间的数据交换需要由调用者保证：提交前准备输入，IsBusy返回false后读取输出。
+	 */
+	class BackgroundWorker
+	{
+	private:
+		/// 任务区域
+		tbb::task_arena Arena;
+		/// 后台线程的优先级增量，即nice值的增量，越大优先级越低
+		int NiceIncrement;
+
+		/// 后台线程，首次提交任务时启动
+		std::thread WorkingThread;
+		/// 状态互斥量
+		mutable std::mutex StateMutex;
+		/// 状态条件变量
+		std::condition_variable StateCondition;
+
+		/// 待执行的任务
+		std::function<void()> PendingJob;
+		/// 是否有任务等待执行或正在执行
+		bool Busy {false};
+		/// 是否正在停止
+		bool Stopping {false};
+
+	public:
+		/**
+		 * @brief 构造函数
+		 * @param max_concurrency 任务区域的最大并发数，包括后台线程本身
+		 * @param nice_increment 后台线程的优先级增量，为0时不改变优先级
+		 */
+		explicit BackgroundWorker(int max_concurrency = 1, int nice_increment = 10);
+
+		/// 析构函数，将等待正在执行的任务结束
+		~BackgroundWorker();
+
+		BackgroundWorker(const BackgroundWorker&) = delete;
+		BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+
+		/**
+		 * @brief 提交任务
+		 * @param job 任务
+		 * @return 是否被接受，正在执行任务或已经停止时返回false
+		 * @details
+		 *  ~ 任务抛出的异常将被捕获并输出到标准错误流，不会终止后台线程。
+		 */
+		bool Submit(std::function<void()> job);
+
+		/**
+		 * @brief 是否忙碌
+		 * @return 有任务等待执行或正在执行时为true
+		 * @details
+		 *  ~ 返回false时，此前提交的任务对内存的修改对调用线程可见。
+		 */
+		[[nodiscard]] bool IsBusy() const;
+
+		/// 阻塞直到当前任务执行完毕
+		void Wait();
+
+		/// 等待当前任务执行完毕并停止后台线程，此后不再接受任务
+		void Stop();
+
+	protected:
+		/// 后台线程的执行函数
+		void Run();
+	};
+}
@@ -5,13 +5,18 @@
 namespace RoboPioneers::Sparrow
 {
 	/// 构造函数
-	Frame::Frame() : CurrentTimeSource(std::chrono::steady_clock::now()), DeltaTimeSource()
+	Frame::Frame() : CurrentTimeSource(std::chrono::steady_clock::now()), DeltaTimeSource(),
+		CaptureTimeSource(CurrentTimeSource)
 	{}
 
 	/// 重设图片
-	void Frame::Reset(cv::Mat&& picture, const cv::cuda::GpuMat& gpu_picture)
+	void Frame::Reset(cv::Mat&& picture, const PictureType& gpu_picture,
+				   std::chrono::steady_clock::time_point capture_time)
 	{
+		Arena.Reset();
+
 		GpuPicture = gpu_picture;
+		PictureSizeSource = gpu_picture.size();
 
 		#ifdef DEBUG
 		OriginalPicture = picture;
@@ -20,5 +25,6 @@ namespace RoboPioneers::Sparrow
 		auto last_frame_time = CurrentTimeSource;
 		CurrentTimeSource = std::chrono::steady_clock::now();
 		DeltaTimeSource = std::chrono::duration_cast<std::chrono::milliseconds>(CurrentTimeSource - last_frame_time);
+		CaptureTimeSource = capture_time;
 	}
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include <unordered_map>
 #include <opencv4/opencv2/opencv.hpp>
 
+#include "FrameArena.hpp"
+#include "Picture.hpp"
+
 namespace RoboPioneers::Sparrow
 {
 	/**
@@ -19,6 +22,10 @@ namespace RoboPioneers::Sparrow
 		std::chrono::time_point<std::chrono::steady_clock> CurrentTimeSource;
 		/// 帧时间间隔
 		std::chrono::milliseconds DeltaTimeSource;
+		/// 图像采集时间
+		std::chrono::time_point<std::chrono::steady_clock> CaptureTimeSource;
+		/// 原始图像尺寸
+		cv::Size PictureSizeSource;
 
 	public:
 		//==============================
@@ -36,13 +43,32 @@ namespace RoboPioneers::Sparrow
 		const decltype(CurrentTimeSource)& CurrentTime {CurrentTimeSource};
 		/// 帧间隔时间，即两帧之间间隔的时间，单位为微秒
 		const decltype(DeltaTimeSource)& DeltaTime {DeltaTimeSource};
+		/**
+		 * @brief 图像采集时间，获取自steady_clock
+		 * @details
+		 *  ~ 为相机回调被触发的时间，比当前帧时间更接近曝光时刻，用于延迟补偿。
+		 */
+		const decltype(CaptureTimeSource)& CaptureTime {CaptureTimeSource};
+		/**
+		 * @brief 原始图像尺寸
+		 * @details
+		 *  ~ 为重设帧时图像的尺寸，裁剪图像不会改变该值。
+		 */
+		const decltype(PictureSizeSource)& PictureSize {PictureSizeSource};
 
-		/// 存储在显存中的图像，HSV格式
-		cv::cuda::GpuMat GpuPicture;
+		/// 处理所用的图像，HSV格式，启用CUDA时存储在显存中，否则存储在内存中
+		PictureType GpuPicture;
 
 		/// 坐标偏移量
 		cv::Point2i PointOffset;
 
+		/**
+		 * @brief 帧内存池
+		 * @details
+		 *  ~ 用于分配只在本帧内使用的临时数据，在重设帧时回收。
+		 */
+		FrameArena Arena;
+
 		#ifdef DEBUG
 		/// 原始图像
 		cv::Mat OriginalPicture;
@@ -56,10 +82,13 @@ namespace RoboPioneers::Sparrow
 		/**
 		 * @brief 重设帧信息
 		 * @param picture 内存图片的右值引用
-		 * @param gpu_picture 显存图片的右值引用
+		 * @param gpu_picture 处理所用的图片
+		 * @param capture_time 图片的采集时间
 		 * @details
 		 *  ~ 将重设图片、帧创建时间，并计算帧间隔时间。
+		 *  ~ 上一帧从帧内存池分配的内存将被回收。
 		 */
-		void Reset(cv::Mat&& picture, const cv::cuda::GpuMat& gpu_picture);
+		void Reset(cv::Mat&& picture, const PictureType& gpu_picture,
+			 std::chrono::steady_clock::time_point capture_time);
 	};
 }
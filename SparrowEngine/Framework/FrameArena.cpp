@@ -0,0 +1,123 @@
+#include "FrameArena.hpp"
+
+#include <stdexcept>
+
+namespace RoboPioneers::Sparrow
+{
+	//==============================
+	// 上游内存资源部分
+	//==============================
+
+	/// 申请内存
+	void* FrameArena::CountingResource::do_allocate(std::size_t bytes, std::size_t alignment)
+	{
+		AllocatedBytes += bytes;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	/// 释放内存
+	void FrameArena::CountingResource::do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment)
+	{
+		std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+	}
+
+	/// 判断资源是否相同
+	bool FrameArena::CountingResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+	{
+		return this == &other;
+	}
+
+	#ifdef DEBUG
+	//==============================
+	// 检查线程的内存资源部分
+	//==============================
+
+	/// 申请内存
+	void* FrameArena::ThreadCheckedResource::do_allocate(std::size_t bytes, std::size_t alignment)
+	{
+		if (std::this_thread::get_id() != Owner)
+		{
+			throw std::logic_error("FrameArena::ThreadCheckedResource Allocation Outside The Owning Thread.");
+		}
+		return Target->allocate(bytes, alignment);
+	}
+
+	/// 释放内存，单调分配资源的释放不进行任何操作，可以在任意线程中进行
+	void FrameArena::ThreadCheckedResource::do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment)
+	{
+		Target->deallocate(pointer, bytes, alignment);
+	}
+
+	/// 判断资源是否相同
+	bool FrameArena::ThreadCheckedResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+	{
+		return this == &other;
+	}
+	#endif
+
+	//==============================
+	// 内存池部分
+	//==============================
+
+	/// 构造函数
+	FrameArena::FrameArena(std::size_t local_capacity) : LocalCapacity(local_capacity)
+	{}
+
+	/// 获取当前线程的内存资源
+	std::pmr::memory_resource* FrameArena::GetResource()
+	{
+		bool exists = true;
+		auto& arena = LocalArenas.local(exists);
+		if (!exists)
+		{
+			arena.Buffer.resize(LocalCapacity);
+			Rebuild(arena);
+			#ifdef DEBUG
+			arena.CheckedResource.Owner = std::this_thread::get_id();
+			#endif
+		}
+		#ifdef DEBUG
+		return &arena.CheckedResource;
+		#else
+		return &*arena.Resource;
+		#endif
+	}
+
+	/// 获取预分配容量
+	std::size_t FrameArena::GetCapacity() const
+	{
+		std::size_t capacity = 0;
+		for (const auto& arena : LocalArenas)
+		{
+			capacity += arena.Buffer.size();
+		}
+		return capacity;
+	}
+
+	/// 重设内存池
+	void FrameArena::Reset()
+	{
+		for (auto& arena : LocalArenas)
+		{
+			// 先销毁单调分配资源，使其将超出部分归还上游
+			arena.Resource.reset();
+
+			if (arena.Upstream.AllocatedBytes > 0)
+			{
+				arena.Buffer.resize(arena.Buffer.size() + arena.Upstream.AllocatedBytes);
+				arena.Upstream.AllocatedBytes = 0;
+			}
+
+			Rebuild(arena);
+		}
+	}
+
+	/// 重建单调分配资源
+	void FrameArena::Rebuild(LocalArena &arena)
+	{
+		arena.Resource.emplace(arena.Buffer.data(), arena.Buffer.size(), &arena.Upstream);
+		#ifdef DEBUG
+		arena.CheckedResource.Target = &*arena.Resource;
+		#endif
+	}
+}
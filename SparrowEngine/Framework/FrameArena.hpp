@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <thread>
+#include <vector>
+#include <tbb/enumerable_thread_specific.h>
+
+namespace RoboPioneers::Sparrow
+{
+	/**
+	 * @brief 帧内存池
+	 * @author Vincent
+	 * @details
+	 *  ~ 为每一帧内的临时数据提供单调分配的内存，服务通过std::pmr容器从中分配。
+	 *  ~ 每个线程（包括TBB工作线程）拥有独立的子内存池，分配时不需要加锁，线程之间也不会竞争全局分配器。
+	 *  ~ 释放操作不回收内存，所有内存在重设时一次性回收；从内存池分配的对象不能存活到下一次重设之后。
+	 *  ~ 某一帧超出预分配容量时，超出部分向系统申请，并在重设时并入预分配容量，
+	 *    因此经过最初几帧后，每帧不再向系统申请内存。
+	 *  ~ 子内存池只能在获取它的线程中分配，即使加锁也不能由其他线程分配；并行算法应当在各线程中分别获取内存资源，
+	 *    或者只在调用线程的串行合并阶段使用。定义DEBUG宏时违反该约定的分配将抛出异常。
+	 */
+	class FrameArena
+	{
+	private:
+		/**
+		 * @brief 计数的上游内存资源
+		 * @details
+		 *  ~ 转发至new_delete_resource，并记录超出预分配容量时申请的字节数。
+		 */
+		class CountingResource : public std::pmr::memory_resource
+		{
+		public:
+			/// 自上次清零以来申请的字节数
+			std::size_t AllocatedBytes {0};
+
+		protected:
+			void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+			void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+			[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+		};
+
+		#ifdef DEBUG
+		/**
+		 * @brief 检查线程的内存资源
+		 * @details
+		 *  ~ 转发至子内存池，在获取子内存池的线程以外分配时抛出std::logic_error。
+		 */
+		class ThreadCheckedResource : public std::pmr::memory_resource
+		{
+		public:
+			/// 被转发的内存资源
+			std::pmr::memory_resource* Target {nullptr};
+			/// 获取子内存池的线程
+			std::thread::id Owner {};
+
+		protected:
+			void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+			void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+			[[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+		};
+		#endif
+
+		/// 线程的子内存池
+		struct LocalArena
+		{
+			/// 预分配的缓冲区
+			std::vector<std::byte> Buffer;
+			/// 上游内存资源
+			CountingResource Upstream;
+			/// 单调分配资源，建立在预分配的缓冲区上
+			std::optional<std::pmr::monotonic_buffer_resource> Resource;
+			#ifdef DEBUG
+			/// 检查线程的内存资源，为调用者实际得到的资源
+			ThreadCheckedResource CheckedResource;
+			#endif
+		};
+
+		/// 每个子内存池的初始容量
+		std::size_t LocalCapacity;
+		/// 各线程的子内存池
+		tbb::enumerable_thread_specific<LocalArena> LocalArenas;
+
+	public:
+		/**
+		 * @brief 构造函数
+		 * @param local_capacity 每个线程的子内存池的初始容量，单位为字节
+		 */
+		explicit FrameArena(std::size_t local_capacity = 256 * 1024);
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		/**
+		 * @brief 获取当前线程的内存资源
+		 * @return 当前线程的子内存池，首次调用时创建
+		 * @details
+		 *  ~ 返回的指针在本帧内有效，只能在调用线程中用于分配；分配得到的内存可以在任意线程中读写。
+		 *  ~ 定义DEBUG宏时，在其他线程中用其分配将抛出std::logic_error。
+		 */
+		[[nodiscard]] std::pmr::memory_resource* GetResource();
+
+		/// 获取所有子内存池的预分配容量之和，单位为字节
+		[[nodiscard]] std::size_t GetCapacity() const;
+
+		/**
+		 * @brief 重设内存池
+		 * @details
+		 *  ~ 回收本帧分配的全部内存，并将超出预分配容量的部分并入预分配容量。
+		 *  ~ 不能与分配操作同时进行，应当在帧之间调用。
+		 */
+		void Reset();
+
+	protected:
+		/// 在子内存池的缓冲区上重建单调分配资源
+		static void Rebuild(LocalArena& arena);
+	};
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <opencv4/opencv2/opencv.hpp>
+
+namespace RoboPioneers::Sparrow
+{
+	/**
+	 * @brief 处理所用的图像类型
+	 * @details
+	 *  ~ 启用CUDA时为显存中的图像，定义NO_CUDA宏时为内存中的图像。
+	 *  ~ 两者的常用接口（尺寸、类型、区域视图、copyTo、setTo等）一致，服务在两种构建下共用同一份代码，
+	 *    只有上传、下载与显存专用的算法需要区分。
+	 */
+	#ifdef NO_CUDA
+	using PictureType = cv::Mat;
+	#else
+	using PictureType = cv::cuda::GpuMat;
+	#endif
+}
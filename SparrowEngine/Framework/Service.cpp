@@ -1,13 +1,29 @@
 #include "Service.hpp"
 
+#include <boost/core/demangle.hpp>
+#include <typeinfo>
+
 namespace RoboPioneers::Sparrow
 {
 	/// 更新方法
 	void Service::Update(Frame &frame)
 	{
-		if (Enable)
+		if (!Enable) return;
+
+		if (!Backends.IsBenchmarking())
 		{
 			OnUpdate(frame);
+			return;
+		}
+
+		/// 基准测试期间测量更新耗时
+		if (Backends.Name.empty())
+		{
+			Backends.Name = boost::core::demangle(typeid(*this).name());
 		}
+		Backends.BeginSample();
+		const auto begin_time = std::chrono::steady_clock::now();
+		OnUpdate(frame);
+		Backends.EndSample(std::chrono::steady_clock::now() - begin_time);
 	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Frame.hpp"
+#include "BackendRegistry.hpp"
 
 #include <atomic>
 
@@ -24,6 +25,14 @@ namespace RoboPioneers::Sparrow
 		 */
 		std::atomic_bool Enable {true};
 
+		/**
+		 * @brief 后端注册表
+		 * @details
+		 *  ~ 服务存在多种实现时，在构造时将各实现注册为候选后端，并由可用性判断函数保证参与测量的实现输出一致。
+		 *  ~ 基准测试期间Update方法将轮流选择候选后端并测量OnUpdate的耗时，完成后锁定最快的后端。
+		 */
+		BackendRegistry Backends;
+
 		/**
 		 * @brief 更新方法
 		 * @param frame 帧信息
@@ -2,7 +2,11 @@
 
 #include "Engine/Runtime.hpp"
 #include "Framework/Application.hpp"
+#include "Framework/BackendRegistry.hpp"
+#include "Framework/BackgroundWorker.hpp"
 #include "Framework/Frame.hpp"
+#include "Framework/FrameArena.hpp"
+#include "Framework/Picture.hpp"
 #include "Framework/Service.hpp"
 
 namespace RoboPioneers::Sparrow
@@ -2,6 +2,8 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <cerrno>
+#include <poll.h>
 
 namespace RoboPioneers::Modules::SerialPortDriver
 {
@@ -173,6 +175,35 @@ namespace RoboPioneers::Modules::SerialPortDriver
 		}
 	}
 
+	/// 等待数据到达
+	bool SerialPort::WaitForData(std::chrono::milliseconds timeout)
+	{
+		if (Port.is_open())
+		{
+			pollfd descriptor {};
+			descriptor.fd = Port.native_handle();
+			descriptor.events = POLLIN;
+
+			int result = ::poll(&descriptor, 1, static_cast<int>(timeout.count()));
+			// 被信号打断时视为超时，由调用者决定是否继续等待
+			if (result < 0 && errno == EINTR)
+			{
+				return false;
+			}
+			if (result < 0)
+			{
+				throw boost::system::system_error(
+						boost::system::error_code(errno, boost::system::system_category()),
+						"Port::WaitForData");
+			}
+			return result > 0 && (descriptor.revents & POLLIN);
+		}
+		else
+		{
+			throw std::logic_error("Port::WaitForData Device is not opened.");
+		}
+	}
+
 	/// 设置波特率
 	void SerialPort::SetBaudRate(unsigned int value)
 	{
@@ -3,6 +3,7 @@
 #include <boost/asio.hpp>
 #include <vector>
 #include <string>
+#include <chrono>
 
 namespace RoboPioneers::Modules::SerialPortDriver
 {
@@ -219,5 +220,17 @@ namespace RoboPioneers::Modules::SerialPortDriver
 		 * @return 读取的字符串
 		 */
 		std::string ReadString(std::size_t length);
+
+		/**
+		 * @brief 等待数据到达
+		 * @param timeout 最长等待时间
+		 * @retval true 当输入缓冲区中存在可读取的数据
+		 * @retval false 当等待超时
+		 * @throw std::logic_error 当设备未打开
+		 * @throw boost::system::system_error 当查询失败
+		 * @details
+		 *  ~ 该方法不会读取数据，仅用于让读取线程在没有数据时能够定期醒来，从而可以被安全地停止。
+		 */
+		bool WaitForData(std::chrono::milliseconds timeout);
 	};
 }
\ No newline at end of file